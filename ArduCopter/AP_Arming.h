@@ -59,4 +59,7 @@ private:
     // we can store away success/failure of the checks.
     bool run_pre_arm_checks(bool display_failure);
 
+    // position and attitude controller parameter checks
+    struct param_check_cache controller_checks;
+
 };
@@ -34,4 +34,7 @@ protected:
 
 private:
     void change_arm_state(void);
+
+    // quadplane position and attitude controller parameter checks
+    struct param_check_cache controller_checks;
 };
@@ -0,0 +1,270 @@
+#include "LogIndex.h"
+
+#include <AP_HAL/utility/ComputePool.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern const AP_HAL::HAL& hal;
+
+// MsgHandler can only be destroyed by a subclass
+class LogIndexHandler : public MsgHandler {
+public:
+    LogIndexHandler(const struct log_Format &_f) : MsgHandler(_f) {}
+    ~LogIndexHandler() {}
+};
+
+LogIndex::~LogIndex()
+{
+    for (uint16_t i=0; i<LOGINDEX_MAX_TYPES; i++) {
+        free(index[i].offsets);
+        delete handlers[i];
+    }
+    if (data != nullptr) {
+        munmap((void *)data, size);
+    }
+}
+
+bool LogIndex::add_message(uint8_t type, uint32_t offset)
+{
+    if (index[type].count == index[type].space) {
+        const uint32_t space = index[type].space ? index[type].space * 2 : 1024;
+        uint32_t *offsets = (uint32_t *)realloc(index[type].offsets, space * sizeof(uint32_t));
+        if (offsets == nullptr) {
+            return false;
+        }
+        index[type].offsets = offsets;
+        index[type].space = space;
+    }
+    index[type].offsets[index[type].count++] = offset;
+    return true;
+}
+
+/*
+  map the log and record the offset of every message by type. Unlike
+  AP_LoggerFileReader this does not stop at corruption, it skips
+  forward to the next message header
+ */
+bool LogIndex::open_log(const char *logfile)
+{
+    const int fd = ::open(logfile, O_RDONLY|O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) {
+        ::printf("%s: unsupported log size\n", logfile);
+        close(fd);
+        return false;
+    }
+    size = st.st_size;
+    void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    data = (const uint8_t *)p;
+    madvise(p, size, MADV_SEQUENTIAL);
+
+    size_t ofs = 0;
+    while (ofs + 3 <= size) {
+        if (data[ofs] != HEAD_BYTE1 || data[ofs+1] != HEAD_BYTE2) {
+            ofs++;
+            skipped++;
+            continue;
+        }
+        const uint8_t type = data[ofs+2];
+        uint8_t length;
+        if (type == LOG_FORMAT_MSG) {
+            if (ofs + sizeof(struct log_Format) > size) {
+                break;
+            }
+            struct log_Format f;
+            memcpy(&f, &data[ofs], sizeof(f));
+            if (!valid_format(f)) {
+                ofs++;
+                skipped++;
+                continue;
+            }
+            memcpy(&formats[f.type], &f, sizeof(f));
+            length = sizeof(f);
+        } else {
+            // no format yet means we can't know the message length
+            length = formats[type].length;
+            if (length == 0) {
+                ofs++;
+                skipped++;
+                continue;
+            }
+            if (ofs + length > size) {
+                break;
+            }
+        }
+        if (!add_message(type, ofs)) {
+            ::printf("Out of memory indexing %s\n", logfile);
+            return false;
+        }
+        ofs += length;
+    }
+
+    madvise(p, size, MADV_RANDOM);
+    return true;
+}
+
+/*
+  the FMT header bytes can turn up anywhere in a corrupt log, so only
+  trust a format made of known field types which add up to its length,
+  and which doesn't change the format of a type already seen
+ */
+bool LogIndex::valid_format(const struct log_Format &f) const
+{
+    uint16_t length = 3;
+    uint8_t i;
+    for (i=0; i<sizeof(f.format) && f.format[i] != 0; i++) {
+        const uint8_t s = field_size(f.format[i]);
+        if (s == 0) {
+            return false;
+        }
+        length += s;
+    }
+    if (i == 0 || length != f.length) {
+        return false;
+    }
+    if (formats[f.type].length != 0 &&
+        memcmp(&formats[f.type], &f, sizeof(f)) != 0) {
+        return false;
+    }
+    return true;
+}
+
+bool LogIndex::find_type(const char *name, uint8_t &type) const
+{
+    for (uint16_t i=0; i<LOGINDEX_MAX_TYPES; i++) {
+        if (formats[i].length != 0 && strncmp(formats[i].name, name, sizeof(formats[i].name)) == 0) {
+            type = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogIndex::numeric_field_type(uint8_t field_type)
+{
+    return strchr("bBMcChHfdiIELeqQ", field_type) != nullptr;
+}
+
+uint8_t LogIndex::field_size(uint8_t field_type)
+{
+    switch (field_type) {
+    case 'b':
+    case 'B':
+    case 'M':
+        return 1;
+    case 'c':
+    case 'C':
+    case 'h':
+    case 'H':
+        return 2;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'i':
+    case 'I':
+    case 'L':
+    case 'n':
+        return 4;
+    case 'd':
+    case 'q':
+    case 'Q':
+        return 8;
+    case 'N':
+        return 16;
+    case 'Z':
+        return 64;
+    }
+    return 0;
+}
+
+double LogIndex::field_multiplier(uint8_t field_type)
+{
+    switch (field_type) {
+    case 'c':
+    case 'C':
+    case 'e':
+    case 'E':
+        return 0.01;
+    case 'L':
+        return 1.0e-7;
+    }
+    return 1.0;
+}
+
+void LogIndex::DecodeChunk::decode(uint32_t id)
+{
+    for (uint32_t i=start; i<end; i++) {
+        const uint8_t *msg = log->message(type, i);
+        for (uint8_t c=0; c<num_columns; c++) {
+            handler->field_value_for_type_at_offset(msg, field_types[c], field_offsets[c], columns[c][i]);
+        }
+    }
+}
+
+/*
+  look up the fields once, then split the messages into chunks and
+  decode them on the compute pool, filling all columns for a range of
+  messages at a time so each message is only touched once
+ */
+bool LogIndex::extract(uint8_t type, const char * const labels[], uint8_t num_columns, double * const columns[])
+{
+    if (formats[type].length == 0 || num_columns > LOGREADER_MAX_FIELDS) {
+        return false;
+    }
+    if (handlers[type] == nullptr) {
+        handlers[type] = new LogIndexHandler(formats[type]);
+    }
+    uint8_t field_types[LOGREADER_MAX_FIELDS];
+    uint8_t field_offsets[LOGREADER_MAX_FIELDS];
+    for (uint8_t c=0; c<num_columns; c++) {
+        if (!handlers[type]->field_type_and_offset(labels[c], field_types[c], field_offsets[c]) ||
+            !numeric_field_type(field_types[c])) {
+            ::printf("No numeric field %s in %.4s\n", labels[c], formats[type].name);
+            return false;
+        }
+        if (field_offsets[c] + field_size(field_types[c]) > formats[type].length) {
+            ::printf("Field %s is past the end of %.4s\n", labels[c], formats[type].name);
+            return false;
+        }
+    }
+
+    ComputePool &pool = AP::compute_pool();
+    DecodeChunk chunks[LOGINDEX_MAX_CHUNKS];
+    uint32_t ids[LOGINDEX_MAX_CHUNKS];
+    const uint32_t n = count(type);
+    const uint32_t chunk_size = (n + LOGINDEX_MAX_CHUNKS - 1) / LOGINDEX_MAX_CHUNKS;
+    for (uint8_t i=0; i<LOGINDEX_MAX_CHUNKS; i++) {
+        DecodeChunk &chunk = chunks[i];
+        chunk.log = this;
+        chunk.handler = handlers[type];
+        chunk.type = type;
+        chunk.num_columns = num_columns;
+        chunk.field_types = field_types;
+        chunk.field_offsets = field_offsets;
+        chunk.columns = columns;
+        chunk.start = MIN(i * chunk_size, n);
+        chunk.end = MIN(chunk.start + chunk_size, n);
+        ids[i] = pool.submit(FUNCTOR_BIND(&chunk, &DecodeChunk::decode, void, uint32_t));
+        if (ids[i] == 0) {
+            // pool is full or has no workers
+            chunk.decode(0);
+        }
+    }
+    for (uint8_t i=0; i<LOGINDEX_MAX_CHUNKS; i++) {
+        while (!pool.done(ids[i])) {
+            hal.scheduler->delay_microseconds(100);
+        }
+    }
+    return true;
+}
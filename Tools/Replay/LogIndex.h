@@ -0,0 +1,95 @@
+#pragma once
+
+/*
+  an index of the messages in a dataflash log, built in a single pass
+  over the mapped file. Fields of a message type can then be extracted
+  as columns, with the messages decoded in parallel on the compute
+  pool. This is used to export logs as CSV without replaying them
+ */
+
+#include "MsgHandler.h"
+
+#define LOGINDEX_MAX_TYPES 256
+#define LOGINDEX_MAX_CHUNKS 8
+
+class LogIndex
+{
+public:
+    LogIndex() {}
+    ~LogIndex();
+
+    /* Do not allow copies */
+    LogIndex(const LogIndex &other) = delete;
+    LogIndex &operator=(const LogIndex&) = delete;
+
+    // map a log and index its messages
+    bool open_log(const char *logfile);
+
+    // find a message type by name, returns false if it is not in the log
+    bool find_type(const char *name, uint8_t &type) const;
+
+    const struct log_Format &format(uint8_t type) const { return formats[type]; }
+
+    // number of messages of a type
+    uint32_t count(uint8_t type) const { return index[type].count; }
+
+    // the i'th message of a type
+    const uint8_t *message(uint8_t type, uint32_t i) const {
+        return &data[index[type].offsets[i]];
+    }
+
+    // bytes skipped looking for the next message in a corrupt log
+    uint64_t bytes_skipped(void) const { return skipped; }
+
+    // true if a field is numeric and so can be extracted
+    static bool numeric_field_type(uint8_t field_type);
+
+    // size in bytes of a field type, or zero if the type is unknown
+    static uint8_t field_size(uint8_t field_type);
+
+    // scale from the logged value of a field to its units, e.g. 0.01
+    // for centi-units and 1e-7 for latitude and longitude
+    static double field_multiplier(uint8_t field_type);
+
+    /*
+      extract numeric fields of every message of a type. columns[i]
+      must have room for count(type) values of labels[i]. Returns
+      false if a field is not found or is not numeric
+     */
+    bool extract(uint8_t type, const char * const labels[], uint8_t num_columns, double * const columns[]);
+
+private:
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    uint64_t skipped = 0;
+
+    struct log_Format formats[LOGINDEX_MAX_TYPES] {};
+
+    // offsets of the messages of each type
+    struct {
+        uint32_t *offsets;
+        uint32_t count;
+        uint32_t space;
+    } index[LOGINDEX_MAX_TYPES] {};
+
+    class LogIndexHandler *handlers[LOGINDEX_MAX_TYPES] {};
+
+    // a range of messages to decode on one worker
+    class DecodeChunk {
+    public:
+        const LogIndex *log;
+        MsgHandler *handler;
+        uint8_t type;
+        uint8_t num_columns;
+        const uint8_t *field_types;
+        const uint8_t *field_offsets;
+        double * const *columns;
+        uint32_t start;
+        uint32_t end;
+
+        void decode(uint32_t id);
+    };
+
+    bool add_message(uint8_t type, uint32_t offset);
+    bool valid_format(const struct log_Format &f) const;
+};
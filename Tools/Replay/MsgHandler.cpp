@@ -65,6 +65,17 @@ struct MsgHandler::format_field_info *MsgHandler::find_field_info(const char *la
     return NULL;
 }
 
+bool MsgHandler::field_type_and_offset(const char *label, uint8_t &type, uint8_t &offset)
+{
+    const struct format_field_info *info = find_field_info(label);
+    if (info == NULL) {
+        return false;
+    }
+    type = info->type;
+    offset = info->offset;
+    return true;
+}
+
 MsgHandler::MsgHandler(const struct log_Format &_f) : next_field(0), f(_f)
 {
     init_field_types();
@@ -165,7 +176,7 @@ void MsgHandler::string_for_labels(char *buffer, uint bufferlen)
     bufferlen--;
 
     char *pos = buffer;
-    for (uint8_t k=0; k<LOGREADER_MAX_FIELDS; k++) {
+    for (uint8_t k=0; k<next_field; k++) {
         if (field_info[k].label != NULL) {
             uint8_t remaining = bufferlen - (pos - buffer);
             uint8_t label_length = strlen(field_info[k].label);
@@ -189,7 +200,7 @@ void MsgHandler::string_for_labels(char *buffer, uint bufferlen)
 
 MsgHandler::~MsgHandler()
 {
-    for (uint8_t k=0; k<LOGREADER_MAX_FIELDS; k++) {
+    for (uint8_t k=0; k<next_field; k++) {
         if (field_info[k].label != NULL) {
             free(field_info[k].label);
         }
@@ -40,15 +40,19 @@ public:
     uint16_t require_field_uint16_t(uint8_t *msg, const char *label);
     int16_t require_field_int16_t(uint8_t *msg, const char *label);
 
+    // find the type and offset of a field, for decoding many messages
+    // without looking up the label for each one
+    bool field_type_and_offset(const char *label, uint8_t &type, uint8_t &offset);
+
+    template<typename R>
+    void field_value_for_type_at_offset(const uint8_t *msg, uint8_t type,
+                                        uint8_t offset, R &ret);
+
 private:
 
     void add_field(const char *_label, uint8_t _type, uint8_t _offset,
                    uint8_t length);
 
-    template<typename R>
-    void field_value_for_type_at_offset(uint8_t *msg, uint8_t type,
-                                        uint8_t offset, R &ret);
-
     struct format_field_info { // parsed field information
         char *label;
         uint8_t type;
@@ -108,7 +112,7 @@ bool MsgHandler::field_value(uint8_t *msg, const char *label, R &ret)
 
 
 template<typename R>
-inline void MsgHandler::field_value_for_type_at_offset(uint8_t *msg,
+inline void MsgHandler::field_value_for_type_at_offset(const uint8_t *msg,
                                                       uint8_t type,
                                                       uint8_t offset,
                                                       R &ret)
@@ -116,35 +120,43 @@ inline void MsgHandler::field_value_for_type_at_offset(uint8_t *msg,
     /* we register the types - add_field_type - so can we do without
      * this switch statement somehow? */
     switch (type) {
+    case 'b':
+        ret = (R)(((const int8_t*)&msg[offset])[0]);
+        break;
     case 'B':
-        ret = (R)(((uint8_t*)&msg[offset])[0]);
+    case 'M':
+        ret = (R)(((const uint8_t*)&msg[offset])[0]);
         break;
     case 'c':
     case 'h':
-        ret = (R)(((int16_t*)&msg[offset])[0]);
+        ret = (R)(((const int16_t*)&msg[offset])[0]);
         break;
     case 'H':
-        ret = (R)(((uint16_t*)&msg[offset])[0]);
+        ret = (R)(((const uint16_t*)&msg[offset])[0]);
         break;
     case 'C':
-        ret = (R)(((uint16_t*)&msg[offset])[0]);
+        ret = (R)(((const uint16_t*)&msg[offset])[0]);
         break;
     case 'f':
-        ret = (R)(((float*)&msg[offset])[0]);
+        ret = (R)(((const float*)&msg[offset])[0]);
+        break;
+    case 'd':
+        ret = (R)(((const double*)&msg[offset])[0]);
         break;
     case 'I':
     case 'E':
-        ret = (R)(((uint32_t*)&msg[offset])[0]);
+        ret = (R)(((const uint32_t*)&msg[offset])[0]);
         break;
+    case 'i':
     case 'L':
     case 'e':
-        ret = (R)(((int32_t*)&msg[offset])[0]);
+        ret = (R)(((const int32_t*)&msg[offset])[0]);
         break;
     case 'q':
-        ret = (R)(((int64_t*)&msg[offset])[0]);
+        ret = (R)(((const int64_t*)&msg[offset])[0]);
         break;
     case 'Q':
-        ret = (R)(((uint64_t*)&msg[offset])[0]);
+        ret = (R)(((const uint64_t*)&msg[offset])[0]);
         break;
     default:
         ::printf("Unhandled format type (%c)\n", type);
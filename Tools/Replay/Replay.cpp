@@ -26,6 +26,7 @@
 
 #include "LogReader.h"
 #include "DataFlashFileReader.h"
+#include "LogIndex.h"
 #include "Replay.h"
 
 #include <AP_Camera/AP_Camera.h>
@@ -151,6 +152,8 @@ void Replay::usage(void)
     ::printf("\t--no-params        don't use parameters from the log\n");
     ::printf("\t--no-fpe           do not generate floating point exceptions\n");
     ::printf("\t--packet-counts    print packet counts at end of processing\n");
+    ::printf("\t--csv              list of msg types to write to TYPE.csv without replaying, comma separated\n");
+    ::printf("\t--csv-fields       list of fields to write with --csv, comma separated (default all numeric fields)\n");
 }
 
 
@@ -167,6 +170,8 @@ enum {
     OPT_PARAM_FILE,
     OPT_NO_FPE,
     OPT_PACKET_COUNTS,
+    OPT_CSV,
+    OPT_CSV_FIELDS,
 };
 
 void Replay::flush_logger(void) {
@@ -224,6 +229,8 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"no-params",       false,  0, OPT_NOPARAMS},
         {"no-fpe",          false,  0, OPT_NO_FPE},
         {"packet-counts",   false,  0, OPT_PACKET_COUNTS},
+        {"csv",             true,   0, OPT_CSV},
+        {"csv-fields",      true,   0, OPT_CSV_FIELDS},
         {0, false, 0, 0}
     };
 
@@ -311,6 +318,14 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             packet_counts = true;
             break;
 
+        case OPT_CSV:
+            csv_types = parse_list_from_string(gopt.optarg);
+            break;
+
+        case OPT_CSV_FIELDS:
+            csv_fields = parse_list_from_string(gopt.optarg);
+            break;
+
         case 'h':
         default:
             usage();
@@ -496,6 +511,135 @@ FILE *Replay::xfopen(const char *f, const char *mode)
     return ret;
 }
 
+/*
+  write the fields of each --csv message type to TYPE.csv, using a
+  LogIndex rather than replaying the log
+ */
+void Replay::write_csv_files(void)
+{
+    LogIndex index;
+    if (!index.open_log(filename)) {
+        perror(filename);
+        exit(1);
+    }
+    if (index.bytes_skipped() != 0) {
+        ::printf("Skipped %llu corrupt bytes\n", (unsigned long long)index.bytes_skipped());
+    }
+
+    for (const char **t=csv_types; *t; t++) {
+        uint8_t type;
+        if (!index.find_type(*t, type)) {
+            ::printf("No %s messages in %s\n", *t, filename);
+            exit(1);
+        }
+        const struct log_Format &f = index.format(type);
+
+        // split the labels of the format into fields
+        char labels[sizeof(f.labels)+1] {};
+        memcpy(labels, f.labels, sizeof(f.labels));
+        const char *names[LOGREADER_MAX_FIELDS];
+        uint8_t field_types[LOGREADER_MAX_FIELDS];
+        uint8_t num_fields = 0;
+        char *saveptr = NULL;
+        for (char *p=strtok_r(labels, ",", &saveptr);
+             p && num_fields < LOGREADER_MAX_FIELDS && num_fields < sizeof(f.format);
+             p=strtok_r(NULL, ",", &saveptr)) {
+            names[num_fields] = p;
+            field_types[num_fields] = f.format[num_fields];
+            num_fields++;
+        }
+
+        // the requested fields in order, or all numeric fields
+        const char *columns[LOGREADER_MAX_FIELDS];
+        uint8_t column_types[LOGREADER_MAX_FIELDS];
+        uint8_t num_columns = 0;
+        if (csv_fields == NULL) {
+            for (uint8_t i=0; i<num_fields; i++) {
+                if (LogIndex::numeric_field_type(field_types[i])) {
+                    columns[num_columns] = names[i];
+                    column_types[num_columns] = field_types[i];
+                    num_columns++;
+                }
+            }
+        } else {
+            for (const char **c=csv_fields; *c && num_columns < LOGREADER_MAX_FIELDS; c++) {
+                uint8_t i;
+                for (i=0; i<num_fields; i++) {
+                    if (streq(names[i], *c)) {
+                        break;
+                    }
+                }
+                if (i == num_fields) {
+                    ::printf("No field %s in %s\n", *c, *t);
+                    exit(1);
+                }
+                columns[num_columns] = names[i];
+                column_types[num_columns] = field_types[i];
+                num_columns++;
+            }
+        }
+
+        const uint32_t count = index.count(type);
+        double *values[LOGREADER_MAX_FIELDS];
+        for (uint8_t c=0; c<num_columns; c++) {
+            values[c] = (double *)calloc(count+1, sizeof(double));
+            if (values[c] == NULL) {
+                ::printf("Out of memory for %s\n", *t);
+                exit(1);
+            }
+        }
+        if (!index.extract(type, columns, num_columns, values)) {
+            exit(1);
+        }
+
+        char csvname[10];
+        snprintf(csvname, sizeof(csvname), "%.4s.csv", f.name);
+        FILE *csv = xfopen(csvname, "w");
+        for (uint8_t c=0; c<num_columns; c++) {
+            fprintf(csv, "%s%s", c?",":"", columns[c]);
+        }
+        fprintf(csv, "\n");
+        // scaled fields are written in their units, as mavlogdump does
+        const char *fmts[LOGREADER_MAX_FIELDS];
+        double multipliers[LOGREADER_MAX_FIELDS];
+        for (uint8_t c=0; c<num_columns; c++) {
+            multipliers[c] = LogIndex::field_multiplier(column_types[c]);
+            switch (column_types[c]) {
+            case 'f':
+                fmts[c] = "%s%.9g";
+                break;
+            case 'd':
+                fmts[c] = "%s%.17g";
+                break;
+            case 'c':
+            case 'C':
+            case 'e':
+            case 'E':
+                fmts[c] = "%s%.2f";
+                break;
+            case 'L':
+                fmts[c] = "%s%.7f";
+                break;
+            default:
+                // integers are exact as doubles up to 2^53
+                fmts[c] = "%s%.0f";
+                break;
+            }
+        }
+        for (uint32_t i=0; i<count; i++) {
+            for (uint8_t c=0; c<num_columns; c++) {
+                fprintf(csv, fmts[c], c?",":"", values[c][i] * multipliers[c]);
+            }
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+        for (uint8_t c=0; c<num_columns; c++) {
+            free(values[c]);
+        }
+        ::printf("Wrote %u %s messages to %s\n", (unsigned)count, *t, csvname);
+    }
+}
+
 void Replay::setup()
 {
     ::printf("Starting\n");
@@ -507,6 +651,11 @@ void Replay::setup()
 
     _parse_command_line(argc, argv);
 
+    if (csv_types != NULL) {
+        write_csv_files();
+        exit(0);
+    }
+
     if (!check_generate) {
         logreader.set_save_chek_messages(true);
     }
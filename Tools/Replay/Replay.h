@@ -159,6 +159,8 @@ private:
     uint32_t output_counter = 0;
     uint64_t last_timestamp = 0;
     bool packet_counts = false;
+    const char **csv_types = NULL;
+    const char **csv_fields = NULL;
 
     struct {
         float max_roll_error;
@@ -195,6 +197,7 @@ private:
     void load_param_file(const char *filename);
     void set_signal_handlers(void);
     void flush_and_exit();
+    void write_csv_files(void);
 
     FILE *xfopen(const char *f, const char *mode);
 
@@ -0,0 +1,188 @@
+#include <AP_gtest.h>
+
+#include "../LogIndex.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define LOG_TEST_ATT_MSG 10
+#define LOG_TEST_POS_MSG 11
+
+struct PACKED log_TestAtt {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float roll;
+    int16_t pitch;
+    uint8_t mode;
+    char name[4];
+};
+
+struct PACKED log_TestPos {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    int32_t lat;
+    int32_t alt;
+    double d;
+};
+
+/*
+  a synthetic log, with garbage and a message of unknown format part
+  way through
+ */
+class LogIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        strcpy(path, "/tmp/test_logindexXXXXXX");
+        const int fd = mkstemp(path);
+        ASSERT_NE(fd, -1);
+        f = fdopen(fd, "w");
+        ASSERT_NE(f, nullptr);
+        write_format(LOG_FORMAT_MSG, sizeof(struct log_Format), "FMT", "BBnNZ", "Type,Length,Name,Format,Columns");
+        write_format(LOG_TEST_ATT_MSG, sizeof(struct log_TestAtt), "TATT", "QfcBn", "TimeUS,Roll,Pitch,Mode,Name");
+        write_format(LOG_TEST_POS_MSG, sizeof(struct log_TestPos), "TPOS", "QLid", "TimeUS,Lat,Alt,D");
+    }
+
+    void TearDown() override
+    {
+        unlink(path);
+    }
+
+    void write_format(uint8_t type, uint8_t length, const char *name, const char *format, const char *labels)
+    {
+        struct log_Format fmt {};
+        fmt.head1 = HEAD_BYTE1;
+        fmt.head2 = HEAD_BYTE2;
+        fmt.msgid = LOG_FORMAT_MSG;
+        fmt.type = type;
+        fmt.length = length;
+        strncpy(fmt.name, name, sizeof(fmt.name));
+        strncpy(fmt.format, format, sizeof(fmt.format));
+        strncpy(fmt.labels, labels, sizeof(fmt.labels));
+        fwrite(&fmt, sizeof(fmt), 1, f);
+    }
+
+    void write_messages(uint32_t n)
+    {
+        for (uint32_t i=0; i<n; i++) {
+            const struct log_TestAtt att {
+                LOG_PACKET_HEADER_INIT(LOG_TEST_ATT_MSG),
+                time_us : 1000000 + i*2500ULL,
+                roll    : i*0.25f,
+                pitch   : (int16_t)(i - n/2),
+                mode    : (uint8_t)(i % 7),
+                name    : {'a', 'b', 'c', 'd'},
+            };
+            fwrite(&att, sizeof(att), 1, f);
+            if (i % 3 == 0) {
+                const struct log_TestPos pos {
+                    LOG_PACKET_HEADER_INIT(LOG_TEST_POS_MSG),
+                    time_us : 1000000 + i*2500ULL,
+                    lat     : -353632621 + (int32_t)i,
+                    alt     : -(int32_t)i,
+                    d       : i / 3.0,
+                };
+                fwrite(&pos, sizeof(pos), 1, f);
+            }
+            if (i == n/2) {
+                fwrite("garbage", 7, 1, f);
+                const uint8_t unknown[3] { HEAD_BYTE1, HEAD_BYTE2, 99 };
+                fwrite(unknown, sizeof(unknown), 1, f);
+            }
+        }
+    }
+
+    bool open(LogIndex &index)
+    {
+        fclose(f);
+        f = nullptr;
+        return index.open_log(path);
+    }
+
+    char path[32];
+    FILE *f;
+};
+
+TEST_F(LogIndexTest, Extract)
+{
+    const uint32_t n = 10000;
+    write_messages(n);
+    LogIndex index;
+    ASSERT_TRUE(open(index));
+
+    uint8_t att, pos, type;
+    ASSERT_TRUE(index.find_type("TATT", att));
+    ASSERT_TRUE(index.find_type("TPOS", pos));
+    EXPECT_FALSE(index.find_type("XKF1", type));
+    EXPECT_EQ(index.count(att), n);
+    EXPECT_EQ(index.count(pos), (n+2)/3);
+    EXPECT_EQ(index.bytes_skipped(), 10U);
+
+    const char *labels[] { "TimeUS", "Roll", "Pitch", "Mode" };
+    double *columns[4];
+    for (auto &c : columns) {
+        c = new double[n];
+    }
+    ASSERT_TRUE(index.extract(att, labels, 4, columns));
+    for (uint32_t i=0; i<n; i++) {
+        EXPECT_EQ(columns[0][i], 1000000 + i*2500ULL);
+        EXPECT_EQ(columns[1][i], i*0.25f);
+        EXPECT_EQ(columns[2][i], (int16_t)(i - n/2));
+        EXPECT_EQ(columns[3][i], i % 7);
+    }
+
+    const char *pos_labels[] { "Lat", "Alt", "D" };
+    ASSERT_TRUE(index.extract(pos, pos_labels, 3, columns));
+    for (uint32_t i=0; i<index.count(pos); i++) {
+        EXPECT_EQ(columns[0][i], -353632621 + (int32_t)(i*3));
+        EXPECT_EQ(columns[1][i], -(int32_t)(i*3));
+        EXPECT_EQ(columns[2][i], i);
+    }
+
+    // strings and missing fields can't be extracted
+    const char *string_label[] { "Name" };
+    const char *missing_label[] { "Yaw" };
+    EXPECT_FALSE(index.extract(att, string_label, 1, columns));
+    EXPECT_FALSE(index.extract(att, missing_label, 1, columns));
+
+    for (auto &c : columns) {
+        delete[] c;
+    }
+}
+
+TEST_F(LogIndexTest, BadFormats)
+{
+    // unknown field type, length not matching the format, and a
+    // conflicting redefinition of TATT
+    write_format(20, 7, "TBAD", "X", "Bad");
+    write_format(21, 10, "TLEN", "f", "Len");
+    write_format(LOG_TEST_ATT_MSG, 7, "TATT", "f", "Roll");
+    write_messages(10);
+    LogIndex index;
+    ASSERT_TRUE(open(index));
+
+    uint8_t type;
+    EXPECT_FALSE(index.find_type("TBAD", type));
+    EXPECT_FALSE(index.find_type("TLEN", type));
+    ASSERT_TRUE(index.find_type("TATT", type));
+    EXPECT_EQ(type, LOG_TEST_ATT_MSG);
+    EXPECT_EQ(index.format(type).length, sizeof(struct log_TestAtt));
+    EXPECT_EQ(index.count(type), 10U);
+    EXPECT_EQ(index.bytes_skipped(), 3*sizeof(struct log_Format) + 10);
+}
+
+TEST(LogIndex, FieldTypes)
+{
+    EXPECT_EQ(LogIndex::field_size('Q'), 8);
+    EXPECT_EQ(LogIndex::field_size('Z'), 64);
+    EXPECT_EQ(LogIndex::field_size('X'), 0);
+    EXPECT_TRUE(LogIndex::numeric_field_type('L'));
+    EXPECT_FALSE(LogIndex::numeric_field_type('n'));
+    EXPECT_DOUBLE_EQ(LogIndex::field_multiplier('c'), 0.01);
+    EXPECT_DOUBLE_EQ(LogIndex::field_multiplier('L'), 1.0e-7);
+    EXPECT_DOUBLE_EQ(LogIndex::field_multiplier('f'), 1.0);
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+
+'''
+measure MAVLink round trip latency to an autopilot
+
+Sends TIMESYNC requests and times the responses, then prints the
+minimum, mean, percentiles and maximum of the round trip time. Useful
+for comparing UART/network transports of a HAL, e.g.:
+  Tools/scripts/mavlink_rtt.py --device udpin:0.0.0.0:14550 --count 1000
+'''
+
+from __future__ import print_function
+
+import optparse
+import time
+
+from pymavlink import mavutil
+
+parser = optparse.OptionParser("mavlink_rtt.py [options]")
+parser.add_option("--device", default="udpin:0.0.0.0:14550", help="MAVLink connection string")
+parser.add_option("--baudrate", type=int, default=115200, help="baudrate for serial connections")
+parser.add_option("--count", type=int, default=200, help="number of requests")
+parser.add_option("--interval", type=float, default=0.05, help="time between requests in seconds")
+parser.add_option("--timeout", type=float, default=1.0, help="time to wait for each response in seconds")
+opts, args = parser.parse_args()
+
+mav = mavutil.mavlink_connection(opts.device, baud=opts.baudrate, source_system=250)
+print("Waiting for heartbeat")
+mav.wait_heartbeat()
+print("Heartbeat from system %u" % mav.target_system)
+
+rtts = []
+lost = 0
+for i in range(opts.count):
+    ts1 = int(time.time() * 1.0e9)
+    t0 = time.time()
+    mav.mav.timesync_send(0, ts1)
+    while True:
+        remaining = opts.timeout - (time.time() - t0)
+        if remaining <= 0:
+            lost += 1
+            break
+        m = mav.recv_match(type='TIMESYNC', blocking=True, timeout=remaining)
+        if m is not None and m.tc1 != 0 and m.ts1 == ts1:
+            rtts.append((time.time() - t0) * 1.0e3)
+            break
+    time.sleep(opts.interval)
+
+if len(rtts) == 0:
+    print("No responses received")
+    exit(1)
+
+rtts.sort()
+
+
+def percentile(p):
+    return rtts[min(len(rtts)-1, int(p * len(rtts)))]
+
+
+print("%u responses, %u lost" % (len(rtts), lost))
+print("RTT ms: min %.2f mean %.2f p50 %.2f p90 %.2f p99 %.2f max %.2f" % (
+    rtts[0], sum(rtts) / len(rtts),
+    percentile(0.5), percentile(0.9), percentile(0.99), rtts[-1]))
@@ -0,0 +1,127 @@
+#!/usr/bin/env python
+
+'''
+measure mission upload and download throughput
+
+Generates a lawnmower survey of the requested number of waypoints,
+uploads it with the MISSION_ITEM_INT protocol, downloads it again and
+checks it matches. Prints the items per second achieved each way. For
+large missions on boards with an SD card set MIS_OPTIONS bit 2 to use
+the file mission store, e.g.:
+  Tools/scripts/mission_transfer_bench.py --device udpin:0.0.0.0:14550 --count 10000
+
+--latency delays each reply to an item request, simulating a link
+with that round trip time, e.g. to measure a pipelined upload:
+  Tools/scripts/mission_transfer_bench.py --count 5000 --latency 0.1 --no-download
+'''
+
+from __future__ import print_function
+
+import optparse
+import sys
+import time
+
+from pymavlink import mavutil
+
+parser = optparse.OptionParser("mission_transfer_bench.py [options]")
+parser.add_option("--device", default="udpin:0.0.0.0:14550", help="MAVLink connection string")
+parser.add_option("--baudrate", type=int, default=115200, help="baudrate for serial connections")
+parser.add_option("--count", type=int, default=10000, help="number of waypoints")
+parser.add_option("--timeout", type=float, default=5.0, help="time without progress before giving up in seconds")
+parser.add_option("--latency", type=float, default=0.0, help="simulated round trip time for uploads in seconds")
+parser.add_option("--no-download", action="store_true", default=False, help="only measure the upload")
+opts, args = parser.parse_args()
+
+mav = mavutil.mavlink_connection(opts.device, baud=opts.baudrate, source_system=250)
+print("Waiting for heartbeat")
+mav.wait_heartbeat()
+print("Heartbeat from system %u" % mav.target_system)
+
+
+def survey_item(seq):
+    '''return a waypoint of a lawnmower survey, seq 0 is home'''
+    row = seq // 20
+    col = seq % 20
+    if row % 2:
+        col = 19 - col
+    return mavutil.mavlink.MAVLink_mission_item_int_message(
+        mav.target_system, mav.target_component, seq,
+        mavutil.mavlink.MAV_FRAME_GLOBAL_RELATIVE_ALT_INT,
+        mavutil.mavlink.MAV_CMD_NAV_WAYPOINT,
+        0, 1, 0, 0, 0, 0,
+        int(-353632620 + row * 450),
+        int(1491652370 + col * 550),
+        100,
+        mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+
+
+def upload(count):
+    '''upload count items, returning the elapsed time and number of requests'''
+    t0 = time.time()
+    mav.mav.mission_count_send(mav.target_system, mav.target_component, count,
+                               mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+    pending = []
+    requests = 0
+    last_progress = time.time()
+    while True:
+        # send replies which are due
+        now = time.time()
+        while pending and pending[0][0] <= now:
+            mav.mav.send(survey_item(pending.pop(0)[1]))
+        m = mav.recv_match(type=['MISSION_REQUEST', 'MISSION_REQUEST_INT', 'MISSION_ACK'],
+                           blocking=True, timeout=0.01)
+        if m is None:
+            if time.time() - last_progress > opts.timeout:
+                raise Exception("upload timed out")
+            continue
+        last_progress = time.time()
+        if m.get_type() == 'MISSION_ACK':
+            if m.type != mavutil.mavlink.MAV_MISSION_ACCEPTED:
+                raise Exception("upload failed: %u" % m.type)
+            return time.time() - t0, requests
+        requests += 1
+        pending.append((last_progress + opts.latency, m.seq))
+
+
+def download():
+    '''download the mission, returning the items and the elapsed time'''
+    t0 = time.time()
+    mav.mav.mission_request_list_send(mav.target_system, mav.target_component,
+                                      mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+    m = mav.recv_match(type='MISSION_COUNT', blocking=True, timeout=opts.timeout)
+    if m is None:
+        raise Exception("no MISSION_COUNT")
+    count = m.count
+    items = []
+    while len(items) < count:
+        seq = len(items)
+        mav.mav.mission_request_int_send(mav.target_system, mav.target_component, seq,
+                                         mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+        m = mav.recv_match(type='MISSION_ITEM_INT', blocking=True, timeout=opts.timeout)
+        if m is None:
+            raise Exception("download timed out at %u" % seq)
+        if m.seq == seq:
+            items.append(m)
+    mav.mav.mission_ack_send(mav.target_system, mav.target_component,
+                             mavutil.mavlink.MAV_MISSION_ACCEPTED,
+                             mavutil.mavlink.MAV_MISSION_TYPE_MISSION)
+    return items, time.time() - t0
+
+
+up, requests = upload(opts.count)
+print("upload %u items: %.1fs, %.1f items/s, %u requests" % (opts.count, up, opts.count / up, requests))
+if opts.no_download:
+    sys.exit(0)
+
+items, down = download()
+print("download %u items: %.1fs, %.1f items/s" % (len(items), down, len(items) / down))
+
+bad = 0
+for m in items[1:]:
+    ref = survey_item(m.seq)
+    if m.command != ref.command or m.x != ref.x or m.y != ref.y or abs(m.z - ref.z) > 0.01:
+        bad += 1
+if len(items) != opts.count or bad != 0:
+    print("mission mismatch: %u items, %u differ" % (len(items), bad))
+    sys.exit(1)
+sys.exit(0)
@@ -0,0 +1,144 @@
+#!/usr/bin/env python
+
+'''
+compare SITL physics integrators
+
+Flies the standard copter mission with a range of SIM_PHYS_INTEG,
+SIM_PHYS_SUBSTEP and physics rate settings, and reports the trajectory
+error against a high rate reference run along with the achieved
+simulation speed in sim-seconds per wall-second.
+
+Run from the root of the source tree, e.g.:
+  Tools/scripts/sitl_integrator_bench.py --vehicle ArduCopter --frame quad
+'''
+
+from __future__ import print_function
+
+import math
+import optparse
+import sys
+import time
+
+import pexpect
+from pymavlink import mavutil
+
+parser = optparse.OptionParser("sitl_integrator_bench.py [options]")
+parser.add_option("--vehicle", default="ArduCopter", help="vehicle to simulate")
+parser.add_option("--frame", default="quad", help="frame to simulate")
+parser.add_option("--mission", default="Tools/autotest/copter_mission.txt", help="mission to fly")
+parser.add_option("--speedup", type=int, default=100, help="requested simulation speedup")
+parser.add_option("--timeout", type=float, default=600, help="mission timeout in simulation seconds")
+parser.add_option("--ref-rate", type=int, default=4800, help="physics rate of the reference run")
+opts, args = parser.parse_args()
+
+# (name, SIM_PHYS_INTEG, SIM_PHYS_SUBSTEP, frame rate)
+configs = [
+    ("euler-1200",       0, 1, 1200),
+    ("trapezoidal-1200", 1, 1, 1200),
+    ("euler-400",        0, 1, 400),
+    ("trapezoidal-400",  1, 1, 400),
+    ("trapezoidal-400x3", 1, 3, 400),
+    ("trapezoidal-200x6", 1, 6, 200),
+]
+
+
+def wait_mode(mav, modes, timeout=30):
+    '''wait for one of a set of flight modes'''
+    start_time = time.time()
+    while time.time() < start_time+timeout:
+        m = mav.recv_match(type='HEARTBEAT', blocking=True, timeout=1)
+        if m is not None and mav.flightmode in modes:
+            return
+    raise Exception("Failed to get mode from %s" % modes)
+
+
+def fly(name, integ, substeps, rate):
+    '''fly the mission once, returning the trajectory and the achieved speed'''
+    print("Running %s" % name)
+    cmd = ('Tools/autotest/sim_vehicle.py -v %s -f %s -w -N -S %u -A "--rate %u"' %
+           (opts.vehicle, opts.frame, opts.speedup, rate))
+    mavproxy = pexpect.spawn(cmd, logfile=None, timeout=120)
+    mavproxy.expect("Ready to FLY")
+    mav = mavutil.mavlink_connection('127.0.0.1:14550')
+    mav.wait_heartbeat()
+
+    mavproxy.send('param set SIM_PHYS_INTEG %u\n' % integ)
+    mavproxy.send('param set SIM_PHYS_SUBSTEP %u\n' % substeps)
+    mavproxy.send('wp load %s\n' % opts.mission)
+    mavproxy.expect('Flight plan received')
+    mavproxy.send('mode loiter\n')
+    wait_mode(mav, ['LOITER'])
+    mavproxy.send('arm throttle\n')
+    mavproxy.expect('ARMED')
+    mavproxy.send('mode auto\n')
+    wait_mode(mav, ['AUTO'])
+    mavproxy.send('rc 3 1500\n')
+
+    track = []
+    t0_sim = None
+    t0_wall = time.time()
+    while True:
+        m = mav.recv_match(type=['GLOBAL_POSITION_INT', 'HEARTBEAT'], blocking=True, timeout=5)
+        if m is None:
+            continue
+        if m.get_type() == 'HEARTBEAT':
+            if track and not (m.base_mode & mavutil.mavlink.MAV_MODE_FLAG_SAFETY_ARMED):
+                # landed and disarmed at the end of the mission
+                break
+            continue
+        t = m.time_boot_ms * 1.0e-3
+        if t0_sim is None:
+            t0_sim = t
+        track.append((t - t0_sim, m.lat * 1.0e-7, m.lon * 1.0e-7, m.relative_alt * 1.0e-3))
+        if t - t0_sim > opts.timeout:
+            print("%s: mission timed out" % name)
+            break
+    wall = time.time() - t0_wall
+
+    mavproxy.close(force=True)
+    return track, track[-1][0] / wall
+
+
+def position_at(track, t):
+    '''linearly interpolate a trajectory at time t'''
+    lo = 0
+    hi = len(track) - 1
+    if t <= track[lo][0]:
+        return track[lo][1:]
+    if t >= track[hi][0]:
+        return track[hi][1:]
+    while hi - lo > 1:
+        mid = (lo + hi) // 2
+        if track[mid][0] <= t:
+            lo = mid
+        else:
+            hi = mid
+    a = track[lo]
+    b = track[hi]
+    r = (t - a[0]) / (b[0] - a[0])
+    return tuple(a[i] + r * (b[i] - a[i]) for i in range(1, 4))
+
+
+def rms_error(ref, track):
+    '''RMS position error in metres of a trajectory against the reference'''
+    total = 0
+    for p in ref:
+        lat, lon, alt = position_at(track, p[0])
+        dn = (lat - p[1]) * 111319.5
+        de = (lon - p[2]) * 111319.5 * math.cos(math.radians(p[1]))
+        du = alt - p[3]
+        total += dn*dn + de*de + du*du
+    return math.sqrt(total / len(ref))
+
+
+ref, ref_speed = fly("reference", 1, 4, opts.ref_rate)
+results = []
+for (name, integ, substeps, rate) in configs:
+    track, speed = fly(name, integ, substeps, rate)
+    results.append((name, rms_error(ref, track), speed))
+
+print("%-20s %12s %18s" % ("config", "rms error(m)", "sim-s per wall-s"))
+print("%-20s %12.3f %18.2f" % ("reference", 0, ref_speed))
+for (name, err, speed) in results:
+    print("%-20s %12.3f %18.2f" % (name, err, speed))
+sys.exit(0)
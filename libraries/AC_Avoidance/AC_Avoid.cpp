@@ -755,7 +755,12 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
 
     // for stopping
     const float speed = safe_vel.length();
-    const Vector2f stopping_point_plus_margin = position_xy + safe_vel*((2.0f + margin_cm + get_stopping_distance(kP, accel_cmss, speed))/speed);
+    const float reach_cm = 2.0f + margin_cm + get_stopping_distance(kP, accel_cmss, speed);
+    const Vector2f stopping_point_plus_margin = position_xy + safe_vel*(reach_cm/speed);
+
+    // edges further away than the vehicle can travel before stopping can't limit
+    // its velocity. Without an acceleration limit every edge limits velocity
+    const bool skip_distant_edges = is_positive(accel_cmss);
 
     for (uint16_t i=0; i<num_points; i++) {
         uint16_t j = i+1;
@@ -765,6 +770,15 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
         // end points of current edge
         Vector2f start = boundary[j];
         Vector2f end = boundary[i];
+        if (skip_distant_edges) {
+            // cheap check of the edge's bounding box, most of the many edges of a
+            // high resolution proximity sensor boundary are out of reach
+            const float dx = MAX(MAX(MIN(start.x, end.x) - position_xy.x, position_xy.x - MAX(start.x, end.x)), 0.0f);
+            const float dy = MAX(MAX(MIN(start.y, end.y) - position_xy.y, position_xy.y - MAX(start.y, end.y)), 0.0f);
+            if (sq(dx) + sq(dy) > sq(reach_cm)) {
+                continue;
+            }
+        }
         if ((AC_Avoid::BehaviourType)_behavior.get() == BEHAVIOR_SLIDE) {
             // vector from current position to closest point on current edge
             Vector2f limit_direction = Vector2f::closest_point(position_xy, start, end) - position_xy;
@@ -261,6 +261,14 @@ bool AP_OABendyRuler::calc_margin_from_inclusion_and_exclusion_polygons(const Lo
             continue;
         }
 
+        // skip polygons whose bounding box is further away than the current margin
+        const AC_PolyFenceBounds* bounds = fence->polyfence().get_exclusion_polygon_bounds(i);
+        if (margin_updated && (bounds != nullptr) && !bounds->contains(start_NE)) {
+            if ((bounds->min_distance_to_segment(start_NE, end_NE) * 0.01f) - fence_margin >= margin) {
+                continue;
+            }
+        }
+
         // if start is inside the polygon the margin's sign is reversed
         const float sign = Polygon_outside(start_NE, boundary, num_points) ? 1.0f : -1.0f;
 
@@ -367,23 +375,8 @@ bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, co
         return false;
     }
 
-    // check each obstacle's distance from segment
-    float smallest_margin = FLT_MAX;
-    for (uint16_t i=0; i<oaDb->database_count(); i++) {
-        const AP_OADatabase::OA_DbItem& item = oaDb->get_item(i);
-        const Vector2f point_cm = item.pos * 100.0f;
-        // margin is distance between line segment and obstacle minus obstacle's radius
-        const float m = Vector2f::closest_distance_between_line_and_point(start_NE, end_NE, point_cm) * 0.01f - item.radius;
-        if (m < smallest_margin) {
-            smallest_margin = m;
-        }
-    }
-
-    // return smallest margin
-    if (smallest_margin < FLT_MAX) {
-        margin = smallest_margin;
-        return true;
-    }
-
-    return false;
+    // margin is distance between line segment and obstacle minus obstacle's radius
+    // objects with a margin over _margin_max don't change the chosen path so only search
+    // out to twice that distance, keeping the logged margins near the limit exact
+    return oaDb->get_margin_from_segment(start_NE * 0.01f, end_NE * 0.01f, MAX(_margin_max * 2.0f, 1.0f), margin);
 }
@@ -31,6 +31,12 @@ extern const AP_HAL::HAL& hal;
     #define AP_OADATABASE_QUEUE_SIZE_DEFAULT 80
 #endif
 
+#ifndef AP_OADATABASE_CELL_SIZE
+    #define AP_OADATABASE_CELL_SIZE             2.0f    // size in meters of the spatial hash grid cells
+#endif
+
+#define AP_OADATABASE_HASH_NONE                 UINT16_MAX
+
 
 const AP_Param::GroupInfo AP_OADatabase::var_info[] = {
 
@@ -116,6 +122,8 @@ void AP_OADatabase::init()
         gcs().send_text(MAV_SEVERITY_INFO, "DB init failed . Sizes queue:%u, db:%u", (unsigned int)_queue.size, (unsigned int)_database.size);
         delete _queue.items;
         delete[] _database.items;
+        delete[] _hash.head;
+        delete[] _hash.next;
         return;
     }
 }
@@ -167,6 +175,17 @@ void AP_OADatabase::init_database()
     }
 
     _database.items = new OA_DbItem[_database.size];
+
+    // spatial hash with about one bucket for every two items
+    _hash.num_buckets = 16;
+    while (_hash.num_buckets < _database.size / 2) {
+        _hash.num_buckets *= 2;
+    }
+    _hash.head = new uint16_t[_hash.num_buckets];
+    _hash.next = new uint16_t[_database.size];
+    if (_hash.head != nullptr) {
+        memset(_hash.head, 0xFF, _hash.num_buckets * sizeof(_hash.head[0]));
+    }
 }
 
 // get bitmask of gcs channels item should be sent to based on its importance
@@ -226,17 +245,11 @@ bool AP_OADatabase::process_queue()
 
         item.send_to_gcs = get_send_to_gcs_flags(item.importance);
 
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
-        bool found = false;
-        for (uint16_t i=0; i<_database.count; i++) {
-            if (is_close_to_item_in_database(i, item)) {
-                database_item_refresh(i, item.timestamp_ms, item.radius);
-                found = true;
-                break;
-            }
-        }
-
-        if (!found) {
+        // compare item to nearby items in database. If found a similar item, update the existing, else add it as a new one
+        const uint16_t close_index = find_close_item_in_database(item);
+        if (close_index < _database.count) {
+            database_item_refresh(close_index, item.timestamp_ms, item.radius);
+        } else {
             database_item_add(item);
         }
     }
@@ -250,6 +263,8 @@ void AP_OADatabase::database_item_add(const OA_DbItem &item)
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    _database.radius_max = MAX(_database.radius_max, item.radius);
+    hash_insert(_database.count);
     _database.count++;
 }
 
@@ -260,6 +275,8 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
         return;
     }
 
+    hash_remove(index);
+
     // radius of 0 tells the GCS we don't care about it any more (aka it expired)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
@@ -271,8 +288,10 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
 
     if (index != _database.count) {
         // copy last object in array over expired object
+        hash_remove(_database.count);
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        hash_insert(index);
     }
 }
 
@@ -292,6 +311,7 @@ void AP_OADatabase::database_item_refresh(const uint16_t index, const uint32_t t
         // and trigger resending to GCS
         _database.items[index].timestamp_ms = timestamp_ms;
         _database.items[index].radius = radius;
+        _database.radius_max = MAX(_database.radius_max, radius);
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
     }
 }
@@ -309,13 +329,18 @@ void AP_OADatabase::database_items_remove_all_expired()
     const uint32_t now_ms = AP_HAL::millis();
     const uint32_t expiry_ms = (uint32_t)_database_expiry_seconds * 1000;
     uint16_t index = 0;
+    float radius_max = 0.0f;
     while (index < _database.count) {
         if (now_ms - _database.items[index].timestamp_ms > expiry_ms) {
             database_item_remove(index);
         } else {
+            radius_max = MAX(radius_max, _database.items[index].radius);
             index++;
         }
     }
+
+    // tighten the radius bound used by spatial hash searches
+    _database.radius_max = radius_max;
 }
 
 // returns true if a similar object already exists in database. When true, the object timer is also reset
@@ -330,6 +355,119 @@ bool AP_OADatabase::is_close_to_item_in_database(const uint16_t index, const OA_
     return ((distance_sq < sq(item.radius)) || (distance_sq < sq(_database.items[index].radius)));
 }
 
+// returns index of a database item close to "item" or _database.count if none
+uint16_t AP_OADatabase::find_close_item_in_database(const OA_DbItem &item) const
+{
+    // an item is close if it is within either object's radius so only
+    // the cells within the largest radius of "item" need to be searched
+    const float search_radius = MAX(item.radius, _database.radius_max);
+    const int32_t x_min = hash_cell(item.pos.x - search_radius);
+    const int32_t x_max = hash_cell(item.pos.x + search_radius);
+    const int32_t y_min = hash_cell(item.pos.y - search_radius);
+    const int32_t y_max = hash_cell(item.pos.y + search_radius);
+
+    // with large objects checking every item is cheaper than visiting every cell
+    if (float(x_max - x_min + 1) * float(y_max - y_min + 1) > _database.count) {
+        for (uint16_t i=0; i<_database.count; i++) {
+            if (is_close_to_item_in_database(i, item)) {
+                return i;
+            }
+        }
+        return _database.count;
+    }
+
+    for (int32_t x = x_min; x <= x_max; x++) {
+        for (int32_t y = y_min; y <= y_max; y++) {
+            for (uint16_t i = _hash.head[hash_bucket(x, y)]; i != AP_OADATABASE_HASH_NONE; i = _hash.next[i]) {
+                if (is_close_to_item_in_database(i, item)) {
+                    return i;
+                }
+            }
+        }
+    }
+    return _database.count;
+}
+
+// get the smallest margin (distance minus radius) between the segment from start to end and any object.
+// start and end are offsets in meters from the EKF origin. Objects with a margin over margin_max may be ignored
+// returns false if the database is empty, margin is set to margin_max if no object is closer
+bool AP_OADatabase::get_margin_from_segment(const Vector2f &start, const Vector2f &end, float margin_max, float &margin) const
+{
+    if (!healthy() || (_database.count == 0)) {
+        return false;
+    }
+
+    // objects further than this from the segment have a margin over margin_max
+    const float search_dist = MAX(margin_max, 0.0f) + _database.radius_max;
+    const int32_t x_min = hash_cell(MIN(start.x, end.x) - search_dist);
+    const int32_t x_max = hash_cell(MAX(start.x, end.x) + search_dist);
+    const int32_t y_min = hash_cell(MIN(start.y, end.y) - search_dist);
+    const int32_t y_max = hash_cell(MAX(start.y, end.y) + search_dist);
+
+    float smallest_margin = margin_max;
+
+    if (float(x_max - x_min + 1) * float(y_max - y_min + 1) > _database.count) {
+        // cheaper to check every item
+        for (uint16_t i=0; i<_database.count; i++) {
+            const float m = Vector2f::closest_distance_between_line_and_point(start, end, _database.items[i].pos) - _database.items[i].radius;
+            smallest_margin = MIN(smallest_margin, m);
+        }
+        margin = smallest_margin;
+        return true;
+    }
+
+    // cells whose centre is further than this from the segment can't hold an object within search_dist
+    const float cell_dist_max_sq = sq(search_dist + AP_OADATABASE_CELL_SIZE * 0.71f);
+    for (int32_t x = x_min; x <= x_max; x++) {
+        for (int32_t y = y_min; y <= y_max; y++) {
+            const Vector2f cell_centre((x + 0.5f) * AP_OADATABASE_CELL_SIZE, (y + 0.5f) * AP_OADATABASE_CELL_SIZE);
+            if (Vector2f::closest_distance_between_line_and_point_squared(start, end, cell_centre) > cell_dist_max_sq) {
+                continue;
+            }
+            for (uint16_t i = _hash.head[hash_bucket(x, y)]; i != AP_OADATABASE_HASH_NONE; i = _hash.next[i]) {
+                const float m = Vector2f::closest_distance_between_line_and_point(start, end, _database.items[i].pos) - _database.items[i].radius;
+                smallest_margin = MIN(smallest_margin, m);
+            }
+        }
+    }
+
+    margin = smallest_margin;
+    return true;
+}
+
+// return grid cell coordinate of a position in meters
+int32_t AP_OADatabase::hash_cell(float pos) const
+{
+    return (int32_t)floorf(pos * (1.0f / AP_OADATABASE_CELL_SIZE));
+}
+
+// return the spatial hash bucket of a grid cell. Cells sharing a bucket
+// only cost extra distance checks
+uint16_t AP_OADatabase::hash_bucket(int32_t cell_x, int32_t cell_y) const
+{
+    return (((uint32_t)cell_x * 73856093U) ^ ((uint32_t)cell_y * 19349663U)) & (_hash.num_buckets - 1);
+}
+
+// add database item "index" to the spatial hash
+void AP_OADatabase::hash_insert(const uint16_t index)
+{
+    const uint16_t bucket = hash_bucket(hash_cell(_database.items[index].pos.x), hash_cell(_database.items[index].pos.y));
+    _hash.next[index] = _hash.head[bucket];
+    _hash.head[bucket] = index;
+}
+
+// remove database item "index" from the spatial hash
+void AP_OADatabase::hash_remove(const uint16_t index)
+{
+    const uint16_t bucket = hash_bucket(hash_cell(_database.items[index].pos.x), hash_cell(_database.items[index].pos.y));
+    for (uint16_t *link = &_hash.head[bucket]; *link != AP_OADATABASE_HASH_NONE; link = &_hash.next[*link]) {
+        if (*link == index) {
+            *link = _hash.next[index];
+            return;
+        }
+    }
+}
+
 // send ADSB_VEHICLE mavlink messages
 void AP_OADatabase::send_adsb_vehicle(mavlink_channel_t chan, uint16_t interval_ms)
 {
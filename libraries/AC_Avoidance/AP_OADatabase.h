@@ -38,7 +38,7 @@ public:
     void queue_push(const Vector2f &pos, uint32_t timestamp_ms, float distance);
 
     // returns true if database is healthy
-    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr); }
+    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr) && (_hash.head != nullptr) && (_hash.next != nullptr); }
 
     // fetch an item in database. Undefined result when i >= _database.count.
     const OA_DbItem& get_item(uint32_t i) const { return _database.items[i]; }
@@ -49,6 +49,11 @@ public:
     // empty queue and try and put into database. Return true if there's more work to do
     bool process_queue();
 
+    // get the smallest margin (distance minus radius) between the segment from start to end and any object.
+    // start and end are offsets in meters from the EKF origin. Objects with a margin over margin_max may be ignored
+    // returns false if the database is empty, margin is set to margin_max if no object is closer
+    bool get_margin_from_segment(const Vector2f &start, const Vector2f &end, float margin_max, float &margin) const;
+
     // send ADSB_VEHICLE mavlink messages
     void send_adsb_vehicle(mavlink_channel_t chan, uint16_t interval_ms);
 
@@ -73,6 +78,15 @@ private:
     // returns true if database item "index" is close to "item"
     bool is_close_to_item_in_database(const uint16_t index, const OA_DbItem &item) const;
 
+    // returns index of a database item close to "item" or _database.count if none
+    uint16_t find_close_item_in_database(const OA_DbItem &item) const;
+
+    // spatial hash management
+    uint16_t hash_bucket(int32_t cell_x, int32_t cell_y) const;
+    int32_t hash_cell(float pos) const;
+    void hash_insert(const uint16_t index);
+    void hash_remove(const uint16_t index);
+
     // enum for use with _OUTPUT parameter
     enum class OA_DbOutputLevel {
         OUTPUT_LEVEL_DISABLED = 0,
@@ -101,8 +115,18 @@ private:
         OA_DbItem       *items;                             // array of objects in the database
         uint16_t        count;                              // number of objects in the items array
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
+        float           radius_max;                         // upper bound on the radius of objects in the database
     } _database;
 
+    // spatial hash of the database. Each object is in the bucket of the
+    // grid cell holding its position, buckets are linked lists of indexes
+    // into _database.items
+    struct {
+        uint16_t        *head;                              // first item in each bucket
+        uint16_t        *next;                              // next item in the same bucket, one per database item
+        uint16_t        num_buckets;                        // power of two
+    } _hash;
+
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
     uint16_t _highest_index_sent[MAVLINK_COMM_NUM_BUFFERS]; // highest index in _database sent to GCS
     uint32_t _last_send_to_gcs_ms[MAVLINK_COMM_NUM_BUFFERS];// system time that send_adsb_vehicle was last called
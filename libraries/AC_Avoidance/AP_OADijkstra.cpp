@@ -28,7 +28,9 @@ AP_OADijkstra::AP_OADijkstra() :
         _inclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_circle_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _fence_visgraph_first_item(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _short_path_data(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _node_queue(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _path(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK)
 {
 }
@@ -542,6 +544,11 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
     // determine if segment crosses any of the inclusion polygons
     uint16_t num_points = 0;
     for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+        // skip polygons whose bounding box does not overlap segment
+        const AC_PolyFenceBounds* bounds = fence->polyfence().get_inclusion_polygon_bounds(i);
+        if ((bounds != nullptr) && !bounds->overlaps_segment(seg_start, seg_end)) {
+            continue;
+        }
         const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
         if ((boundary != nullptr) && (num_points >= 3)) {
             Vector2f intersection;
@@ -553,6 +560,11 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
 
     // determine if segment crosses any of the exclusion polygons
     for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+        // skip polygons whose bounding box does not overlap segment
+        const AC_PolyFenceBounds* bounds = fence->polyfence().get_exclusion_polygon_bounds(i);
+        if ((bounds != nullptr) && !bounds->overlaps_segment(seg_start, seg_end)) {
+            continue;
+        }
         const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
         if ((boundary != nullptr) && (num_points >= 3)) {
             Vector2f intersection;
@@ -615,11 +627,19 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
         return false;
     }
 
+    // expand array holding the index of the first visgraph item for each point
+    if (!_fence_visgraph_first_item.expand_to_hold(total_numpoints() + 1)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
     // clear fence points visibility graph
     _fence_visgraph.clear();
 
     // calculate distance from each point to all other points
+    // items are added in order of id1 and then id2 which allows update_visible_node_distances to search for them quickly
     for (uint8_t i = 0; i < total_numpoints() - 1; i++) {
+        _fence_visgraph_first_item[i] = _fence_visgraph.num_items();
         Vector2f start_seg;
         if (get_point(i, start_seg)) {
             for (uint8_t j = i + 1; j < total_numpoints(); j++) {
@@ -640,6 +660,11 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
         }
     }
 
+    // record end of items for the last point(s)
+    for (uint16_t i = MAX(total_numpoints(), 1) - 1; i <= total_numpoints(); i++) {
+        _fence_visgraph_first_item[i] = _fence_visgraph.num_items();
+    }
+
     return true;
 }
 
@@ -694,38 +719,68 @@ void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
     // get current node for convenience
     const ShortPathNode &curr_node = _short_path_data[curr_node_idx];
 
-    // for each visibility graph
-    const AP_OAVisGraph* visgraphs[] = {&_fence_visgraph, &_destination_visgraph};
-    for (uint8_t v=0; v<ARRAY_SIZE(visgraphs); v++) {
+    // search fence visibility graph for items visible from current node (only fence points appear in this graph)
+    if ((curr_node.id.id_type == AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT) && (curr_node.id.id_num < total_numpoints())) {
+        const AP_OAVisGraph::oaid_num id_num = curr_node.id.id_num;
 
-        // skip if empty
-        const AP_OAVisGraph &curr_visgraph = *visgraphs[v];
-        if (curr_visgraph.num_items() == 0) {
-            continue;
+        // items with current node as id1 are held together
+        for (uint16_t i = _fence_visgraph_first_item[id_num]; i < _fence_visgraph_first_item[id_num + 1]; i++) {
+            update_node_distance(curr_node_idx, _fence_visgraph[i].id2, _fence_visgraph[i].distance_cm);
         }
 
-        // search visibility graph for items visible from current_node
-        for (uint16_t i = 0; i < curr_visgraph.num_items(); i++) {
-            const AP_OAVisGraph::VisGraphItem &item = curr_visgraph[i];
-            // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
-            if ((curr_node.id == item.id1) || (curr_node.id == item.id2)) {
-                AP_OAVisGraph::OAItemID matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
-                // find item's id in node array
-                node_index item_node_idx;
-                if (find_node_from_id(matching_id, item_node_idx)) {
-                    // if current node's distance + distance to item is less than item's current distance, update item's distance
-                    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + item.distance_cm;
-                    if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
-                        // update item's distance and set "distance_from_idx" to current node's index
-                        _short_path_data[item_node_idx].distance_cm = dist_to_item_via_current_node;
-                        _short_path_data[item_node_idx].distance_from_idx = curr_node_idx;
-                    }
+        // items with current node as id2 are found with a binary search of each lower numbered point's items
+        for (AP_OAVisGraph::oaid_num p = 0; p < id_num; p++) {
+            uint16_t low = _fence_visgraph_first_item[p];
+            uint16_t high = _fence_visgraph_first_item[p + 1];
+            while (low < high) {
+                const uint16_t mid = low + (high - low) / 2;
+                if (_fence_visgraph[mid].id2.id_num < id_num) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
                 }
             }
+            if ((low < _fence_visgraph_first_item[p + 1]) && (_fence_visgraph[low].id2.id_num == id_num)) {
+                update_node_distance(curr_node_idx, _fence_visgraph[low].id1, _fence_visgraph[low].distance_cm);
+            }
+        }
+    }
+
+    // search destination visibility graph for items visible from current_node
+    for (uint16_t i = 0; i < _destination_visgraph.num_items(); i++) {
+        const AP_OAVisGraph::VisGraphItem &item = _destination_visgraph[i];
+        // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
+        if ((curr_node.id == item.id1) || (curr_node.id == item.id2)) {
+            update_node_distance(curr_node_idx, (curr_node.id == item.id1) ? item.id2 : item.id1, item.distance_cm);
         }
     }
 }
 
+// update a node's tentative distance if the distance via curr_node_idx is shorter
+void AP_OADijkstra::update_node_distance(node_index curr_node_idx, const AP_OAVisGraph::OAItemID &id, float distance_cm)
+{
+    // find item's id in node array
+    node_index item_node_idx;
+    if (!find_node_from_id(id, item_node_idx)) {
+        return;
+    }
+
+    // visited nodes already hold their shortest distance
+    ShortPathNode &item_node = _short_path_data[item_node_idx];
+    if (item_node.visited) {
+        return;
+    }
+
+    // if current node's distance + distance to item is less than item's current distance, update item's distance
+    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + distance_cm;
+    if (dist_to_item_via_current_node < item_node.distance_cm) {
+        // update item's distance and set "distance_from_idx" to current node's index
+        item_node.distance_cm = dist_to_item_via_current_node;
+        item_node.distance_from_idx = curr_node_idx;
+        node_queue_push(item_node_idx, dist_to_item_via_current_node);
+    }
+}
+
 // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
 // returns true if successful and node_idx is updated
 bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const
@@ -758,26 +813,92 @@ bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_in
     return false;
 }
 
+// place item at position i in the queue and record its position in the node
+void AP_OADijkstra::node_queue_set(uint16_t i, const NodeQueueItem &item)
+{
+    _node_queue[i] = item;
+    _short_path_data[item.idx].queue_pos = i;
+}
+
+// add node to priority queue or reduce its cost if already queued
+// _node_queue must have been expanded to hold every node
+void AP_OADijkstra::node_queue_push(node_index node_idx, float distance_cm)
+{
+    // add straight line distance to destination so nodes towards the destination are searched first (i.e. A*)
+    float cost_cm = distance_cm;
+    Vector2f node_pos;
+    if (get_node_position(_short_path_data[node_idx].id, node_pos)) {
+        cost_cm += (_path_destination - node_pos).length();
+    }
+
+    // distances only decrease so a queued node only ever needs to move up
+    uint16_t i = _short_path_data[node_idx].queue_pos;
+    if (i == OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
+        i = _node_queue_numitems++;
+    }
+
+    // move item up until its parent has a lower cost
+    while (i > 0) {
+        const uint16_t parent = (i - 1) / 2;
+        if (_node_queue[parent].cost_cm <= cost_cm) {
+            break;
+        }
+        node_queue_set(i, _node_queue[parent]);
+        i = parent;
+    }
+    node_queue_set(i, {cost_cm, node_idx});
+}
+
 // find index of node with lowest tentative distance (ignore visited nodes)
 // returns true if successful and node_idx argument is updated
-bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
+bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx)
 {
-    node_index lowest_idx = 0;
-    float lowest_dist = FLT_MAX;
-
-    // scan through all nodes looking for closest
-    for (node_index i=0; i<_short_path_data_numpoints; i++) {
-        const ShortPathNode &node = _short_path_data[i];
-        if (!node.visited && (node.distance_cm < lowest_dist)) {
-            lowest_idx = i;
-            lowest_dist = node.distance_cm;
+    if (_node_queue_numitems == 0) {
+        return false;
+    }
+    node_idx = _node_queue[0].idx;
+    _short_path_data[node_idx].queue_pos = OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX;
+
+    // move last item to the top of the heap and then down until both children have a higher cost
+    _node_queue_numitems--;
+    if (_node_queue_numitems > 0) {
+        const NodeQueueItem last = _node_queue[_node_queue_numitems];
+        uint16_t i = 0;
+        while (true) {
+            uint16_t child = 2 * i + 1;
+            if (child >= _node_queue_numitems) {
+                break;
+            }
+            if ((child + 1 < _node_queue_numitems) && (_node_queue[child + 1].cost_cm < _node_queue[child].cost_cm)) {
+                child++;
+            }
+            if (last.cost_cm <= _node_queue[child].cost_cm) {
+                break;
+            }
+            node_queue_set(i, _node_queue[child]);
+            i = child;
         }
+        node_queue_set(i, last);
     }
+    return true;
+}
 
-    if (lowest_dist < FLT_MAX) {
-        node_idx = lowest_idx;
+// returns position of node as an offset (in cm) from the ekf origin
+// requires _path_source and _path_destination to have been set
+bool AP_OADijkstra::get_node_position(const AP_OAVisGraph::OAItemID &id, Vector2f &pos) const
+{
+    switch (id.id_type) {
+    case AP_OAVisGraph::OATYPE_SOURCE:
+        pos = _path_source;
+        return true;
+    case AP_OAVisGraph::OATYPE_DESTINATION:
+        pos = _path_destination;
         return true;
+    case AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT:
+        return get_point(id.id_num, pos);
     }
+
+    // we should never reach here but just in case
     return false;
 }
 
@@ -794,6 +915,11 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         return false;
     }
 
+    // record source and destination for use by get_node_position and get_shortest_path_point
+    _path_source = origin_NE;
+    _path_destination = destination_NE;
+    _path_numpoints = 0;
+
     // create visgraphs of origin and destination to fence points
     if (!update_visgraph(_source_visgraph, {AP_OAVisGraph::OATYPE_SOURCE, 0}, origin_NE, true, destination_NE)) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
@@ -804,24 +930,25 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         return false;
     }
 
-    // expand _short_path_data if necessary
-    if (!_short_path_data.expand_to_hold(2 + total_numpoints())) {
+    // expand _short_path_data and _node_queue if necessary, each node is queued at most once
+    if (!_short_path_data.expand_to_hold(2 + total_numpoints()) || !_node_queue.expand_to_hold(2 + total_numpoints())) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
 
     // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
     _short_path_data_numpoints = 2;
 
     // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
     for (uint8_t i=0; i<total_numpoints(); i++) {
-        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
     }
 
     // start algorithm from source point
     node_index current_node_idx = 0;
+    _node_queue_numitems = 0;
 
     // update nodes visible from source point
     for (uint16_t i = 0; i < _source_visgraph.num_items(); i++) {
@@ -829,6 +956,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         if (find_node_from_id(_source_visgraph[i].id2, node_idx)) {
             _short_path_data[node_idx].distance_cm = _source_visgraph[i].distance_cm;
             _short_path_data[node_idx].distance_from_idx = current_node_idx;
+            node_queue_push(node_idx, _short_path_data[node_idx].distance_cm);
         } else {
             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
             return false;
@@ -838,22 +966,27 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     _short_path_data[current_node_idx].visited = true;
 
     // move current_node_idx to node with lowest distance
+    node_index dest_node_idx;
+    if (!find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, dest_node_idx)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+        return false;
+    }
     while (find_closest_node_idx(current_node_idx)) {
-        // update distances to all neighbours of current node
-        update_visible_node_distances(current_node_idx);
-
         // mark current node as visited
         _short_path_data[current_node_idx].visited = true;
+
+        // straight line distance never overestimates so the destination's distance is final once it is visited
+        if (current_node_idx == dest_node_idx) {
+            break;
+        }
+
+        // update distances to all neighbours of current node
+        update_visible_node_distances(current_node_idx);
     }
 
     // extract path starting from destination
     bool success = false;
-    node_index nidx;
-    if (!find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, nidx)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
-        return false;
-    }
-    _path_numpoints = 0;
+    node_index nidx = dest_node_idx;
     while (true) {
         if (!_path.expand_to_hold(_path_numpoints + 1)) {
             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
@@ -878,11 +1011,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
             }
         }
     }
-    // update source and destination for by get_shortest_path_point
-    if (success) {
-        _path_source = origin_NE;
-        _path_destination = destination_NE;
-    } else {
+    if (!success) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
     }
 
@@ -900,18 +1029,6 @@ bool AP_OADijkstra::get_shortest_path_point(uint8_t point_num, Vector2f& pos)
     AP_OAVisGraph::OAItemID id = _path[_path_numpoints - point_num - 1];
 
     // convert id to a position offset from EKF origin
-    switch (id.id_type) {
-    case AP_OAVisGraph::OATYPE_SOURCE:
-        pos = _path_source;
-        return true;
-    case AP_OAVisGraph::OATYPE_DESTINATION:
-        pos = _path_destination;
-        return true;
-    case AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT:
-        return get_point(id.id_num, pos);
-    }
-
-    // we should never reach here but just in case
-    return false;
+    return get_node_position(id, pos);
 }
 
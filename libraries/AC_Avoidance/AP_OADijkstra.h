@@ -146,6 +146,7 @@ private:
     AP_OAVisGraph _fence_visgraph;          // holds distances between all inclusion/exclusion fence points (with margin)
     AP_OAVisGraph _source_visgraph;         // holds distances from source point to all other nodes
     AP_OAVisGraph _destination_visgraph;    // holds distances from the destination to all other nodes
+    AP_ExpandingArray<uint16_t> _fence_visgraph_first_item; // index of first _fence_visgraph item for each fence point (items are sorted by id1 then id2)
 
     // updates visibility graph for a given position which is an offset (in cm) from the ekf origin
     // to add an additional position (i.e. the destination) set add_extra_position = true and provide the position in the extra_position argument
@@ -159,6 +160,7 @@ private:
         bool visited;                   // true if all this node's neighbour's distances have been updated
         node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or 255 if not set)
         float distance_cm;              // distance from source (number is tentative until this node is the current node and/or visited = true)
+        node_index queue_pos;           // position of node in _node_queue (or 255 if not queued)
     };
     AP_ExpandingArray<ShortPathNode> _short_path_data;
     node_index _short_path_data_numpoints;  // number of elements in _short_path_data array
@@ -171,9 +173,30 @@ private:
     // returns true if successful and node_idx is updated
     bool find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const;
 
+    // update a node's tentative distance if the distance via curr_node_idx is shorter
+    void update_node_distance(node_index curr_node_idx, const AP_OAVisGraph::OAItemID &id, float distance_cm);
+
+    // priority queue (binary min-heap) of nodes ordered by tentative distance plus straight line distance to destination
+    // each node appears at most once, its entry is moved up when its distance is reduced so the queue never holds more items than nodes
+    struct NodeQueueItem {
+        float cost_cm;                  // tentative distance from source plus estimated distance to destination
+        node_index idx;                 // index into _short_path_data
+    };
+    AP_ExpandingArray<NodeQueueItem> _node_queue;
+    node_index _node_queue_numitems;    // number of items held in _node_queue
+
+    // add node to priority queue or reduce its cost if already queued
+    void node_queue_push(node_index node_idx, float distance_cm);
+
+    // place item at position i in the queue and record its position in the node
+    void node_queue_set(uint16_t i, const NodeQueueItem &item);
+
     // find index of node with lowest tentative distance (ignore visited nodes)
     // returns true if successful and node_idx argument is updated
-    bool find_closest_node_idx(node_index &node_idx) const;
+    bool find_closest_node_idx(node_index &node_idx);
+
+    // returns position of node as an offset (in cm) from the ekf origin
+    bool get_node_position(const AP_OAVisGraph::OAItemID &id, Vector2f &pos) const;
 
     // final path variables and functions
     AP_ExpandingArray<AP_OAVisGraph::OAItemID> _path;   // ids of points on return path in reverse order (i.e. destination is first element)
@@ -0,0 +1,157 @@
+//
+// Benchmark of the object avoidance database. A vehicle flies down a
+// corridor with a 360 degree lidar, each sweep is pushed into the
+// database and BendyRuler style segment queries are made from the
+// vehicle position. The spatial hash query result is checked against
+// a search of every item.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+#include <AC_Avoidance/AP_OADatabase.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+const struct AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+class Parameters {
+public:
+    enum {
+        k_param_oadb = 1,
+    };
+};
+
+static AP_OADatabase oadb;
+static GCS_Dummy _gcs;
+
+const struct AP_Param::Info var_info[] = {
+    { AP_PARAM_GROUP, "OA_DB_", Parameters::k_param_oadb, (const void *)&oadb, {group_info : AP_OADatabase::var_info} },
+    AP_VAREND
+};
+
+static AP_Param param{var_info};
+
+static const uint16_t db_size = 5000;
+static const uint8_t lidar_sectors = 72;
+static const float lidar_range = 25.0f;
+static const float corridor_half_width = 6.0f;
+static const float lookahead = 15.0f;
+static const float margin_max = 5.0f;
+
+static uint32_t sweep;
+
+// position of the vehicle for a sweep, moving down the corridor at 0.2m per sweep
+static Vector2f vehicle_pos(uint32_t n)
+{
+    return Vector2f(n * 0.2f, 1.5f * sinf(n * 0.01f));
+}
+
+// push one lidar sweep of the corridor walls into the database
+static uint8_t push_sweep(uint32_t n)
+{
+    const Vector2f pos = vehicle_pos(n);
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < lidar_sectors; i++) {
+        const float angle = radians(i * (360.0f / lidar_sectors) + 2.5f);
+        const float s = sinf(angle);
+        if (is_zero(s)) {
+            continue;
+        }
+        const float wall_y = (s > 0) ? corridor_half_width : -corridor_half_width;
+        const float dist = (wall_y - pos.y) / s;
+        if (dist > lidar_range) {
+            continue;
+        }
+        oadb.queue_push(pos + Vector2f(cosf(angle), s) * dist, AP_HAL::millis(), dist);
+        count++;
+    }
+    return count;
+}
+
+// smallest margin from a segment to any item found by checking every item
+static float linear_margin(const Vector2f &start, const Vector2f &end, float max_margin)
+{
+    float margin = max_margin;
+    for (uint16_t i = 0; i < oadb.database_count(); i++) {
+        const AP_OADatabase::OA_DbItem &item = oadb.get_item(i);
+        margin = MIN(margin, Vector2f::closest_distance_between_line_and_point(start, end, item.pos) - item.radius);
+    }
+    return margin;
+}
+
+void setup(void)
+{
+    hal.console->printf("OADatabase benchmark\n");
+
+    AP_Param::setup();
+    AP_Param::set_by_name("OA_DB_SIZE", db_size);
+    AP_Param::set_by_name("OA_DB_QUEUE_SIZE", 200);
+    AP_Param::set_by_name("OA_DB_EXPIRE", 0);
+    oadb.init();
+    if (!oadb.healthy()) {
+        hal.console->printf("Failed to allocate database\n");
+    }
+}
+
+void loop(void)
+{
+    if (!oadb.healthy()) {
+        hal.scheduler->delay(1000);
+        return;
+    }
+
+    // insert a batch of sweeps
+    const uint16_t sweeps = 50;
+    uint32_t points = 0;
+    uint64_t insert_us = 0;
+    for (uint16_t i = 0; i < sweeps; i++) {
+        points += push_sweep(sweep++);
+        const uint64_t start_us = AP_HAL::micros64();
+        while (oadb.process_queue()) {
+        }
+        insert_us += AP_HAL::micros64() - start_us;
+    }
+
+    // BendyRuler style queries in every direction from the vehicle
+    const Vector2f pos = vehicle_pos(sweep);
+    const uint8_t bearings = 36;
+    uint64_t hash_us = 0;
+    uint64_t linear_us = 0;
+    uint16_t mismatches = 0;
+    for (uint8_t i = 0; i < bearings; i++) {
+        const float angle = radians(i * (360.0f / bearings));
+        const Vector2f end = pos + Vector2f(cosf(angle), sinf(angle)) * lookahead;
+
+        uint64_t start_us = AP_HAL::micros64();
+        float margin = 0;
+        oadb.get_margin_from_segment(pos, end, margin_max * 2.0f, margin);
+        hash_us += AP_HAL::micros64() - start_us;
+
+        start_us = AP_HAL::micros64();
+        const float expected = linear_margin(pos, end, margin_max * 2.0f);
+        linear_us += AP_HAL::micros64() - start_us;
+
+        if (fabsf(margin - expected) > 1.0e-4f) {
+            mismatches++;
+        }
+    }
+
+    hal.console->printf("%5u items: insert %.2f us/point, query %.1f us hash %.1f us linear, %u mismatches\n",
+                        (unsigned)oadb.database_count(),
+                        (double)(insert_us / float(MAX(points, 1U))),
+                        (double)(hash_us / float(bearings)),
+                        (double)(linear_us / float(bearings)),
+                        (unsigned)mismatches);
+
+    if (oadb.database_count() >= db_size) {
+        hal.scheduler->delay(5000);
+    }
+}
+
+AP_HAL_MAIN();
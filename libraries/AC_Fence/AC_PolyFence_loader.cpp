@@ -213,6 +213,9 @@ bool AC_PolyFence_loader::breached(const Vector2f& pos_cm) const
     // check we are inside each inclusion zone:
     for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
         const InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
+        if (!boundary.bounds.contains(pos_cm)) {
+            return true;
+        }
         if (Polygon_outside(pos_cm, boundary.points, boundary.count)) {
             return true;
         }
@@ -221,6 +224,10 @@ bool AC_PolyFence_loader::breached(const Vector2f& pos_cm) const
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
+        if (!boundary.bounds.contains(pos_cm)) {
+            // outside the bounding box so must be outside the polygon
+            continue;
+        }
         if (!Polygon_outside(pos_cm, boundary.points, boundary.count)) {
             return true;
         }
@@ -250,6 +257,37 @@ bool AC_PolyFence_loader::breached(const Vector2f& pos_cm) const
     return false;
 }
 
+bool AC_PolyFenceBounds::contains(const Vector2f &point) const
+{
+    return (point.x >= min.x && point.x <= max.x &&
+            point.y >= min.y && point.y <= max.y);
+}
+
+bool AC_PolyFenceBounds::overlaps_segment(const Vector2f &seg_start, const Vector2f &seg_end) const
+{
+    if (seg_start.x < min.x && seg_end.x < min.x) {
+        return false;
+    }
+    if (seg_start.x > max.x && seg_end.x > max.x) {
+        return false;
+    }
+    if (seg_start.y < min.y && seg_end.y < min.y) {
+        return false;
+    }
+    if (seg_start.y > max.y && seg_end.y > max.y) {
+        return false;
+    }
+    return true;
+}
+
+float AC_PolyFenceBounds::min_distance_to_segment(const Vector2f &seg_start, const Vector2f &seg_end) const
+{
+    // gap between this box and the segment's bounding box along each axis
+    const float dx = MAX(MAX(min.x - MAX(seg_start.x, seg_end.x), MIN(seg_start.x, seg_end.x) - max.x), 0.0f);
+    const float dy = MAX(MAX(min.y - MAX(seg_start.y, seg_end.y), MIN(seg_start.y, seg_end.y) - max.y), 0.0f);
+    return norm(dx, dy);
+}
+
 bool AC_PolyFence_loader::formatted() const
 {
     return (fence_storage.read_uint8(0) == new_fence_storage_magic &&
@@ -351,6 +389,25 @@ bool AC_PolyFence_loader::read_scaled_latlon_from_storage(const Location &origin
     return true;
 }
 
+void AC_PolyFence_loader::calculate_bounds(const Vector2f *points,
+                                           const uint8_t count,
+                                           AC_PolyFenceBounds &bounds)
+{
+    if (count == 0) {
+        bounds.min.zero();
+        bounds.max.zero();
+        return;
+    }
+    bounds.min = points[0];
+    bounds.max = points[0];
+    for (uint8_t i=1; i<count; i++) {
+        bounds.min.x = MIN(bounds.min.x, points[i].x);
+        bounds.min.y = MIN(bounds.min.y, points[i].y);
+        bounds.max.x = MAX(bounds.max.x, points[i].x);
+        bounds.max.y = MAX(bounds.max.y, points[i].y);
+    }
+}
+
 bool AC_PolyFence_loader::read_polygon_from_storage(const Location &origin, uint16_t &read_offset, const uint8_t vertex_count, Vector2f *&next_storage_point)
 {
     for (uint8_t i=0; i<vertex_count; i++) {
@@ -729,6 +786,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            calculate_bounds(boundary.points, boundary.count, boundary.bounds);
             _num_loaded_inclusion_boundaries++;
             break;
         }
@@ -747,6 +805,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            calculate_bounds(boundary.points, boundary.count, boundary.bounds);
             _num_loaded_exclusion_boundaries++;
             break;
         }
@@ -807,6 +866,13 @@ bool AC_PolyFence_loader::load_from_eeprom()
         return false;
     }
 
+    Debug("Fence: Loaded fence uses %u bytes",
+          (unsigned)(sum_of_polygon_point_counts_and_returnpoint() * sizeof(Vector2f) +
+                     _num_loaded_inclusion_boundaries * sizeof(InclusionBoundary) +
+                     _num_loaded_exclusion_boundaries * sizeof(ExclusionBoundary) +
+                     _num_loaded_circle_inclusion_boundaries * sizeof(InclusionCircle) +
+                     _num_loaded_circle_exclusion_boundaries * sizeof(ExclusionCircle)));
+
     _load_time_ms = AP_HAL::millis();
 
     get_loaded_fence_semaphore().give();
@@ -827,6 +893,15 @@ Vector2f* AC_PolyFence_loader::get_exclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+/// returns bounding box of exclusion polygon or nullptr if index is invalid
+const AC_PolyFenceBounds* AC_PolyFence_loader::get_exclusion_polygon_bounds(uint16_t index) const
+{
+    if (index >= _num_loaded_exclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_exclusion_boundary[index].bounds;
+}
+
 /// returns pointer to array of inclusion polygon points and num_points is filled in with the number of points in the polygon
 /// points are offsets in cm from EKF origin in NE frame
 Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &num_points) const
@@ -841,6 +916,15 @@ Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+/// returns bounding box of inclusion polygon or nullptr if index is invalid
+const AC_PolyFenceBounds* AC_PolyFence_loader::get_inclusion_polygon_bounds(uint16_t index) const
+{
+    if (index >= _num_loaded_inclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_inclusion_boundary[index].bounds;
+}
+
 /// returns the specified exclusion circle
 /// circle center offsets in cm from EKF origin in NE frame, radius is in meters
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const
@@ -29,6 +29,27 @@ public:
     float radius;
 };
 
+// AC_PolyFenceBounds - axis-aligned bounding box of a loaded
+// polygon.  These are calculated once when the fence is loaded and
+// allow checks to rule out polygons without walking their edges.
+class AC_PolyFenceBounds {
+public:
+    Vector2f min;
+    Vector2f max;
+
+    // returns true if point is within the bounding box
+    bool contains(const Vector2f &point) const WARN_IF_UNUSED;
+
+    // returns true if the bounding box of the line segment overlaps
+    // this bounding box.  If false the segment cannot cross the
+    // polygon's edges
+    bool overlaps_segment(const Vector2f &seg_start, const Vector2f &seg_end) const WARN_IF_UNUSED;
+
+    // returns a lower bound on the distance between the line segment
+    // and any point within the bounding box
+    float min_distance_to_segment(const Vector2f &seg_start, const Vector2f &seg_end) const WARN_IF_UNUSED;
+};
+
 class AC_PolyFence_loader
 {
 
@@ -59,6 +80,9 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_exclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    /// returns bounding box of exclusion polygon or nullptr if index is invalid
+    const AC_PolyFenceBounds* get_exclusion_polygon_bounds(uint16_t index) const;
+
     /// return system time of last update to the exclusion polygon points
     uint32_t get_exclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -76,6 +100,9 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_inclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    /// returns bounding box of inclusion polygon or nullptr if index is invalid
+    const AC_PolyFenceBounds* get_inclusion_polygon_bounds(uint16_t index) const;
+
     /// return system time of last update to the inclusion polygon points
     uint32_t get_inclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -252,6 +279,7 @@ private:
     public:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         uint8_t count; // count of points in the boundary
+        AC_PolyFenceBounds bounds; // bounding box of points
     };
     InclusionBoundary *_loaded_inclusion_boundary;
     uint8_t _num_loaded_inclusion_boundaries;
@@ -260,6 +288,7 @@ private:
     public:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         uint8_t count; // count of points in the boundary
+        AC_PolyFenceBounds bounds; // bounding box of points
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
     uint8_t _num_loaded_exclusion_boundaries;
@@ -311,6 +340,11 @@ private:
                                    uint16_t &read_offset,
                                    const uint8_t vertex_count,
                                    Vector2f *&next_storage_point) WARN_IF_UNUSED;
+    // calculate_bounds - fills in bounds with the bounding box of
+    // the count points
+    static void calculate_bounds(const Vector2f *points,
+                                 const uint8_t count,
+                                 AC_PolyFenceBounds &bounds);
 
     /*
      * Upgrade functions - attempt to keep user's fences when
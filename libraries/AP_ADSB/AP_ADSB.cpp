@@ -35,7 +35,12 @@
 
 #define VEHICLE_TIMEOUT_MS              5000   // if no updates in this time, drop it from the list
 #define ADSB_VEHICLE_LIST_SIZE_DEFAULT  25
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define ADSB_VEHICLE_LIST_SIZE_MAX      1000
+#else
 #define ADSB_VEHICLE_LIST_SIZE_MAX      100
+#endif
+#define ADSB_LIST_INDEX_NONE            UINT16_MAX
 #define ADSB_CHAN_TIMEOUT_MS            15000
 #define ADSB_SQUAWK_OCTAL_DEFAULT       1200
 
@@ -65,8 +70,8 @@ const AP_Param::GroupInfo AP_ADSB::var_info[] = {
 
     // @Param: LIST_MAX
     // @DisplayName: ADSB vehicle list size
-    // @Description: ADSB list size of nearest vehicles. Longer lists take longer to refresh with lower SRx_ADSB values.
-    // @Range: 1 100
+    // @Description: ADSB list size of nearest vehicles. Longer lists take longer to refresh with lower SRx_ADSB values. Boards with less than 500k of RAM are limited to 100.
+    // @Range: 1 1000
     // @User: Advanced
     AP_GROUPINFO("LIST_MAX",   2, AP_ADSB, in_state.list_size_param, ADSB_VEHICLE_LIST_SIZE_DEFAULT),
 
@@ -186,10 +191,27 @@ void AP_ADSB::init(void)
         in_state.list_size = in_state.list_size_param;
         in_state.vehicle_list = new adsb_vehicle_t[in_state.list_size];
 
-        if (in_state.vehicle_list == nullptr) {
+        // about one hash bucket for every two vehicles
+        in_state.hash_num_buckets = 16;
+        while (in_state.hash_num_buckets < in_state.list_size / 2) {
+            in_state.hash_num_buckets *= 2;
+        }
+        in_state.hash_head = new uint16_t[in_state.hash_num_buckets];
+        in_state.hash_next = new uint16_t[in_state.list_size];
+        in_state.expiry_heap = new uint16_t[in_state.list_size];
+        in_state.expiry_pos = new uint16_t[in_state.list_size];
+
+        if (in_state.vehicle_list == nullptr ||
+            in_state.hash_head == nullptr ||
+            in_state.hash_next == nullptr ||
+            in_state.expiry_heap == nullptr ||
+            in_state.expiry_pos == nullptr) {
             // dynamic RAM allocation of _vehicle_list[] failed, disable gracefully
             hal.console->printf("Unable to initialize ADS-B vehicle list\n");
+            deinit();
             _enabled.set_and_notify(0);
+        } else {
+            memset(in_state.hash_head, 0xFF, in_state.hash_num_buckets * sizeof(in_state.hash_head[0]));
         }
     }
 
@@ -210,6 +232,14 @@ void AP_ADSB::deinit(void)
         delete [] in_state.vehicle_list;
         in_state.vehicle_list = nullptr;
     }
+    delete [] in_state.hash_head;
+    in_state.hash_head = nullptr;
+    delete [] in_state.hash_next;
+    in_state.hash_next = nullptr;
+    delete [] in_state.expiry_heap;
+    in_state.expiry_heap = nullptr;
+    delete [] in_state.expiry_pos;
+    in_state.expiry_pos = nullptr;
 }
 
 bool AP_ADSB::is_valid_callsign(uint16_t octal)
@@ -255,17 +285,11 @@ void AP_ADSB::update(void)
 
     const uint32_t now = AP_HAL::millis();
 
-    // check current list for vehicles that time out
-    uint16_t index = 0;
-    while (index < in_state.vehicle_count) {
-        // check list and drop stale vehicles. When disabled, the list will get flushed
-        if (now - in_state.vehicle_list[index].last_update_ms > VEHICLE_TIMEOUT_MS) {
-            // don't increment index, we want to check this same index again because the contents changed
-            // also, if we're disabled then clear the list
-            delete_vehicle(index);
-        } else {
-            index++;
-        }
+    // drop stale vehicles. The oldest vehicle is always at the top of
+    // the expiry heap so we stop at the first one that is still fresh
+    while (in_state.vehicle_count > 0 &&
+           now - in_state.vehicle_list[in_state.expiry_heap[0]].last_update_ms > VEHICLE_TIMEOUT_MS) {
+        delete_vehicle(in_state.expiry_heap[0]);
     }
 
     if (_my_loc.is_zero()) {
@@ -385,8 +409,28 @@ void AP_ADSB::delete_vehicle(const uint16_t index)
         furthest_vehicle_distance = 0;
         furthest_vehicle_index = 0;
     }
-    if (index != (in_state.vehicle_count-1)) {
-        in_state.vehicle_list[index] = in_state.vehicle_list[in_state.vehicle_count-1];
+
+    const uint16_t last = in_state.vehicle_count-1;
+    hash_remove(index);
+
+    // take it out of the expiry heap by moving the last heap entry into its place
+    const uint16_t pos = in_state.expiry_pos[index];
+    if (pos != last) {
+        expiry_swap(pos, last);
+        expiry_sift_down(pos, last);
+        expiry_sift_up(pos);
+    }
+
+    if (index != last) {
+        // the last vehicle moves to index, relink it
+        hash_remove(last);
+        in_state.vehicle_list[index] = in_state.vehicle_list[last];
+        hash_insert(index);
+        in_state.expiry_pos[index] = in_state.expiry_pos[last];
+        in_state.expiry_heap[in_state.expiry_pos[index]] = index;
+        if (furthest_vehicle_index == last) {
+            furthest_vehicle_index = index;
+        }
     }
     // TODO: is memset needed? When we decrement the index we essentially forget about it
     memset(&in_state.vehicle_list[in_state.vehicle_count-1], 0, sizeof(adsb_vehicle_t));
@@ -400,8 +444,12 @@ void AP_ADSB::delete_vehicle(const uint16_t index)
  */
 bool AP_ADSB::find_index(const adsb_vehicle_t &vehicle, uint16_t *index) const
 {
-    for (uint16_t i = 0; i < in_state.vehicle_count; i++) {
-        if (in_state.vehicle_list[i].info.ICAO_address == vehicle.info.ICAO_address) {
+    if (in_state.hash_head == nullptr) {
+        return false;
+    }
+    const uint32_t icao = vehicle.info.ICAO_address;
+    for (uint16_t i = in_state.hash_head[hash_bucket(icao)]; i != ADSB_LIST_INDEX_NONE; i = in_state.hash_next[i]) {
+        if (in_state.vehicle_list[i].info.ICAO_address == icao) {
             *index = i;
             return true;
         }
@@ -409,6 +457,93 @@ bool AP_ADSB::find_index(const adsb_vehicle_t &vehicle, uint16_t *index) const
     return false;
 }
 
+// return the hash bucket of an ICAO address
+uint16_t AP_ADSB::hash_bucket(uint32_t icao) const
+{
+    // addresses are often allocated in blocks, mix the bits so
+    // neighbouring addresses spread across buckets
+    return ((icao * 2654435761U) >> 16) & (in_state.hash_num_buckets - 1);
+}
+
+// add list index to the ICAO hash
+void AP_ADSB::hash_insert(const uint16_t index)
+{
+    const uint16_t bucket = hash_bucket(in_state.vehicle_list[index].info.ICAO_address);
+    in_state.hash_next[index] = in_state.hash_head[bucket];
+    in_state.hash_head[bucket] = index;
+}
+
+// remove list index from the ICAO hash
+void AP_ADSB::hash_remove(const uint16_t index)
+{
+    const uint16_t bucket = hash_bucket(in_state.vehicle_list[index].info.ICAO_address);
+    for (uint16_t *link = &in_state.hash_head[bucket]; *link != ADSB_LIST_INDEX_NONE; link = &in_state.hash_next[*link]) {
+        if (*link == index) {
+            *link = in_state.hash_next[index];
+            return;
+        }
+    }
+}
+
+// true if the vehicle at heap position pos1 was updated before the one at pos2
+bool AP_ADSB::expiry_older(const uint16_t pos1, const uint16_t pos2) const
+{
+    const uint32_t t1 = in_state.vehicle_list[in_state.expiry_heap[pos1]].last_update_ms;
+    const uint32_t t2 = in_state.vehicle_list[in_state.expiry_heap[pos2]].last_update_ms;
+    // signed difference so this works across millis() wrap
+    return (int32_t)(t1 - t2) < 0;
+}
+
+void AP_ADSB::expiry_swap(const uint16_t pos1, const uint16_t pos2)
+{
+    const uint16_t index1 = in_state.expiry_heap[pos1];
+    const uint16_t index2 = in_state.expiry_heap[pos2];
+    in_state.expiry_heap[pos1] = index2;
+    in_state.expiry_heap[pos2] = index1;
+    in_state.expiry_pos[index2] = pos1;
+    in_state.expiry_pos[index1] = pos2;
+}
+
+void AP_ADSB::expiry_sift_up(uint16_t pos)
+{
+    while (pos > 0) {
+        const uint16_t parent = (pos - 1) / 2;
+        if (!expiry_older(pos, parent)) {
+            break;
+        }
+        expiry_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+// sift down within the first count entries of the heap
+void AP_ADSB::expiry_sift_down(uint16_t pos, const uint16_t count)
+{
+    while (true) {
+        const uint16_t left = 2 * pos + 1;
+        if (left >= count) {
+            break;
+        }
+        uint16_t child = left;
+        if (left + 1 < count && expiry_older(left + 1, left)) {
+            child = left + 1;
+        }
+        if (!expiry_older(child, pos)) {
+            break;
+        }
+        expiry_swap(pos, child);
+        pos = child;
+    }
+}
+
+// restore heap order after the last_update_ms of a list index changed
+void AP_ADSB::expiry_update(const uint16_t index)
+{
+    const uint16_t pos = in_state.expiry_pos[index];
+    expiry_sift_down(pos, in_state.vehicle_count);
+    expiry_sift_up(pos);
+}
+
 /*
  * Update the vehicle list. If the vehicle is already in the
  * list then it will update it, otherwise it will be added.
@@ -451,12 +586,18 @@ void AP_ADSB::handle_adsb_vehicle(const adsb_vehicle_t &vehicle)
 
         // found, update it
         set_vehicle(index, vehicle);
+        expiry_update(index);
 
     } else if (in_state.vehicle_count < in_state.list_size) {
 
         // not found and there's room, add it to the end of the list
-        set_vehicle(in_state.vehicle_count, vehicle);
+        index = in_state.vehicle_count;
+        set_vehicle(index, vehicle);
         in_state.vehicle_count++;
+        hash_insert(index);
+        in_state.expiry_heap[index] = index;
+        in_state.expiry_pos[index] = index;
+        expiry_sift_up(index);
 
     } else {
         // buffer is full. if new vehicle is closer than furthest, replace furthest with new
@@ -474,7 +615,10 @@ void AP_ADSB::handle_adsb_vehicle(const adsb_vehicle_t &vehicle)
 
             if (my_loc_distance_to_vehicle < furthest_vehicle_distance) { // is closer than the furthest
                 // replace with the furthest vehicle
+                hash_remove(furthest_vehicle_index);
                 set_vehicle(furthest_vehicle_index, vehicle);
+                hash_insert(furthest_vehicle_index);
+                expiry_update(furthest_vehicle_index);
 
                 // furthest_vehicle_index is now invalid because the vehicle was overwritten, need
                 // to run determine_furthest_aircraft() to determine a new one next time
@@ -114,6 +114,18 @@ private:
 
     void set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle);
 
+    // ICAO address hash of list indexes
+    uint16_t hash_bucket(uint32_t icao) const;
+    void hash_insert(const uint16_t index);
+    void hash_remove(const uint16_t index);
+
+    // expiry heap of list indexes, oldest last_update_ms at the top
+    bool expiry_older(const uint16_t pos1, const uint16_t pos2) const;
+    void expiry_swap(const uint16_t pos1, const uint16_t pos2);
+    void expiry_sift_up(uint16_t pos);
+    void expiry_sift_down(uint16_t pos, const uint16_t count);
+    void expiry_update(const uint16_t index);
+
     // Generates pseudorandom ICAO from gps time, lat, and lon
     uint32_t genICAO(const Location &loc);
 
@@ -149,6 +161,18 @@ private:
         adsb_vehicle_t *vehicle_list = nullptr;
         uint16_t    vehicle_count;
         AP_Int32    list_radius;
+
+        // list indexes chained by ICAO address hash, so lookups don't
+        // have to scan the list
+        uint16_t    *hash_head;
+        uint16_t    *hash_next;
+        uint16_t    hash_num_buckets;
+
+        // min-heap of list indexes ordered by last_update_ms so expired
+        // vehicles can be found without checking the whole list.
+        // expiry_pos holds the heap position of each list index
+        uint16_t    *expiry_heap;
+        uint16_t    *expiry_pos;
         AP_Int16    list_altitude;
 
         // streamrate stuff
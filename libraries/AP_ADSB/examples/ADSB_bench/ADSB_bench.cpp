@@ -0,0 +1,153 @@
+//
+// Benchmark of the ADS-B vehicle list. 1000 synthetic aircraft report
+// once a second, a few leave and new ones arrive every cycle so the
+// list sees a steady stream of additions and timeouts. The cost of
+// handling each report, of the periodic update that expires vehicles
+// and of looking a vehicle up by ICAO address is printed.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_Baro/AP_Baro.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_Compass/AP_Compass.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_AHRS/AP_AHRS_DCM.h>
+#include <AP_ADSB/AP_ADSB.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+const struct AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+class Parameters {
+public:
+    enum {
+        k_param_adsb = 1,
+    };
+};
+
+static AP_InertialSensor ins;
+static AP_Baro baro;
+static AP_GPS gps;
+static Compass compass;
+static AP_AHRS_DCM ahrs{};
+static GCS_Dummy _gcs;
+static AP_ADSB adsb;
+
+const struct AP_Param::Info var_info[] = {
+    { AP_PARAM_GROUP, "ADSB_", Parameters::k_param_adsb, (const void *)&adsb, {group_info : AP_ADSB::var_info} },
+    AP_VAREND
+};
+
+static AP_Param param{var_info};
+
+static const uint16_t num_targets = 1000;
+static const uint8_t cycles_per_second = 10;
+static const uint8_t churn_per_cycle = 2;
+
+// ICAO address of the oldest target still flying
+static uint32_t first_icao = 0x100000;
+
+// report from a target circling a point 20km across
+static AP_ADSB::adsb_vehicle_t make_report(uint32_t icao)
+{
+    const float t = AP_HAL::millis() * 0.001f;
+    const float angle = (icao % 360) + t * 0.5f;
+
+    AP_ADSB::adsb_vehicle_t vehicle {};
+    vehicle.info.ICAO_address = icao;
+    vehicle.info.lat = -353632620 + (int32_t)(900000 * sinf(radians(angle)) * ((icao % 97) / 97.0f));
+    vehicle.info.lon = 1491652370 + (int32_t)(1100000 * cosf(radians(angle)) * ((icao % 89) / 89.0f));
+    vehicle.info.altitude = 300000 + (icao % 50) * 30000;
+    vehicle.info.heading = (uint16_t)(fmodf(angle + 90, 360) * 100);
+    vehicle.info.hor_velocity = 6000;
+    vehicle.info.flags = ADSB_FLAGS_VALID_COORDS | ADSB_FLAGS_VALID_ALTITUDE | ADSB_FLAGS_VALID_HEADING | ADSB_FLAGS_VALID_VELOCITY;
+    vehicle.last_update_ms = AP_HAL::millis();
+    return vehicle;
+}
+
+void setup(void)
+{
+    hal.console->printf("ADSB benchmark\n");
+
+    AP_Param::setup();
+    AP_Param::set_by_name("ADSB_ENABLE", 1);
+    AP_Param::set_by_name("ADSB_LIST_MAX", num_targets);
+    AP_Param::set_by_name("ADSB_LIST_RADIUS", 0);
+
+    // first update allocates the list
+    adsb.update();
+}
+
+void loop(void)
+{
+    static uint32_t cycle;
+    static uint32_t report_count;
+    static uint64_t report_us;
+    static uint64_t update_us;
+    static uint64_t lookup_us;
+    static uint32_t lookup_count;
+    static uint32_t lookup_found;
+
+    // each cycle a tenth of the targets report
+    const uint16_t per_cycle = num_targets / cycles_per_second;
+    const uint16_t offset = (cycle % cycles_per_second) * per_cycle;
+    for (uint16_t i = 0; i < per_cycle; i++) {
+        const AP_ADSB::adsb_vehicle_t vehicle = make_report(first_icao + offset + i);
+        const uint64_t start_us = AP_HAL::micros64();
+        adsb.handle_adsb_vehicle(vehicle);
+        report_us += AP_HAL::micros64() - start_us;
+        report_count++;
+    }
+
+    // drain the avoidance samples as AP_Avoidance would
+    AP_ADSB::adsb_vehicle_t sample;
+    while (adsb.next_sample(sample)) {
+    }
+
+    uint64_t start_us = AP_HAL::micros64();
+    adsb.update();
+    update_us += AP_HAL::micros64() - start_us;
+
+    // look up a mix of listed and departed targets
+    for (uint16_t i = 0; i < 100; i++) {
+        AP_ADSB::adsb_vehicle_t vehicle;
+        const uint32_t icao = first_icao - 50 + (get_random16() % (num_targets + 100));
+        start_us = AP_HAL::micros64();
+        if (adsb.get_vehicle_by_ICAO(icao, vehicle)) {
+            lookup_found++;
+        }
+        lookup_us += AP_HAL::micros64() - start_us;
+        lookup_count++;
+    }
+
+    // some targets leave, replaced by new ones
+    first_icao += churn_per_cycle;
+    cycle++;
+
+    if (cycle % cycles_per_second == 0) {
+        hal.console->printf("%4u listed: %.2f us per report, %.1f us per update, %.2f us per lookup (%u%% found)\n",
+                            (unsigned)adsb.get_vehicle_count(),
+                            (double)(report_us / float(report_count)),
+                            (double)(update_us / float(cycles_per_second)),
+                            (double)(lookup_us / float(lookup_count)),
+                            (unsigned)(100 * lookup_found / lookup_count));
+        report_count = 0;
+        report_us = 0;
+        update_us = 0;
+        lookup_us = 0;
+        lookup_count = 0;
+        lookup_found = 0;
+    }
+
+    hal.scheduler->delay(1000 / cycles_per_second);
+}
+
+AP_HAL_MAIN();
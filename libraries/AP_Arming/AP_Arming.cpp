@@ -58,6 +58,8 @@
 #define AP_ARMING_BOARD_VOLTAGE_MAX     5.8f
 #define AP_ARMING_ACCEL_ERROR_THRESHOLD 0.75f
 #define AP_ARMING_AHRS_GPS_ERROR_MAX    10      // accept up to 10m difference between AHRS and GPS
+#define AP_ARMING_CHECK_CACHE_MS        10000   // cached check results are re-evaluated at least this often
+#define AP_ARMING_CHECK_SLOW_US         1000    // pre-arm checks taking longer than this are always logged
 
 #if APM_BUILD_TYPE(APM_BUILD_ArduPlane)
   #define ARMING_RUDDER_DEFAULT         (uint8_t)RudderArming::ARMONLY
@@ -408,13 +410,18 @@ bool AP_Arming::compass_checks(bool report)
             check_failed(ARMING_CHECK_COMPASS, report, "Compass not healthy");
             return false;
         }
-        // check compass learning is on or offsets have been set
-        if (!_compass.learn_offsets_enabled()) {
+        // check compass learning is on or offsets have been set. This
+        // reads the device IDs back from storage, so a pass is kept
+        // until a parameter or the number of compasses changes
+        if (!_compass.learn_offsets_enabled() &&
+            !param_check_cached(_compass_configured_check, _compass.get_count())) {
+            _compass_configured_check.passed = false;
             char failure_msg[50] = {};
             if (!_compass.configured(failure_msg, ARRAY_SIZE(failure_msg))) {
                 check_failed(ARMING_CHECK_COMPASS, report, "%s", failure_msg);
                 return false;
             }
+            param_check_passed(_compass_configured_check, _compass.get_count());
         }
 
         // check for unreasonable compass offsets
@@ -605,9 +612,57 @@ bool AP_Arming::mission_checks(bool report)
           {MIS_ITEM_CHECK_TAKEOFF,       MAV_CMD_NAV_TAKEOFF,        "takeoff"},
           {MIS_ITEM_CHECK_VTOL_TAKEOFF,  MAV_CMD_NAV_VTOL_TAKEOFF,   "vtol takeoff"},
         };
+
+        // scanning a large mission is expensive, so find all the item
+        // types in one pass and only rescan when the mission changes.
+        // A mission changed very recently is always rescanned as the
+        // change time has only millisecond resolution
+        const uint32_t now_ms = AP_HAL::millis();
+        if (_mission_items_scan_idx != 0 ||
+            !_mission_items_valid ||
+            _mission_items_change_ms != mission->last_change_time_ms() ||
+            _mission_items_count != mission->num_commands() ||
+            now_ms - _mission_items_change_ms < 1000 ||
+            now_ms - _mission_items_scan_ms > AP_ARMING_CHECK_CACHE_MS) {
+            if (_mission_items_scan_idx == 0 ||
+                _mission_items_change_ms != mission->last_change_time_ms() ||
+                _mission_items_count != mission->num_commands()) {
+                _mission_items_scan_idx = 1;
+                _mission_items_found = 0;
+                _mission_items_change_ms = mission->last_change_time_ms();
+                _mission_items_count = mission->num_commands();
+            }
+            // a scan stopped by an item still being loaded from file
+            // storage continues from that item on the next check
+            uint16_t i;
+            for (i = _mission_items_scan_idx; i < mission->num_commands(); i++) {
+                AP_Mission::Mission_Command cmd;
+                if (!mission->read_cmd_from_storage(i, cmd)) {
+                    if (mission->storage_busy()) {
+                        break;
+                    }
+                    continue;
+                }
+                for (uint8_t j = 0; j < ARRAY_SIZE(misChecks); j++) {
+                    if (cmd.id == misChecks[j].mis_item_type) {
+                        _mission_items_found |= misChecks[j].check;
+                    }
+                }
+            }
+            if (i < mission->num_commands()) {
+                _mission_items_scan_idx = i;
+                check_failed(ARMING_CHECK_MISSION, report, "Mission items loading");
+                return false;
+            }
+            _mission_items_scan_idx = 0;
+            _mission_items_present = _mission_items_found;
+            _mission_items_valid = true;
+            _mission_items_scan_ms = now_ms;
+        }
+
         for (uint8_t i = 0; i < ARRAY_SIZE(misChecks); i++) {
             if (_required_mission_items & misChecks[i].check) {
-                if (!mission->contains_item(misChecks[i].mis_item_type)) {
+                if (!(_mission_items_present & misChecks[i].check)) {
                     check_failed(ARMING_CHECK_MISSION, report, "Missing mission item: %s", misChecks[i].type);
                     return false;
                 }
@@ -873,22 +928,79 @@ bool AP_Arming::pre_arm_checks(bool report)
     }
 #endif
 
-    return hardware_safety_check(report)
-        &  barometer_checks(report)
-        &  ins_checks(report)
-        &  compass_checks(report)
-        &  gps_checks(report)
-        &  battery_checks(report)
-        &  logging_checks(report)
-        &  manual_transmitter_checks(report)
-        &  mission_checks(report)
-        &  rangefinder_checks(report)
-        &  servo_checks(report)
-        &  board_voltage_checks(report)
-        &  system_checks(report)
-        &  can_checks(report)
-        &  proximity_checks(report)
-        &  camera_checks(report);
+    uint32_t t_us = AP_HAL::micros();
+    bool ret = log_check_time(PreArmCheck::HARDWARE_SAFETY, t_us, hardware_safety_check(report));
+    ret &= log_check_time(PreArmCheck::BARO, t_us, barometer_checks(report));
+    ret &= log_check_time(PreArmCheck::INS, t_us, ins_checks(report));
+    ret &= log_check_time(PreArmCheck::COMPASS, t_us, compass_checks(report));
+    ret &= log_check_time(PreArmCheck::GPS, t_us, gps_checks(report));
+    ret &= log_check_time(PreArmCheck::BATTERY, t_us, battery_checks(report));
+    ret &= log_check_time(PreArmCheck::LOGGING, t_us, logging_checks(report));
+    ret &= log_check_time(PreArmCheck::MANUAL_TX, t_us, manual_transmitter_checks(report));
+    ret &= log_check_time(PreArmCheck::MISSION, t_us, mission_checks(report));
+    ret &= log_check_time(PreArmCheck::RANGEFINDER, t_us, rangefinder_checks(report));
+    ret &= log_check_time(PreArmCheck::SERVO, t_us, servo_checks(report));
+    ret &= log_check_time(PreArmCheck::BOARD_VOLTAGE, t_us, board_voltage_checks(report));
+    ret &= log_check_time(PreArmCheck::SYSTEM, t_us, system_checks(report));
+    ret &= log_check_time(PreArmCheck::CAN, t_us, can_checks(report));
+    ret &= log_check_time(PreArmCheck::PROXIMITY, t_us, proximity_checks(report));
+    ret &= log_check_time(PreArmCheck::CAMERA, t_us, camera_checks(report));
+    return ret;
+}
+
+/*
+  log the time taken by a pre-arm check. Pre-arm checks run
+  continuously while disarmed, so a check is only logged the first
+  time, when its result changes or when it is slow
+ */
+bool AP_Arming::log_check_time(PreArmCheck check, uint32_t &start_us, bool result)
+{
+    const uint32_t now_us = AP_HAL::micros();
+    const uint32_t check_time_us = now_us - start_us;
+    start_us = now_us;
+
+    const uint16_t mask = 1U << uint8_t(check);
+    const bool changed = !(_check_logged_mask & mask) || (bool(_check_passed_mask & mask) != result);
+    if (!changed && check_time_us < AP_ARMING_CHECK_SLOW_US) {
+        return result;
+    }
+    _check_logged_mask |= mask;
+    if (result) {
+        _check_passed_mask |= mask;
+    } else {
+        _check_passed_mask &= ~mask;
+    }
+
+    const struct log_Arm_Check pkt {
+        LOG_PACKET_HEADER_INIT(LOG_ARM_CHECK_MSG),
+        time_us                 : AP_HAL::micros64(),
+        check                   : uint8_t(check),
+        passed                  : result,
+        check_time_us           : check_time_us,
+    };
+    AP::logger().WriteBlock(&pkt, sizeof(pkt));
+    return result;
+}
+
+/*
+  parameter only checks may be skipped while they have passed and no
+  parameter has changed. They are re-run periodically regardless, in
+  case a parameter was changed without going through AP_Param
+ */
+bool AP_Arming::param_check_cached(const struct param_check_cache &cache, uint32_t sensor_state) const
+{
+    return cache.passed &&
+        cache.param_change_count == AP_Param::get_change_count() &&
+        cache.sensor_state == sensor_state &&
+        AP_HAL::millis() - cache.pass_ms < AP_ARMING_CHECK_CACHE_MS;
+}
+
+void AP_Arming::param_check_passed(struct param_check_cache &cache, uint32_t sensor_state) const
+{
+    cache.passed = true;
+    cache.param_change_count = AP_Param::get_change_count();
+    cache.sensor_state = sensor_state;
+    cache.pass_ms = AP_HAL::millis();
 }
 
 bool AP_Arming::arm_checks(AP_Arming::Method method)
@@ -175,6 +175,46 @@ protected:
     void Log_Write_Arm(bool forced, AP_Arming::Method method);
     void Log_Write_Disarm(AP_Arming::Method method);
 
+    // result of a check which depends only on parameters, and
+    // optionally on a summary of sensor state such as the number of
+    // sensors, so it need not be run again until one of them changes
+    struct param_check_cache {
+        uint32_t param_change_count;
+        uint32_t sensor_state;
+        uint32_t pass_ms;
+        bool passed;
+    };
+
+    // returns true if the check passed and no parameters or sensor
+    // state have changed since
+    bool param_check_cached(const struct param_check_cache &cache, uint32_t sensor_state = 0) const;
+    // record the check passed with the current parameters and sensor state
+    void param_check_passed(struct param_check_cache &cache, uint32_t sensor_state = 0) const;
+
+    // identifiers for timing of the common pre-arm checks
+    enum class PreArmCheck : uint8_t {
+        HARDWARE_SAFETY = 0,
+        BARO            = 1,
+        INS             = 2,
+        COMPASS         = 3,
+        GPS             = 4,
+        BATTERY         = 5,
+        LOGGING         = 6,
+        MANUAL_TX       = 7,
+        MISSION         = 8,
+        RANGEFINDER     = 9,
+        SERVO           = 10,
+        BOARD_VOLTAGE   = 11,
+        SYSTEM          = 12,
+        CAN             = 13,
+        PROXIMITY       = 14,
+        CAMERA          = 15,
+    };
+
+    // log the time taken by a pre-arm check since start_us, and
+    // advance start_us to now. Returns the check result
+    bool log_check_time(PreArmCheck check, uint32_t &start_us, bool result);
+
 private:
 
     static AP_Arming *_singleton;
@@ -182,6 +222,24 @@ private:
     bool ins_accels_consistent(const AP_InertialSensor &ins);
     bool ins_gyros_consistent(const AP_InertialSensor &ins);
 
+    // MIS_ITEM_CHECK bits of the items present in the mission, cached
+    // until the mission changes
+    uint8_t  _mission_items_present;
+    bool     _mission_items_valid;
+    uint16_t _mission_items_count;
+    uint32_t _mission_items_change_ms;
+    uint32_t _mission_items_scan_ms;
+    uint16_t _mission_items_scan_idx;   // next item of an unfinished scan, 0 if none
+    uint8_t  _mission_items_found;      // items found so far by an unfinished scan
+
+    // compass device IDs match the stored ones
+    struct param_check_cache _compass_configured_check;
+
+    // PreArmCheck bits of the checks logged in ARMT, and of those
+    // which passed when last logged
+    uint16_t _check_logged_mask;
+    uint16_t _check_passed_mask;
+
     enum MIS_ITEM_CHECK {
         MIS_ITEM_CHECK_LAND          = (1 << 0),
         MIS_ITEM_CHECK_VTOL_LAND     = (1 << 1),
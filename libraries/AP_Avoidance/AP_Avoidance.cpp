@@ -283,10 +283,20 @@ float closest_approach_xy(const Location &my_loc,
                           const uint8_t time_horizon)
 {
 
-    Vector2f delta_vel_ne = Vector2f(obstacle_vel[0] - my_vel[0], obstacle_vel[1] - my_vel[1]);
+    const Vector2f delta_vel_ne = Vector2f(obstacle_vel[0] - my_vel[0], obstacle_vel[1] - my_vel[1]);
     const Vector2f delta_pos_ne = obstacle_loc.get_distance_NE(my_loc);
 
-    Vector2f line_segment_ne = delta_vel_ne * time_horizon;
+    return closest_approach_xy(delta_pos_ne, delta_vel_ne, time_horizon);
+}
+
+// returns the closest two objects will get in the horizontal plane
+// given the position of one relative to the other and their velocity
+// difference (in metres and m/s)
+float closest_approach_xy(const Vector2f &delta_pos_ne,
+                          const Vector2f &delta_vel_ne,
+                          const uint8_t time_horizon)
+{
+    const Vector2f line_segment_ne = delta_vel_ne * time_horizon;
 
     float ret = Vector2<float>::closest_distance_between_radial_and_point
         (line_segment_ne,
@@ -339,12 +349,23 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
 
     obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
 
+    // If we haven't heard from a vehicle then assume it is no
+    // threat. It can't become the most serious threat, so don't spend
+    // time on the rest of the calculation
     const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
-    float closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
+    if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
+        return;
+    }
+
+    // the position and velocity differences are shared by both time horizons
+    const Vector2f delta_pos_ne = obstacle_loc.get_distance_NE(my_loc);
+    const Vector2f delta_vel_ne = Vector2f(obstacle_vel[0] - my_vel[0], obstacle_vel[1] - my_vel[1]);
+
+    float closest_xy = closest_approach_xy(delta_pos_ne, delta_vel_ne, _fail_time_horizon + obstacle_age/1000);
     if (closest_xy < _fail_distance_xy) {
         obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_HIGH;
     } else {
-        closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
+        closest_xy = closest_approach_xy(delta_pos_ne, delta_vel_ne, _warn_time_horizon + obstacle_age/1000);
         if (closest_xy < _warn_distance_xy) {
             obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
         }
@@ -364,22 +385,17 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
         }
     }
 
-    // If we haven't heard from a vehicle then assume it is no threat
-    if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
-        obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
-    }
-
     // could optimise this to not calculate a lot of this if threat
     // level is none - but only *once the GCS has been informed*!
     obstacle.closest_approach_xy = closest_xy;
     obstacle.closest_approach_z = closest_z;
-    float current_distance = my_loc.get_distance(obstacle_loc);
+    const float current_distance = delta_pos_ne.length();
     obstacle.distance_to_closest_approach = current_distance - closest_xy;
-    Vector2f net_velocity_ne = Vector2f(my_vel[0] - obstacle_vel[0], my_vel[1] - obstacle_vel[1]);
+    const float net_speed_ne = delta_vel_ne.length();
     obstacle.time_to_closest_approach = 0.0f;
     if (!is_zero(obstacle.distance_to_closest_approach) &&
-        ! is_zero(net_velocity_ne.length())) {
-        obstacle.time_to_closest_approach = obstacle.distance_to_closest_approach / net_velocity_ne.length();
+        ! is_zero(net_speed_ne)) {
+        obstacle.time_to_closest_approach = obstacle.distance_to_closest_approach / net_speed_ne;
     }
 }
 
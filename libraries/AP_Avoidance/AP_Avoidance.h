@@ -217,6 +217,10 @@ float closest_approach_xy(const Location &my_loc,
                           const Vector3f &obstacle_vel,
                           uint8_t time_horizon);
 
+float closest_approach_xy(const Vector2f &delta_pos_ne,
+                          const Vector2f &delta_vel_ne,
+                          uint8_t time_horizon);
+
 float closest_approach_z(const Location &my_loc,
                          const Vector3f &my_vel,
                          const Location &obstacle_loc,
@@ -2,6 +2,8 @@
  * Location.cpp
  */
 
+#define ALLOW_DOUBLE_MATH_FUNCTIONS
+
 #include "Location.h"
 
 #include <AP_AHRS/AP_AHRS.h>
@@ -251,6 +253,52 @@ void Location::offset(float ofs_north, float ofs_east)
     lng += dlng;
 }
 
+/*
+  double precision distance and offset. The constants are built from
+  integers and DEG_TO_RAD_DOUBLE as floating point literals are single
+  precision on some boards
+ */
+static const double LOCATION_SCALING_FACTOR_DOUBLE = DEG_TO_RAD_DOUBLE * RADIUS_OF_EARTH / 10000000;
+
+static double longitude_scale_double(int32_t lat)
+{
+    const double scale = cos(lat * DEG_TO_RAD_DOUBLE / 10000000);
+    return MAX(scale, 0.01f);
+}
+
+Vector2d Location::get_distance_NE_double(const Location &loc2) const
+{
+    return Vector2d((loc2.lat - lat) * LOCATION_SCALING_FACTOR_DOUBLE,
+                    (loc2.lng - lng) * LOCATION_SCALING_FACTOR_DOUBLE * longitude_scale_double(lat));
+}
+
+void Location::offset_double(double ofs_north, double ofs_east)
+{
+    const int32_t dlat = lrint(ofs_north / LOCATION_SCALING_FACTOR_DOUBLE);
+    const int32_t dlng = lrint(ofs_east / (LOCATION_SCALING_FACTOR_DOUBLE * longitude_scale_double(lat)));
+    lat += dlat;
+    lng += dlng;
+}
+
+void Location::get_distance_NE(const Location *locs, uint16_t count, Vector2f *ne) const
+{
+    const float scale_lng = LOCATION_SCALING_FACTOR * longitude_scale();
+    for (uint16_t i = 0; i < count; i++) {
+        ne[i].x = (locs[i].lat - lat) * LOCATION_SCALING_FACTOR;
+        ne[i].y = (locs[i].lng - lng) * scale_lng;
+    }
+}
+
+void Location::get_distance(const Location *locs, uint16_t count, float *dist) const
+{
+    const float scale = longitude_scale();
+    for (uint16_t i = 0; i < count; i++) {
+        const float dlat = (float)(locs[i].lat - lat);
+        const float dlng = ((float)(locs[i].lng - lng)) * scale;
+        dist[i] = norm(dlat, dlng) * LOCATION_SCALING_FACTOR;
+    }
+}
+
 /*
  *  extrapolate latitude/longitude given bearing and distance
  * Note that this function is accurate to about 1mm at a distance of
@@ -265,7 +313,7 @@ void Location::offset_bearing(float bearing, float distance)
     offset(ofs_north, ofs_east);
 }
 
-float Location::longitude_scale() const
+float Location::longitude_scale(int32_t lat)
 {
     float scale = cosf(lat * (1.0e-7f * DEG_TO_RAD));
     return MAX(scale, 0.01f);
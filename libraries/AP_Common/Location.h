@@ -71,6 +71,21 @@ public:
     // extrapolate latitude/longitude given distances (in meters) north and east
     void offset(float ofs_north, float ofs_east);
 
+    // double precision versions of get_distance_NE() and offset()
+    // for distances of tens of kilometres or more, where the float
+    // versions lose accuracy
+    Vector2d get_distance_NE_double(const Location &loc2) const;
+    void offset_double(double ofs_north, double ofs_east);
+
+    /*
+      batch versions of get_distance_NE() and get_distance() for loops
+      over many locations. The longitude scale is taken once from this
+      location rather than from each of locs, so for get_distance()
+      results differ slightly for points far to the north or south
+     */
+    void get_distance_NE(const Location *locs, uint16_t count, Vector2f *ne) const;
+    void get_distance(const Location *locs, uint16_t count, float *dist) const;
+
     // extrapolate latitude/longitude given bearing and distance
     void offset_bearing(float bearing, float distance);
 
@@ -78,7 +93,10 @@ public:
     // shrinking longitude as you move north or south from the equator
     // Note: this does not include the scaling to convert
     // longitude/latitude points to meters or centimeters
-    float longitude_scale() const;
+    float longitude_scale() const {
+        return longitude_scale(lat);
+    }
+    static float longitude_scale(int32_t lat);
 
     bool is_zero(void) const WARN_IF_UNUSED;
 
@@ -0,0 +1,95 @@
+#include <AP_gtest.h>
+
+#define ALLOW_DOUBLE_MATH_FUNCTIONS
+
+#include <AP_Common/Location.h>
+#include <AP_Math/location.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const Location canberra{-353632620, 1491652370, 58400, Location::AltFrame::ABSOLUTE};
+
+/*
+  north/east offset of loc2 from loc1 on the WGS84 ellipsoid, using the
+  ECEF conversion in location_double.cpp
+ */
+static Vector2d wgs84_offset_NE(const Location &loc1, const Location &loc2)
+{
+    const Vector3d llh1(loc1.lat * DEG_TO_RAD_DOUBLE * 1.0e-7, loc1.lng * DEG_TO_RAD_DOUBLE * 1.0e-7, 0);
+    const Vector3d llh2(loc2.lat * DEG_TO_RAD_DOUBLE * 1.0e-7, loc2.lng * DEG_TO_RAD_DOUBLE * 1.0e-7, 0);
+    Vector3d ecef1, ecef2;
+    wgsllh2ecef(llh1, ecef1);
+    wgsllh2ecef(llh2, ecef2);
+    const Vector3d d = ecef2 - ecef1;
+    const double slat = sin(llh1[0]), clat = cos(llh1[0]);
+    const double slng = sin(llh1[1]), clng = cos(llh1[1]);
+    return Vector2d(-slat * clng * d[0] - slat * slng * d[1] + clat * d[2],
+                    -slng * d[0] + clng * d[1]);
+}
+
+TEST(Location, DistanceNEMatchesWGS84)
+{
+    // the flat earth approximation should be within 0.5% out to 10km
+    for (float dist = 100; dist <= 10000; dist *= 10) {
+        for (uint16_t bearing = 0; bearing < 360; bearing += 45) {
+            Location loc2 = canberra;
+            loc2.offset_double(cos(radians(bearing)) * dist, sin(radians(bearing)) * dist);
+            const Vector2d ne = canberra.get_distance_NE_double(loc2);
+            const Vector2d ref = wgs84_offset_NE(canberra, loc2);
+            EXPECT_NEAR(ref.x, ne.x, 0.005 * dist + 0.02);
+            EXPECT_NEAR(ref.y, ne.y, 0.005 * dist + 0.02);
+        }
+    }
+}
+
+TEST(Location, OffsetDoubleRoundTrip)
+{
+    // only limited by the 1e-7 degree resolution of lat/lng
+    const double offsets[][2] {
+        { 0.5, -0.25 },
+        { 1234.5, 987.6 },
+        { -150000.0, 250000.0 },
+        { 400000.0, -300000.0 },
+    };
+    for (const auto &ofs : offsets) {
+        Location loc2 = canberra;
+        loc2.offset_double(ofs[0], ofs[1]);
+        const Vector2d ne = canberra.get_distance_NE_double(loc2);
+        EXPECT_NEAR(ofs[0], ne.x, 0.01);
+        EXPECT_NEAR(ofs[1], ne.y, 0.01);
+    }
+}
+
+TEST(Location, FloatMatchesDouble)
+{
+    for (float dist = 10; dist <= 10000; dist *= 10) {
+        Location loc2 = canberra;
+        loc2.offset(dist * 0.6f, dist * -0.8f);
+        const Vector2f ne = canberra.get_distance_NE(loc2);
+        const Vector2d ned = canberra.get_distance_NE_double(loc2);
+        EXPECT_NEAR(ned.x, ne.x, 1.0e-5 * dist + 0.001);
+        EXPECT_NEAR(ned.y, ne.y, 1.0e-5 * dist + 0.001);
+    }
+}
+
+TEST(Location, BatchMatchesSingle)
+{
+    Location locs[50];
+    for (uint8_t i = 0; i < ARRAY_SIZE(locs); i++) {
+        locs[i] = canberra;
+        locs[i].offset(i * 37.0f - 900.0f, i * i * 3.0f - 2000.0f);
+    }
+    Vector2f ne[ARRAY_SIZE(locs)];
+    float dist[ARRAY_SIZE(locs)];
+    canberra.get_distance_NE(locs, ARRAY_SIZE(locs), ne);
+    canberra.get_distance(locs, ARRAY_SIZE(locs), dist);
+    for (uint8_t i = 0; i < ARRAY_SIZE(locs); i++) {
+        const Vector2f single = canberra.get_distance_NE(locs[i]);
+        EXPECT_FLOAT_EQ(single.x, ne[i].x);
+        EXPECT_FLOAT_EQ(single.y, ne[i].y);
+        // get_distance() scales longitude at the other location
+        EXPECT_NEAR(canberra.get_distance(locs[i]), dist[i], 2.0e-4f * dist[i] + 0.01f);
+    }
+}
+
+AP_GTEST_MAIN()
@@ -379,6 +379,14 @@ private:
     //keep track of which calibrators have been saved
     RestrictIDTypeArray<bool, COMPASS_MAX_INSTANCES, Priority> _cal_saved;
     bool _cal_autosave;
+
+    // each calibration fit step runs as a compute pool task
+    uint32_t _cal_task;
+    volatile bool _cal_failed;
+    volatile bool _cal_timed_out;
+    bool _cal_fitting(void) const;
+    void _calibration_task(uint32_t id);
+    void _update_calibrators(void);
 #endif
 
     //autoreboot after compass calibration
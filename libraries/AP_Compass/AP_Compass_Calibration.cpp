@@ -1,4 +1,5 @@
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/ComputePool.h>
 #include <AP_Notify/AP_Notify.h>
 #include <AP_GPS/AP_GPS.h>
 #include <GCS_MAVLink/GCS.h>
@@ -11,26 +12,77 @@ extern AP_HAL::HAL& hal;
 
 #if COMPASS_CAL_ENABLED
 
-void Compass::cal_update()
+// run a fit step on each calibrator, noting failures for cal_update()
+void Compass::_update_calibrators(void)
 {
-    if (hal.util->get_soft_armed()) {
-        return;
-    }
-
-    bool running = false;
-
     for (Priority i(0); i<COMPASS_MAX_INSTANCES; i++) {
         bool failure;
         _calibrator[i].update(failure);
         if (failure) {
-            AP_Notify::events.compass_cal_failed = 1;
+            _cal_failed = true;
         }
 
         if (_calibrator[i].check_for_timeout()) {
-            AP_Notify::events.compass_cal_failed = 1;
-            cancel_calibration_all();
+            _cal_timed_out = true;
+        }
+    }
+}
+
+// true if any calibrator has all its samples and is fitting
+bool Compass::_cal_fitting(void) const
+{
+    for (Priority i(0); i<COMPASS_MAX_INSTANCES; i++) {
+        if (_calibrator[i].fitting()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+  the fits are slow enough on small boards to hold up the main loop,
+  so while a calibrator is fitting each step runs as a compute pool
+  task. cal_update() submits the next step once this one is done, so
+  the worker is free for other tasks between steps
+ */
+void Compass::_calibration_task(uint32_t id)
+{
+    if (!AP::compute_pool().cancel_requested(id) && !hal.util->get_soft_armed()) {
+        _update_calibrators();
+    }
+}
+
+void Compass::cal_update()
+{
+    if (hal.util->get_soft_armed()) {
+        return;
+    }
+
+    ComputePool &pool = AP::compute_pool();
+    if (pool.done(_cal_task)) {
+        _cal_task = 0;
+        if (_cal_fitting()) {
+            _cal_task = pool.submit(FUNCTOR_BIND_MEMBER(&Compass::_calibration_task, void, uint32_t),
+                                    ComputePool::Priority::LOW);
+        }
+        if (_cal_task == 0) {
+            // collecting samples, or the pool is unavailable
+            _update_calibrators();
         }
+    }
+
+    if (_cal_failed || _cal_timed_out) {
+        AP_Notify::events.compass_cal_failed = 1;
+        _cal_failed = false;
+    }
+    if (_cal_timed_out) {
+        _cal_timed_out = false;
+        cancel_calibration_all();
+    }
 
+    bool running = false;
+
+    for (Priority i(0); i<COMPASS_MAX_INSTANCES; i++) {
         if (_calibrator[i].running()) {
             running = true;
         } else if (_cal_autosave && !_cal_saved[i] && _calibrator[i].get_status() == CompassCalibrator::Status::SUCCESS) {
@@ -146,6 +198,7 @@ void Compass::_cancel_calibration_mask(uint8_t mask)
 void Compass::cancel_calibration_all()
 {
     _cancel_calibration_mask(0xFF);
+    AP::compute_pool().cancel(_cal_task);
 }
 
 bool Compass::_accept_calibration(uint8_t i)
@@ -60,6 +60,7 @@
 #include "CompassCalibrator.h"
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_GeodesicGrid.h>
+#include <AP_Math/matrixN.h>
 #include <AP_AHRS/AP_AHRS.h>
 #include <AP_GPS/AP_GPS.h>
 #include <GCS_MAVLink/GCS.h>
@@ -80,11 +81,13 @@ CompassCalibrator::CompassCalibrator()
 
 void CompassCalibrator::stop()
 {
+    WITH_SEMAPHORE(_sem);
     set_status(Status::NOT_STARTED);
 }
 
 void CompassCalibrator::set_orientation(enum Rotation orientation, bool is_external, bool fix_orientation)
 {
+    WITH_SEMAPHORE(_sem);
     _check_orientation = true;
     _orientation = orientation;
     _orig_orientation = orientation;
@@ -94,6 +97,7 @@ void CompassCalibrator::set_orientation(enum Rotation orientation, bool is_exter
 
 void CompassCalibrator::start(bool retry, float delay, uint16_t offset_max, uint8_t compass_idx)
 {
+    WITH_SEMAPHORE(_sem);
     if (running()) {
         return;
     }
@@ -108,6 +112,7 @@ void CompassCalibrator::start(bool retry, float delay, uint16_t offset_max, uint
 
 void CompassCalibrator::get_calibration(Vector3f &offsets, Vector3f &diagonals, Vector3f &offdiagonals, float &scale_factor)
 {
+    WITH_SEMAPHORE(_sem);
     if (_status != Status::SUCCESS) {
         return;
     }
@@ -169,6 +174,7 @@ void CompassCalibrator::update_completion_mask()
 
 bool CompassCalibrator::check_for_timeout()
 {
+    WITH_SEMAPHORE(_sem);
     uint32_t tnow = AP_HAL::millis();
     if (running() && tnow - _last_sample_ms > 1000) {
         _retry = false;
@@ -182,6 +188,12 @@ void CompassCalibrator::new_sample(const Vector3f& sample)
 {
     _last_sample_ms = AP_HAL::millis();
 
+    // don't hold up the caller while a fit step is running as a pool
+    // task, samples aren't collected while fitting anyway
+    if (!_sem.take_nonblocking()) {
+        return;
+    }
+
     if (_status == Status::WAITING_TO_START) {
         set_status(Status::RUNNING_STEP_ONE);
     }
@@ -192,10 +204,14 @@ void CompassCalibrator::new_sample(const Vector3f& sample)
         _sample_buffer[_samples_collected].att.set_from_ahrs();
         _samples_collected++;
     }
+
+    _sem.give();
 }
 
 void CompassCalibrator::update(bool &failure)
 {
+    WITH_SEMAPHORE(_sem);
+
     failure = false;
 
     // collect the minimum number of samples
@@ -489,6 +505,34 @@ float CompassCalibrator::calc_mean_squared_residuals(const param_t& params) cons
     return sum;
 }
 
+// calc the fitness of two sets of parameters, decoding each sample once
+void CompassCalibrator::calc_mean_squared_residuals(const param_t& params1, const param_t& params2, float &fitness1, float &fitness2) const
+{
+    if (_sample_buffer == nullptr || _samples_collected == 0) {
+        fitness1 = fitness2 = 1.0e30f;
+        return;
+    }
+    const Matrix3f softiron1 {
+        params1.diag.x    , params1.offdiag.x , params1.offdiag.y,
+        params1.offdiag.x , params1.diag.y    , params1.offdiag.z,
+        params1.offdiag.y , params1.offdiag.z , params1.diag.z
+    };
+    const Matrix3f softiron2 {
+        params2.diag.x    , params2.offdiag.x , params2.offdiag.y,
+        params2.offdiag.x , params2.diag.y    , params2.offdiag.z,
+        params2.offdiag.y , params2.offdiag.z , params2.diag.z
+    };
+    float sum1 = 0.0f;
+    float sum2 = 0.0f;
+    for (uint16_t i=0; i < _samples_collected; i++) {
+        const Vector3f sample = _sample_buffer[i].get();
+        sum1 += sq(params1.radius - (softiron1*(sample+params1.offset)).length());
+        sum2 += sq(params2.radius - (softiron2*(sample+params2.offset)).length());
+    }
+    fitness1 = sum1 / _samples_collected;
+    fitness2 = sum2 / _samples_collected;
+}
+
 // calculate initial offsets by simply taking the average values of the samples
 void CompassCalibrator::calc_initial_offset()
 {
@@ -539,55 +583,55 @@ void CompassCalibrator::run_sphere_fit()
     param_t fit1_params, fit2_params;
     fit1_params = fit2_params = _params;
 
-    float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
+    MatrixN<float,COMPASS_CAL_NUM_SPHERE_PARAMS> JTJ;
+    VectorN<float,COMPASS_CAL_NUM_SPHERE_PARAMS> JTFI;
 
     // Gauss Newton Part common for all kind of extensions including LM
+    // JTJ is symmetric so only its lower triangle is accumulated
     for (uint16_t k = 0; k<_samples_collected; k++) {
         Vector3f sample = _sample_buffer[k].get();
 
         float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
 
         calc_sphere_jacob(sample, fit1_params, sphere_jacob);
+        const float residual = calc_residual(sample, fit1_params);
 
         for (uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
             // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
+            for (uint8_t j = 0; j <= i; j++) {
+                JTJ[i][j] += sphere_jacob[i] * sphere_jacob[j];
             }
             // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += sphere_jacob[i] * residual;
         }
     }
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
+    MatrixN<float,COMPASS_CAL_NUM_SPHERE_PARAMS> JTJ2 = JTJ;
     for (uint8_t i = 0; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-        JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda;
-        JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda/lma_damping;
+        JTJ[i][i] += _sphere_lambda;
+        JTJ2[i][i] += _sphere_lambda/lma_damping;
     }
 
-    if (!inverse(JTJ, JTJ, 4)) {
+    VectorN<float,COMPASS_CAL_NUM_SPHERE_PARAMS> delta1;
+    VectorN<float,COMPASS_CAL_NUM_SPHERE_PARAMS> delta2;
+    if (!JTJ.cholesky_solve(JTFI, delta1)) {
         return;
     }
 
-    if (!inverse(JTJ2, JTJ2, 4)) {
+    if (!JTJ2.cholesky_solve(JTFI, delta2)) {
         return;
     }
 
     // extract radius, offset, diagonals and offdiagonal parameters
     for (uint8_t row=0; row < COMPASS_CAL_NUM_SPHERE_PARAMS; row++) {
-        for (uint8_t col=0; col < COMPASS_CAL_NUM_SPHERE_PARAMS; col++) {
-            fit1_params.get_sphere_params()[row] -= JTFI[col] * JTJ[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col];
-            fit2_params.get_sphere_params()[row] -= JTFI[col] * JTJ2[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col];
-        }
+        fit1_params.get_sphere_params()[row] -= delta1[row];
+        fit2_params.get_sphere_params()[row] -= delta2[row];
     }
 
     // calculate fitness of two possible sets of parameters
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+    calc_mean_squared_residuals(fit1_params, fit2_params, fit1, fit2);
 
     // decide which of the two sets of parameters is best and store in fit1_params
     if (fit1 > _fitness && fit2 > _fitness) {
@@ -655,55 +699,55 @@ void CompassCalibrator::run_ellipsoid_fit()
     param_t fit1_params, fit2_params;
     fit1_params = fit2_params = _params;
 
-    float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
+    MatrixN<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS> JTJ;
+    VectorN<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS> JTFI;
 
     // Gauss Newton Part common for all kind of extensions including LM
+    // JTJ is symmetric so only its lower triangle is accumulated
     for (uint16_t k = 0; k<_samples_collected; k++) {
         Vector3f sample = _sample_buffer[k].get();
 
         float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
 
         calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
+        const float residual = calc_residual(sample, fit1_params);
 
         for (uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
             // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
+            for (uint8_t j = 0; j <= i; j++) {
+                JTJ[i][j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
             }
             // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += ellipsoid_jacob[i] * residual;
         }
     }
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
-    //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
+    // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
+    MatrixN<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS> JTJ2 = JTJ;
     for (uint8_t i = 0; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-        JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda;
-        JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda/lma_damping;
+        JTJ[i][i] += _ellipsoid_lambda;
+        JTJ2[i][i] += _ellipsoid_lambda/lma_damping;
     }
 
-    if (!inverse(JTJ, JTJ, 9)) {
+    VectorN<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS> delta1;
+    VectorN<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS> delta2;
+    if (!JTJ.cholesky_solve(JTFI, delta1)) {
         return;
     }
 
-    if (!inverse(JTJ2, JTJ2, 9)) {
+    if (!JTJ2.cholesky_solve(JTFI, delta2)) {
         return;
     }
 
     // extract radius, offset, diagonals and offdiagonal parameters
     for (uint8_t row=0; row < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; row++) {
-        for (uint8_t col=0; col < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; col++) {
-            fit1_params.get_ellipsoid_params()[row] -= JTFI[col] * JTJ[row*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+col];
-            fit2_params.get_ellipsoid_params()[row] -= JTFI[col] * JTJ2[row*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+col];
-        }
+        fit1_params.get_ellipsoid_params()[row] -= delta1[row];
+        fit2_params.get_ellipsoid_params()[row] -= delta2[row];
     }
 
     // calculate fitness of two possible sets of parameters
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+    calc_mean_squared_residuals(fit1_params, fit2_params, fit1, fit2);
 
     // decide which of the two sets of parameters is best and store in fit1_params
     if (fit1 > _fitness && fit2 > _fitness) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 
 #define COMPASS_CAL_NUM_SPHERE_PARAMS       4
@@ -16,6 +17,10 @@ public:
     // set tolerance of calibration (aka fitness)
     void set_tolerance(float tolerance) { _tolerance = tolerance; }
 
+    // All methods may be called from the main thread while update()
+    // and check_for_timeout() run as a LOW priority ComputePool task
+    // submitted by Compass::cal_update()
+
     // set compass's initial orientation and whether it should be automatically fixed (if required)
     void set_orientation(enum Rotation orientation, bool is_external, bool fix_orientation);
 
@@ -25,6 +30,9 @@ public:
 
     // update the state machine and calculate offsets, diagonals and offdiagonals
     void update(bool &failure);
+
+    // add a sample. Samples arriving while a fit step is running are
+    // dropped, no samples are collected while fitting
     void new_sample(const Vector3f &sample);
 
     bool check_for_timeout();
@@ -32,6 +40,9 @@ public:
     // running is true if actively calculating offsets, diagonals or offdiagonals
     bool running() const;
 
+    // true if enough samples have been collected and fitting has begun (aka runniong())
+    bool fitting() const;
+
     // compass calibration states
     enum class Status {
         NOT_STARTED = 0,
@@ -125,9 +136,6 @@ private:
     // initialize fitness before starting a fit
     void initialize_fit();
 
-    // true if enough samples have been collected and fitting has begun (aka runniong())
-    bool fitting() const;
-
     // thins out samples between step one and step two
     void thin_samples();
 
@@ -138,6 +146,9 @@ private:
     // returns 1.0e30f if the sample buffer is empty
     float calc_mean_squared_residuals(const param_t& params) const;
 
+    // calc the fitness of two sets of parameters in one pass over the samples
+    void calc_mean_squared_residuals(const param_t& params1, const param_t& params2, float &fitness1, float &fitness2) const;
+
     // calculate initial offsets by simply taking the average values of the samples
     void calc_initial_offset();
 
@@ -162,6 +173,10 @@ private:
     // fix radius to compensate for sensor scaling errors
     bool fix_radius();
 
+    // protects all state below against the fit step running as a
+    // ComputePool task
+    HAL_Semaphore _sem;
+
     uint8_t _compass_idx;                   // index of the compass providing data
     Status _status;                         // current state of calibrator
     uint32_t _last_sample_ms;               // system time of last sample received for timeout
@@ -0,0 +1,154 @@
+//
+// Benchmark of the compass calibration fits. Samples from compasses
+// with known offsets and soft iron errors are fed to one and then
+// three calibrators, and the cost of each fit step and the time taken
+// for all the calibrators to converge are printed. Fit steps are run
+// round robin over the calibrators, as Compass::cal_update() does.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_AHRS/AP_AHRS_DCM.h>
+#include <AP_Compass/CompassCalibrator.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+const struct AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+static AP_AHRS_DCM ahrs{};
+static GCS_Dummy _gcs;
+
+static const uint8_t max_compasses = 3;
+static CompassCalibrator calibrator[max_compasses];
+
+// field and errors of each simulated compass
+static const struct {
+    float radius;
+    Vector3f offset;
+    Vector3f diag;
+    Vector3f offdiag;
+} compass_model[max_compasses] = {
+    { 420, Vector3f(  80, -120,  40), Vector3f(1.00f, 1.00f, 1.00f), Vector3f( 0.00f, 0.00f,  0.00f) },
+    { 380, Vector3f(-150,   60, 210), Vector3f(1.05f, 0.95f, 1.02f), Vector3f( 0.03f, -0.02f, 0.01f) },
+    { 460, Vector3f(  30,  250, -90), Vector3f(0.92f, 1.08f, 0.97f), Vector3f(-0.04f, 0.02f,  0.05f) },
+};
+
+// random number between -1 and 1
+static float random_float(void)
+{
+    return get_random16() * (2.0f / UINT16_MAX) - 1.0f;
+}
+
+// a sample in a random direction as it would be read from a compass
+static Vector3f make_sample(uint8_t i)
+{
+    Vector3f dir(random_float(), random_float(), random_float());
+    if (dir.is_zero()) {
+        dir.x = 1;
+    }
+    dir.normalize();
+    Matrix3f softiron {
+        compass_model[i].diag.x,    compass_model[i].offdiag.x, compass_model[i].offdiag.y,
+        compass_model[i].offdiag.x, compass_model[i].diag.y,    compass_model[i].offdiag.z,
+        compass_model[i].offdiag.y, compass_model[i].offdiag.z, compass_model[i].diag.z
+    };
+    // the calibrator finds the matrix that maps a sample onto the sphere
+    UNUSED_RESULT(softiron.invert());
+    const Vector3f noise(random_float(), random_float(), random_float());
+    return softiron * (dir * compass_model[i].radius) - compass_model[i].offset + noise * 2.0f;
+}
+
+// feed samples to a calibrator until it has enough to fit. Sample
+// collection isn't timed, it is limited by how fast the vehicle is
+// rotated
+static bool collect_samples(uint8_t i)
+{
+    for (uint16_t n = 0; n < 20000 && !calibrator[i].fitting(); n++) {
+        calibrator[i].new_sample(make_sample(i));
+    }
+    return calibrator[i].fitting();
+}
+
+static void run_calibration(uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        calibrator[i].start(false, 0, 1000, i);
+    }
+
+    uint16_t steps = 0;
+    uint32_t max_step_us = 0;
+    uint64_t fit_us = 0;
+    bool running = true;
+    while (running) {
+        running = false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!calibrator[i].running()) {
+                continue;
+            }
+            running = true;
+            // more samples are needed after the sample buffer is thinned
+            if (!collect_samples(i)) {
+                calibrator[i].stop();
+                continue;
+            }
+            bool failure;
+            const uint64_t start_us = AP_HAL::micros64();
+            calibrator[i].update(failure);
+            const uint32_t step_us = AP_HAL::micros64() - start_us;
+            fit_us += step_us;
+            max_step_us = MAX(max_step_us, step_us);
+            steps++;
+        }
+    }
+
+    float offset_error = 0;
+    uint8_t succeeded = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (calibrator[i].get_status() != CompassCalibrator::Status::SUCCESS) {
+            continue;
+        }
+        Vector3f offsets, diagonals, offdiagonals;
+        float scale_factor;
+        calibrator[i].get_calibration(offsets, diagonals, offdiagonals, scale_factor);
+        offset_error = MAX(offset_error, (offsets - compass_model[i].offset).length());
+        succeeded++;
+    }
+
+    hal.console->printf("%u compass: %u steps, step %.1f us mean %u us max, converged in %.2f ms, %u/%u ok, offset error %.1f\n",
+                        (unsigned)count,
+                        (unsigned)steps,
+                        (double)(fit_us / float(MAX(steps, 1U))),
+                        (unsigned)max_step_us,
+                        (double)(fit_us * 1.0e-3f),
+                        (unsigned)succeeded,
+                        (unsigned)count,
+                        (double)offset_error);
+
+    for (uint8_t i = 0; i < count; i++) {
+        calibrator[i].stop();
+    }
+}
+
+void setup(void)
+{
+    hal.console->printf("Compass calibration benchmark\n");
+    ahrs.init();
+    for (uint8_t i = 0; i < max_compasses; i++) {
+        calibrator[i].set_tolerance(5.0f);
+    }
+}
+
+void loop(void)
+{
+    run_calibration(1);
+    run_calibration(max_compasses);
+    hal.scheduler->delay(1000);
+}
+
+AP_HAL_MAIN();
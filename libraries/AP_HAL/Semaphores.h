@@ -21,6 +21,25 @@ public:
     virtual ~Semaphore(void) {}
 };
 
+/*
+  a binary semaphore for a thread to sleep on until another thread
+  signals it. A signal given while no thread is waiting is kept until
+  the next wait, so a signal given between checking for work and
+  waiting is not lost
+ */
+class AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore(bool initial_state=false) {}
+
+    // wait for a signal for up to timeout_us, returns false on timeout
+    virtual bool wait(uint32_t timeout_us) WARN_IF_UNUSED = 0;
+    virtual bool wait_blocking(void) = 0;
+
+    virtual void signal(void) = 0;
+
+    virtual ~BinarySemaphore(void) {}
+};
+
 /*
   a method to make semaphores less error prone. The WITH_SEMAPHORE()
   macro will block forever for a semaphore, and will automatically
@@ -59,6 +59,7 @@
 // allow for static semaphores
 #include <AP_HAL_ChibiOS/Semaphores.h>
 #define HAL_Semaphore ChibiOS::Semaphore
+#define HAL_BinarySemaphore ChibiOS::BinarySemaphore
 
 /* string names for well known SPI devices */
 #define HAL_BARO_MS5611_NAME "ms5611"
@@ -347,4 +347,10 @@
 
 #include <AP_HAL_Linux/Semaphores.h>
 #define HAL_Semaphore Linux::Semaphore
+#define HAL_BinarySemaphore Linux::BinarySemaphore
+
+// workers for background computation, see AP_HAL/utility/ComputePool.h
+#ifndef HAL_COMPUTE_POOL_MAX_WORKERS
+#define HAL_COMPUTE_POOL_MAX_WORKERS 4
+#endif
 
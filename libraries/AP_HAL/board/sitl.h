@@ -26,6 +26,12 @@
 // allow for static semaphores
 #include <AP_HAL_SITL/Semaphores.h>
 #define HAL_Semaphore HALSITL::Semaphore
+#define HAL_BinarySemaphore HALSITL::BinarySemaphore
+
+// workers for background computation, see AP_HAL/utility/ComputePool.h
+#ifndef HAL_COMPUTE_POOL_MAX_WORKERS
+#define HAL_COMPUTE_POOL_MAX_WORKERS 4
+#endif
 
 #ifndef HAL_BOARD_STORAGE_DIRECTORY
 #define HAL_BOARD_STORAGE_DIRECTORY "."
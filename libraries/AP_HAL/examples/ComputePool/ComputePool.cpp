@@ -0,0 +1,101 @@
+//
+// Benchmark of the compute pool. A batch of CPU bound jobs is run
+// on the main thread and then spread over the pool, and the time
+// taken each way is printed. A long running task is then cancelled.
+//
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/ComputePool.h>
+
+void setup();
+void loop();
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t num_jobs = 8;
+
+class Jobs {
+public:
+    // count the primes below a limit, slowly
+    void count_primes(uint32_t id) {
+        uint32_t count = 0;
+        for (uint32_t n = 2; n < 20000; n++) {
+            bool prime = true;
+            for (uint32_t d = 2; d * d <= n; d++) {
+                if (n % d == 0) {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime) {
+                count++;
+            }
+        }
+        primes = count;
+    }
+
+    void wait_for_cancel(uint32_t id) {
+        while (!AP::compute_pool().cancel_requested(id)) {
+            hal.scheduler->delay(1);
+        }
+        cancelled = true;
+    }
+
+    volatile uint32_t primes;
+    volatile bool cancelled;
+};
+
+static Jobs jobs;
+
+void setup(void)
+{
+    hal.console->printf("ComputePool benchmark\n");
+}
+
+void loop(void)
+{
+    ComputePool &pool = AP::compute_pool();
+
+    uint32_t start_us = AP_HAL::micros();
+    for (uint8_t i = 0; i < num_jobs; i++) {
+        jobs.count_primes(0);
+    }
+    const uint32_t serial_us = AP_HAL::micros() - start_us;
+
+    start_us = AP_HAL::micros();
+    uint32_t ids[num_jobs];
+    for (uint8_t i = 0; i < num_jobs; i++) {
+        ids[i] = pool.submit(FUNCTOR_BIND(&jobs, &Jobs::count_primes, void, uint32_t));
+        if (ids[i] == 0) {
+            jobs.count_primes(0);
+        }
+    }
+    for (uint8_t i = 0; i < num_jobs; i++) {
+        while (!pool.done(ids[i])) {
+            hal.scheduler->delay_microseconds(100);
+        }
+    }
+    const uint32_t pool_us = AP_HAL::micros() - start_us;
+
+    hal.console->printf("%u jobs: %u us serial, %u us on %u workers, %u primes\n",
+                        (unsigned)num_jobs,
+                        (unsigned)serial_us,
+                        (unsigned)pool_us,
+                        (unsigned)pool.num_workers(),
+                        (unsigned)jobs.primes);
+
+    jobs.cancelled = false;
+    const uint32_t id = pool.submit(FUNCTOR_BIND(&jobs, &Jobs::wait_for_cancel, void, uint32_t),
+                                    ComputePool::Priority::LOW);
+    hal.scheduler->delay(10);
+    pool.cancel(id);
+    while (!pool.done(id)) {
+        hal.scheduler->delay(1);
+    }
+    hal.console->printf("long task %s\n", jobs.cancelled ? "cancelled" : "NOT cancelled");
+
+    hal.scheduler->delay(2000);
+}
+
+AP_HAL_MAIN();
@@ -0,0 +1,193 @@
+#include <AP_gtest.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/ComputePool.h>
+
+#include <atomic>
+#include <unistd.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+class PoolWork {
+public:
+    std::atomic<uint32_t> ran{0};
+    std::atomic<uint32_t> running{0};
+    std::atomic<uint32_t> order_idx{0};
+    uint32_t order[HAL_COMPUTE_POOL_MAX_TASKS];
+
+    // record the order tasks run in
+    void task(uint32_t id)
+    {
+        order[order_idx++ % HAL_COMPUTE_POOL_MAX_TASKS] = id;
+        ran++;
+    }
+
+    // occupy a worker until cancelled
+    void long_task(uint32_t id)
+    {
+        running++;
+        while (!AP::compute_pool().cancel_requested(id)) {
+            usleep(1000);
+        }
+        running--;
+    }
+
+    // occupy every worker, returning false on timeout
+    bool occupy_workers(uint32_t busy[])
+    {
+        ComputePool &pool = AP::compute_pool();
+        for (uint8_t i=0; i<pool.num_workers(); i++) {
+            busy[i] = pool.submit(FUNCTOR_BIND_MEMBER(&PoolWork::long_task, void, uint32_t));
+            if (busy[i] == 0) {
+                return false;
+            }
+        }
+        for (uint16_t i=0; i<1000 && running != pool.num_workers(); i++) {
+            usleep(1000);
+        }
+        return running == pool.num_workers();
+    }
+};
+
+static bool wait_done(uint32_t id)
+{
+    for (uint16_t i=0; i<2000; i++) {
+        if (AP::compute_pool().done(id)) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+TEST(ComputePool, RunTasks)
+{
+    PoolWork work;
+    ComputePool &pool = AP::compute_pool();
+    uint32_t ids[HAL_COMPUTE_POOL_MAX_TASKS];
+    for (uint8_t i=0; i<HAL_COMPUTE_POOL_MAX_TASKS; i++) {
+        ids[i] = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t));
+        ASSERT_NE(ids[i], 0U);
+    }
+    EXPECT_GT(pool.num_workers(), 0);
+    for (uint8_t i=0; i<HAL_COMPUTE_POOL_MAX_TASKS; i++) {
+        EXPECT_TRUE(wait_done(ids[i]));
+    }
+    EXPECT_EQ(work.ran, HAL_COMPUTE_POOL_MAX_TASKS);
+}
+
+TEST(ComputePool, Full)
+{
+    PoolWork work;
+    ComputePool &pool = AP::compute_pool();
+    uint32_t busy[HAL_COMPUTE_POOL_MAX_WORKERS];
+    ASSERT_TRUE(work.occupy_workers(busy));
+    uint32_t ids[HAL_COMPUTE_POOL_MAX_TASKS] {};
+    uint8_t accepted = 0;
+    for (uint8_t i=0; i<HAL_COMPUTE_POOL_MAX_TASKS; i++) {
+        ids[i] = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t));
+        if (ids[i] != 0) {
+            accepted++;
+        }
+    }
+    // each running task holds a slot
+    EXPECT_EQ(accepted, HAL_COMPUTE_POOL_MAX_TASKS - pool.num_workers());
+    for (uint8_t i=0; i<pool.num_workers(); i++) {
+        pool.cancel(busy[i]);
+    }
+    for (uint8_t i=0; i<HAL_COMPUTE_POOL_MAX_TASKS; i++) {
+        EXPECT_TRUE(wait_done(ids[i]));
+    }
+    EXPECT_EQ(work.ran, accepted);
+}
+
+TEST(ComputePool, Priority)
+{
+    PoolWork work;
+    ComputePool &pool = AP::compute_pool();
+    uint32_t busy[HAL_COMPUTE_POOL_MAX_WORKERS];
+    ASSERT_TRUE(work.occupy_workers(busy));
+
+    const uint32_t low = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t), ComputePool::Priority::LOW);
+    const uint32_t normal = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t), ComputePool::Priority::NORMAL);
+    const uint32_t high = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t), ComputePool::Priority::HIGH);
+
+    // free a single worker, which must take the tasks in priority order
+    pool.cancel(busy[0]);
+    EXPECT_TRUE(wait_done(low));
+    EXPECT_TRUE(wait_done(normal));
+    EXPECT_TRUE(wait_done(high));
+    ASSERT_EQ(work.ran, 3U);
+    EXPECT_EQ(work.order[0], high);
+    EXPECT_EQ(work.order[1], normal);
+    EXPECT_EQ(work.order[2], low);
+
+    for (uint8_t i=1; i<pool.num_workers(); i++) {
+        pool.cancel(busy[i]);
+        EXPECT_TRUE(wait_done(busy[i]));
+    }
+}
+
+TEST(ComputePool, Cancel)
+{
+    PoolWork work;
+    ComputePool &pool = AP::compute_pool();
+    uint32_t busy[HAL_COMPUTE_POOL_MAX_WORKERS];
+    ASSERT_TRUE(work.occupy_workers(busy));
+
+    // a pending task is cancelled outright and never runs
+    const uint32_t pending = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t));
+    ASSERT_NE(pending, 0U);
+    EXPECT_FALSE(pool.done(pending));
+    EXPECT_TRUE(pool.cancel(pending));
+    EXPECT_TRUE(pool.done(pending));
+
+    // a running task is only asked to stop
+    EXPECT_FALSE(pool.cancel_requested(busy[0]));
+    EXPECT_FALSE(pool.cancel(busy[0]));
+    EXPECT_TRUE(pool.cancel_requested(busy[0]));
+    EXPECT_TRUE(wait_done(busy[0]));
+
+    for (uint8_t i=1; i<pool.num_workers(); i++) {
+        pool.cancel(busy[i]);
+        EXPECT_TRUE(wait_done(busy[i]));
+    }
+    EXPECT_EQ(work.running, 0U);
+    EXPECT_EQ(work.ran, 0U);
+
+    // unknown ids are done
+    EXPECT_TRUE(pool.done(0));
+    EXPECT_FALSE(pool.cancel(0));
+}
+
+TEST(ComputePool, Stealing)
+{
+    PoolWork work;
+    ComputePool &pool = AP::compute_pool();
+    if (pool.num_workers() < 2) {
+        // nothing to steal from with a single worker
+        return;
+    }
+    uint32_t busy[HAL_COMPUTE_POOL_MAX_WORKERS];
+    ASSERT_TRUE(work.occupy_workers(busy));
+    for (uint8_t i=1; i<pool.num_workers(); i++) {
+        pool.cancel(busy[i]);
+        EXPECT_TRUE(wait_done(busy[i]));
+    }
+
+    // tasks are spread over all the workers, so those queued on the
+    // busy worker only finish if another worker steals them
+    uint32_t ids[HAL_COMPUTE_POOL_MAX_WORKERS * 2];
+    for (uint8_t i=0; i<pool.num_workers() * 2; i++) {
+        ids[i] = pool.submit(FUNCTOR_BIND(&work, &PoolWork::task, void, uint32_t));
+        ASSERT_NE(ids[i], 0U);
+    }
+    for (uint8_t i=0; i<pool.num_workers() * 2; i++) {
+        EXPECT_TRUE(wait_done(ids[i]));
+    }
+    EXPECT_EQ(work.running, 1U);
+
+    pool.cancel(busy[0]);
+    EXPECT_TRUE(wait_done(busy[0]));
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,227 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ComputePool.h"
+
+extern const AP_HAL::HAL& hal;
+
+static ComputePool compute_pool_instance;
+
+ComputePool *ComputePool::get_singleton(void)
+{
+    return &compute_pool_instance;
+}
+
+/*
+  create the workers, called with _sem held. Returns false if there
+  are no workers to run tasks
+ */
+bool ComputePool::init(void)
+{
+    if (_init_done) {
+        return _num_workers > 0;
+    }
+    _init_done = true;
+
+    while (_num_workers < HAL_COMPUTE_POOL_MAX_WORKERS) {
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&ComputePool::worker_thread, void),
+                                          "compute",
+                                          HAL_COMPUTE_POOL_STACK_SIZE, AP_HAL::Scheduler::PRIORITY_IO, -1)) {
+            break;
+        }
+        _num_workers++;
+    }
+    return _num_workers > 0;
+}
+
+uint32_t ComputePool::submit(TaskProc proc, Priority priority)
+{
+    uint8_t slot = slot_none;
+    uint32_t id;
+    uint8_t widx;
+    {
+        WITH_SEMAPHORE(_sem);
+        if (!init()) {
+            return 0;
+        }
+        for (uint8_t i = 0; i < HAL_COMPUTE_POOL_MAX_TASKS; i++) {
+            if (_tasks[i].state == State::FREE) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot == slot_none) {
+            return 0;
+        }
+        id = _next_id++;
+        if (_next_id == 0) {
+            _next_id = 1;
+        }
+        struct task &t = _tasks[slot];
+        t.proc = proc;
+        t.id = id;
+        t.state = State::PENDING;
+        t.cancel_requested = false;
+        widx = _next_worker++ % _num_workers;
+    }
+
+    struct worker &w = _workers[widx];
+    {
+        WITH_SEMAPHORE(w.sem);
+        const uint8_t p = uint8_t(priority);
+        w.slots[p][(w.head[p] + w.count[p]) % HAL_COMPUTE_POOL_MAX_TASKS] = slot;
+        w.count[p]++;
+    }
+    wake_workers();
+    return id;
+}
+
+// find a task by id, called with _sem held
+struct ComputePool::task *ComputePool::find(uint32_t id)
+{
+    if (id == 0) {
+        return nullptr;
+    }
+    for (uint8_t i = 0; i < HAL_COMPUTE_POOL_MAX_TASKS; i++) {
+        if (_tasks[i].id == id && _tasks[i].state != State::FREE) {
+            return &_tasks[i];
+        }
+    }
+    return nullptr;
+}
+
+bool ComputePool::cancel(uint32_t id)
+{
+    WITH_SEMAPHORE(_sem);
+    struct task *t = find(id);
+    if (t == nullptr) {
+        return false;
+    }
+    switch (t->state) {
+    case State::PENDING:
+        // the slot is freed when a worker takes it from the queue
+        t->state = State::CANCELLED;
+        return true;
+    case State::CANCELLED:
+        return true;
+    case State::RUNNING:
+        t->cancel_requested = true;
+        break;
+    case State::FREE:
+        break;
+    }
+    return false;
+}
+
+bool ComputePool::cancel_requested(uint32_t id)
+{
+    WITH_SEMAPHORE(_sem);
+    const struct task *t = find(id);
+    return t != nullptr && t->cancel_requested;
+}
+
+bool ComputePool::done(uint32_t id)
+{
+    WITH_SEMAPHORE(_sem);
+    const struct task *t = find(id);
+    return t == nullptr || t->state == State::CANCELLED;
+}
+
+uint8_t ComputePool::pop(worker &w, uint8_t priority, bool own)
+{
+    WITH_SEMAPHORE(w.sem);
+    if (w.count[priority] == 0) {
+        return slot_none;
+    }
+    uint8_t idx;
+    if (own) {
+        idx = (w.head[priority] + w.count[priority] - 1) % HAL_COMPUTE_POOL_MAX_TASKS;
+    } else {
+        idx = w.head[priority];
+        w.head[priority] = (w.head[priority] + 1) % HAL_COMPUTE_POOL_MAX_TASKS;
+    }
+    w.count[priority]--;
+    return w.slots[priority][idx];
+}
+
+/*
+  find the next task for a worker and mark it running
+ */
+uint8_t ComputePool::next_task(uint8_t worker_idx)
+{
+    for (uint8_t p = 0; p < num_priorities; p++) {
+        for (uint8_t i = 0; i < _num_workers; i++) {
+            const uint8_t widx = (worker_idx + i) % _num_workers;
+            uint8_t slot;
+            while ((slot = pop(_workers[widx], p, i == 0)) != slot_none) {
+                WITH_SEMAPHORE(_sem);
+                struct task &t = _tasks[slot];
+                if (t.state == State::CANCELLED) {
+                    t.state = State::FREE;
+                    continue;
+                }
+                t.state = State::RUNNING;
+                return slot;
+            }
+        }
+    }
+    return slot_none;
+}
+
+void ComputePool::worker_thread(void)
+{
+    uint8_t worker_idx;
+    {
+        WITH_SEMAPHORE(_sem);
+        worker_idx = _worker_ids++;
+    }
+
+    while (true) {
+        const uint8_t slot = next_task(worker_idx);
+        if (slot == slot_none) {
+            // a task submitted after next_task() looked has already
+            // signalled the semaphore, so the wait ends at once
+            _workers[worker_idx].wake.wait_blocking();
+            continue;
+        }
+
+        struct task &t = _tasks[slot];
+        t.proc(t.id);
+
+        WITH_SEMAPHORE(_sem);
+        t.state = State::FREE;
+        t.cancel_requested = false;
+    }
+}
+
+/*
+  wake every worker, as any idle worker can take the task from the
+  queue it was added to
+ */
+void ComputePool::wake_workers(void)
+{
+    for (uint8_t i = 0; i < _num_workers; i++) {
+        _workers[i].wake.signal();
+    }
+}
+
+namespace AP {
+
+ComputePool &compute_pool()
+{
+    return *ComputePool::get_singleton();
+}
+
+};
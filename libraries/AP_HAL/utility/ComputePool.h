@@ -0,0 +1,136 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  a pool of worker threads for running background computation off
+  the main thread, shared between libraries instead of each creating
+  its own thread
+
+  Each worker has its own queue of tasks per priority. Submitted tasks
+  are spread across the workers, a worker runs the newest task in its
+  own queue and when that is empty takes the oldest task from another
+  worker's queue. Higher priority tasks are always run first.
+
+  Boards set HAL_COMPUTE_POOL_MAX_WORKERS, defaulting to a single
+  worker. Idle workers sleep on a HAL_BinarySemaphore signalled by
+  submit(). Workers are created when the first task is submitted.
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/functor.h>
+
+#ifndef HAL_COMPUTE_POOL_MAX_WORKERS
+#define HAL_COMPUTE_POOL_MAX_WORKERS 1
+#endif
+
+#ifndef HAL_COMPUTE_POOL_MAX_TASKS
+#define HAL_COMPUTE_POOL_MAX_TASKS 16
+#endif
+
+#ifndef HAL_COMPUTE_POOL_STACK_SIZE
+#define HAL_COMPUTE_POOL_STACK_SIZE 4096
+#endif
+
+class ComputePool {
+public:
+    // a task is passed its own id, for use with cancel_requested()
+    FUNCTOR_TYPEDEF(TaskProc, void, uint32_t);
+
+    enum class Priority : uint8_t {
+        HIGH = 0,
+        NORMAL = 1,
+        LOW = 2,
+    };
+
+    ComputePool() {}
+
+    /* Do not allow copies */
+    ComputePool(const ComputePool &other) = delete;
+    ComputePool &operator=(const ComputePool&) = delete;
+
+    // queue a task, returning its id. Returns 0 if the task can't be
+    // queued, either because the pool is full or no worker could be
+    // created, and the caller should run the work itself
+    uint32_t submit(TaskProc proc, Priority priority = Priority::NORMAL);
+
+    // cancel a task. Returns true if the task had not started and
+    // will not run. A running task is asked to stop and can check
+    // cancel_requested()
+    bool cancel(uint32_t id);
+
+    // true if cancel() has been called for a running task
+    bool cancel_requested(uint32_t id);
+
+    // true once a task has finished or been cancelled
+    bool done(uint32_t id);
+
+    // number of workers running tasks
+    uint8_t num_workers(void) const { return _num_workers; }
+
+    static ComputePool *get_singleton(void);
+
+private:
+    static const uint8_t num_priorities = 3;
+    static const uint8_t slot_none = UINT8_MAX;
+
+    enum class State : uint8_t {
+        FREE,
+        PENDING,
+        RUNNING,
+        CANCELLED,
+    };
+
+    struct task {
+        TaskProc proc;
+        uint32_t id;
+        State state;
+        bool cancel_requested;
+    } _tasks[HAL_COMPUTE_POOL_MAX_TASKS];
+
+    // queue of task slots for each priority, a slot can only be in
+    // one queue so the queues can't overflow
+    struct worker {
+        HAL_Semaphore sem;
+        uint8_t slots[num_priorities][HAL_COMPUTE_POOL_MAX_TASKS];
+        uint8_t head[num_priorities];
+        uint8_t count[num_priorities];
+        // signalled when a task is submitted
+        HAL_BinarySemaphore wake;
+    } _workers[HAL_COMPUTE_POOL_MAX_WORKERS];
+
+    // protects _tasks
+    HAL_Semaphore _sem;
+
+    uint32_t _next_id = 1;
+    uint8_t _num_workers;
+    uint8_t _worker_ids;
+    uint8_t _next_worker;
+    bool _init_done;
+
+    bool init(void);
+    void worker_thread(void);
+    void wake_workers(void);
+
+    // take the newest task from a worker's own queue or the oldest
+    // from another's. Returns slot_none if there is no task
+    uint8_t pop(worker &w, uint8_t priority, bool own);
+    uint8_t next_task(uint8_t worker_idx);
+
+    struct task *find(uint32_t id);
+};
+
+namespace AP {
+    ComputePool &compute_pool();
+};
@@ -77,3 +77,40 @@ void Semaphore::assert_owner(void)
 }
 
 #endif // CH_CFG_USE_MUTEXES
+
+#if CH_CFG_USE_SEMAPHORES == TRUE
+
+using namespace ChibiOS;
+
+BinarySemaphore::BinarySemaphore(bool initial_state) :
+    AP_HAL::BinarySemaphore(initial_state)
+{
+    static_assert(sizeof(_sem) >= sizeof(binary_semaphore_t), "invalid binary semaphore size");
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    chBSemObjectInit(sem, !initial_state);
+}
+
+bool BinarySemaphore::wait(uint32_t timeout_us)
+{
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    // a short timeout still waits for a tick
+    sysinterval_t ticks = chTimeUS2I(timeout_us);
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    return chBSemWaitTimeout(sem, ticks) == MSG_OK;
+}
+
+bool BinarySemaphore::wait_blocking(void)
+{
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    return chBSemWait(sem) == MSG_OK;
+}
+
+void BinarySemaphore::signal(void)
+{
+    binary_semaphore_t *sem = (binary_semaphore_t *)_sem;
+    chBSemSignal(sem);
+}
+
+#endif // CH_CFG_USE_SEMAPHORES
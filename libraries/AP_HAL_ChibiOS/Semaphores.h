@@ -37,3 +37,16 @@ protected:
     // we declare the lock as a uint32_t array, and cast inside the cpp file
     uint32_t _lock[5];
 };
+
+class ChibiOS::BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore(bool initial_state=false);
+
+    bool wait(uint32_t timeout_us) override;
+    bool wait_blocking(void) override;
+    void signal(void) override;
+
+protected:
+    // as for Semaphore, a binary_semaphore_t cast inside the cpp file
+    uint32_t _sem[4];
+};
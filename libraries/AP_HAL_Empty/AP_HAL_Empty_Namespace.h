@@ -13,6 +13,7 @@ namespace Empty {
     class RCOutput;
     class Scheduler;
     class Semaphore;
+    class BinarySemaphore;
     class SPIDevice;
     class SPIDeviceDriver;
     class SPIDeviceManager;
@@ -11,3 +11,16 @@ public:
 private:
     bool _taken;
 };
+
+class Empty::BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore(bool initial_state=false) :
+        AP_HAL::BinarySemaphore(initial_state),
+        _pending(initial_state) {}
+
+    bool wait(uint32_t timeout_us) override;
+    bool wait_blocking(void) override;
+    void signal(void) override;
+private:
+    bool _pending;
+};
@@ -111,6 +111,28 @@ int SPIUARTDriver::_write_fd(const uint8_t *buf, uint16_t size)
     return ret;
 }
 
+int SPIUARTDriver::_writev_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (_external) {
+        return UARTDriver::_writev_fd(vec, n_vec);
+    }
+
+    /* SPI transfers take a single buffer */
+    int total = 0;
+    for (uint8_t i = 0; i < n_vec; i++) {
+        const int ret = _write_fd(vec[i].data, (uint16_t)vec[i].len);
+        if (ret < 0) {
+            break;
+        }
+        total += ret;
+        if ((unsigned)ret != vec[i].len) {
+            break;
+        }
+    }
+
+    return total;
+}
+
 int SPIUARTDriver::_read_fd(uint8_t *buf, uint16_t n)
 {
     static uint8_t ff_stub[100] = {0xff};
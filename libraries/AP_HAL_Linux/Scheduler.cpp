@@ -142,6 +142,11 @@ void Scheduler::_debug_stack()
 
 void Scheduler::microsleep(uint32_t usec)
 {
+    if (_uart_wakeup_deferred && in_main_thread()) {
+        _uart_wakeup_deferred = false;
+        _uart_wakeup_now();
+    }
+
     struct timespec ts;
     ts.tv_sec = 0;
     ts.tv_nsec = usec*1000UL;
@@ -265,6 +270,57 @@ void Scheduler::_run_uarts()
     hal.uartH->_timer_tick();
 }
 
+/*
+  push out bytes written to UARTs since the UART thread last ran
+ */
+void Scheduler::_flush_uarts()
+{
+    AP_HAL::UARTDriver *uarts[] = {
+        hal.uartA, hal.uartB, hal.uartC, hal.uartD,
+        hal.uartE, hal.uartF, hal.uartG, hal.uartH,
+    };
+    for (uint8_t i = 0; i < ARRAY_SIZE(uarts); i++) {
+        if (uarts[i]->tx_pending()) {
+            uarts[i]->_timer_tick();
+        }
+    }
+}
+
+Poller *Scheduler::uart_poller()
+{
+    if (!_uart_thread._poller) {
+        return nullptr;
+    }
+    return &_uart_thread._poller;
+}
+
+/*
+  writes from the main thread are sent when it next sleeps, so all the
+  writes made in a loop share a single wakeup and device write
+ */
+void Scheduler::uart_wakeup()
+{
+    if (!_uart_thread._poller) {
+        return;
+    }
+    if (in_main_thread()) {
+        _uart_wakeup_deferred = true;
+        return;
+    }
+    _uart_wakeup_now();
+}
+
+/*
+  only the first wakeup after the UART thread last woke up costs a
+  system call, later ones are handled along with it
+ */
+void Scheduler::_uart_wakeup_now()
+{
+    if (!__atomic_exchange_n(&_uart_wakeup_pending, true, __ATOMIC_ACQ_REL)) {
+        _uart_thread._poller.wakeup();
+    }
+}
+
 void Scheduler::_rcin_task()
 {
     RCInput::from(hal.rcin)->_timer_tick();
@@ -328,6 +384,52 @@ bool Scheduler::SchedulerThread::_run()
     return PeriodicThread::_run();
 }
 
+bool Scheduler::UARTThread::_run()
+{
+    _sched._wait_all_threads();
+
+    if (!_poller) {
+        // no epoll, just tick the UARTs periodically
+        return PeriodicThread::_run();
+    }
+
+    const int timeout_ms = MAX((int)(_period_usec / 1000), 1);
+    uint64_t last_run_usec = 0;
+
+    while (!_should_exit) {
+        // UARTs with a registered file descriptor are ticked from
+        // their Pollable when they become ready
+        _poller.poll(timeout_ms);
+
+        // clear before ticking, so a write after this point wakes us again
+        __atomic_store_n(&_sched._uart_wakeup_pending, false, __ATOMIC_RELEASE);
+
+        const uint64_t now_usec = AP_HAL::micros64();
+        if (now_usec - last_run_usec >= _period_usec) {
+            last_run_usec = now_usec;
+            _task();
+        } else {
+            _sched._flush_uarts();
+        }
+    }
+
+    _started = false;
+    _should_exit = false;
+
+    return true;
+}
+
+bool Scheduler::UARTThread::stop()
+{
+    if (!SchedulerThread::stop()) {
+        return false;
+    }
+
+    _poller.wakeup();
+
+    return true;
+}
+
 void Scheduler::teardown()
 {
     _timer_thread.stop();
@@ -3,6 +3,7 @@
 #include <pthread.h>
 
 #include "AP_HAL_Linux.h"
+#include "Poller.h"
 #include "Semaphores.h"
 #include "Thread.h"
 
@@ -51,7 +52,20 @@ public:
       create a new thread
      */
     bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority) override;
-    
+
+    /*
+      poller of the UART thread, UARTs register their file descriptors
+      here to be serviced as soon as they are ready. Returns nullptr if
+      epoll isn't available
+     */
+    Poller *uart_poller();
+
+    /*
+      wake up the UART thread to send newly written bytes. Wakeups from
+      the main thread are deferred until it next sleeps
+     */
+    void uart_wakeup();
+
 private:
     class SchedulerThread : public PeriodicThread {
     public:
@@ -66,6 +80,25 @@ private:
         Scheduler &_sched;
     };
 
+    /*
+      the UART thread sleeps on a Poller until a UART is ready to read
+      or write, and still ticks all UARTs at its rate to service those
+      which can't be waited on
+     */
+    class UARTThread : public SchedulerThread {
+    public:
+        UARTThread(Thread::task_t t, Scheduler &sched)
+            : SchedulerThread(t, sched)
+        { }
+
+        bool stop() override;
+
+        Poller _poller{};
+
+    protected:
+        bool _run() override;
+    };
+
     void     init_realtime();
 
     void _wait_all_threads();
@@ -87,7 +120,7 @@ private:
     SchedulerThread _timer_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_timer_task, void), *this};
     SchedulerThread _io_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_io_task, void), *this};
     SchedulerThread _rcin_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_rcin_task, void), *this};
-    SchedulerThread _uart_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_uart_task, void), *this};
+    UARTThread _uart_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_uart_task, void), *this};
 
     void _timer_task();
     void _io_task();
@@ -96,6 +129,14 @@ private:
 
     void _run_io();
     void _run_uarts();
+    void _flush_uarts();
+
+    void _uart_wakeup_now();
+
+    // true from a wakeup until the UART thread next wakes
+    bool _uart_wakeup_pending;
+    // true if the main thread has written to a UART since it last slept
+    bool _uart_wakeup_deferred;
 
     uint64_t _stopped_clock_usec;
     uint64_t _last_stack_debug_msec;
@@ -2,6 +2,8 @@
 
 #include "Semaphores.h"
 
+#include <time.h>
+
 extern const AP_HAL::HAL& hal;
 
 using namespace Linux;
@@ -43,3 +45,60 @@ bool Semaphore::take_nonblocking()
     return pthread_mutex_trylock(&_lock) == 0;
 }
 
+/*
+  binary semaphore on a condition variable using the monotonic clock
+ */
+BinarySemaphore::BinarySemaphore(bool initial_state) :
+    AP_HAL::BinarySemaphore(initial_state),
+    _pending(initial_state)
+{
+    pthread_mutex_init(&_mtx, nullptr);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+bool BinarySemaphore::wait(uint32_t timeout_us)
+{
+    pthread_mutex_lock(&_mtx);
+    if (!_pending) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_sec += timeout_us / 1000000UL;
+        ts.tv_nsec += (timeout_us % 1000000UL) * 1000UL;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        while (!_pending) {
+            if (pthread_cond_timedwait(&_cond, &_mtx, &ts) != 0) {
+                break;
+            }
+        }
+    }
+    const bool ret = _pending;
+    _pending = false;
+    pthread_mutex_unlock(&_mtx);
+    return ret;
+}
+
+bool BinarySemaphore::wait_blocking(void)
+{
+    pthread_mutex_lock(&_mtx);
+    while (!_pending) {
+        pthread_cond_wait(&_cond, &_mtx);
+    }
+    _pending = false;
+    pthread_mutex_unlock(&_mtx);
+    return true;
+}
+
+void BinarySemaphore::signal(void)
+{
+    pthread_mutex_lock(&_mtx);
+    _pending = true;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mtx);
+}
@@ -3,16 +3,51 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <AP_HAL/utility/RingBuffer.h>
+
 #include "AP_HAL_Linux.h"
 
 class SerialDevice {
 public: 
+    SerialDevice() { fd_changed(); }
     virtual ~SerialDevice() {}
 
     virtual bool open() = 0;
     virtual bool close() = 0;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) = 0;
     virtual ssize_t read(uint8_t *buf, uint16_t n) = 0;
+
+    /* Write several buffers at once, devices backed by a file descriptor
+     * do this with a single writev() */
+    virtual ssize_t writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+    {
+        ssize_t total = 0;
+        for (uint8_t i = 0; i < n_vec; i++) {
+            const ssize_t ret = write(vec[i].data, (uint16_t)vec[i].len);
+            if (ret < 0) {
+                return total > 0 ? total : ret;
+            }
+            total += ret;
+            /* We wrote less than we asked for, stop */
+            if ((uint32_t)ret != vec[i].len) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    /* File descriptor which becomes readable when there is data to be
+     * read, or -1 if the device can't be waited on and must be polled */
+    virtual int get_fd() const { return -1; }
+
+    /* Changes whenever get_fd() starts referring to a different open
+     * file, so a descriptor number reused after a reconnect is noticed.
+     * Unique across devices */
+    uint32_t get_fd_generation() const { return _fd_generation; }
+
+    /* True if fd is open and belongs to this device. A closed
+     * descriptor's number may have been reused by another device */
+    virtual bool owns_fd(int fd) const { return fd >= 0 && fd == get_fd(); }
     virtual void set_blocking(bool blocking) = 0;
     virtual void set_speed(uint32_t speed) = 0;
     virtual AP_HAL::UARTDriver::flow_control get_flow_control(void) { return AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE; }
@@ -23,4 +58,16 @@ public:
 
     /* Depends on lower level to implement, most devices are fine with defaults */
     virtual void set_parity(int v) { }
+
+protected:
+    /* Called by devices when they open, close or replace the file
+     * descriptor returned by get_fd() */
+    void fd_changed()
+    {
+        static uint32_t counter;
+        _fd_generation = __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED);
+    }
+
+private:
+    uint32_t _fd_generation;
 };
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <libgen.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -16,6 +17,10 @@ using namespace Linux;
 /*
   This stores 'eeprom' data on the SD card, with a 4k size, and a
   in-memory buffer. This keeps the latency down.
+
+  Changes are coalesced and then written out by a dedicated thread as
+  a complete new file which is renamed over the old one, so that bulk
+  updates cost a single write and the file is never left half written.
  */
 
 // name the storage file after the sketch so you can use the same board
@@ -149,11 +154,14 @@ void Storage::init()
     }
 
     int fd = open(dpath, O_RDWR|O_CLOEXEC);
-    if (fd == -1) {
+    if (fd != -1) {
+        snprintf(_path, sizeof(_path), "%s", dpath);
+    } else {
         fd = _storage_create(dpath);
         if (fd == -1) {
             AP_HAL::panic("Cannot create storage %s (%m)", dpath);
         }
+        snprintf(_path, sizeof(_path), "%s/%s", dpath, STORAGE_FILE);
     }
 
     ssize_t ret = read(fd, _buffer, sizeof(_buffer));
@@ -170,28 +178,35 @@ void Storage::init()
         }
     }
 
-    _fd = fd;
+    // the file is replaced on each write so we don't keep it open
+    close(fd);
+
     _initialised = true;
 }
 
 /*
-  mark some lines as dirty. Note that there is no attempt to avoid
-  the race condition between this code and the _timer_tick() code
-  below, which both update _dirty_mask. If we lose the race then the
-  result is that a line is written more than once, but it won't result
-  in a line not being written.
+  mark some lines as dirty. This is called after the data has been
+  copied into _buffer, so if it races with a snapshot in _timer_tick()
+  the line is written again in the next snapshot.
  */
 void Storage::_mark_dirty(uint16_t loc, uint16_t length)
 {
     if (length == 0) {
         return;
     }
+    const uint32_t now_ms = AP_HAL::millis();
     uint16_t end = loc + length - 1;
+    pthread_mutex_lock(&_dirty_mtx);
+    if (_dirty_mask == 0) {
+        _first_dirty_ms = now_ms;
+    }
+    _last_dirty_ms = now_ms;
     for (uint8_t line=loc>>LINUX_STORAGE_LINE_SHIFT;
          line <= end>>LINUX_STORAGE_LINE_SHIFT;
          line++) {
         _dirty_mask |= 1U << line;
     }
+    pthread_mutex_unlock(&_dirty_mtx);
 }
 
 void Storage::read_block(void *dst, uint16_t loc, size_t n)
@@ -215,54 +230,133 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
     }
 }
 
+void Storage::_write_done(bool ok)
+{
+    pthread_mutex_lock(&_dirty_mtx);
+    if (ok) {
+        _retry_ms = 0;
+    } else {
+        // the whole file is rewritten, so marking any line dirty
+        // causes a retry. Back off so a full or read-only filesystem
+        // isn't retried on every tick
+        _dirty_mask |= 1U;
+        _failed_ms = AP_HAL::millis();
+        if (_retry_ms == 0) {
+            _retry_ms = LINUX_STORAGE_RETRY_MS;
+        } else if (_retry_ms < LINUX_STORAGE_MAX_RETRY_MS / 2) {
+            _retry_ms *= 2;
+        } else {
+            _retry_ms = LINUX_STORAGE_MAX_RETRY_MS;
+        }
+    }
+    pthread_mutex_unlock(&_dirty_mtx);
+}
+
 void Storage::_timer_tick(void)
 {
-    if (!_initialised || _dirty_mask == 0 || _fd == -1) {
+    if (!_initialised) {
         return;
     }
 
-    // write out the first dirty set of lines. We don't write more
-    // than one to keep the latency of this call to a minimum
-    uint8_t i, n;
-    for (i=0; i<LINUX_STORAGE_NUM_LINES; i++) {
-        if (_dirty_mask & (1<<i)) {
-            break;
-        }
-    }
-    if (i == LINUX_STORAGE_NUM_LINES) {
-        // this shouldn't be possible
+    // wait for changes to stop so bulk updates (e.g. parameter or
+    // mission uploads) are written together, but don't hold changes
+    // back for too long
+    const uint32_t now_ms = AP_HAL::millis();
+    pthread_mutex_lock(&_dirty_mtx);
+    const bool ready = _dirty_mask != 0 &&
+        (now_ms - _last_dirty_ms >= LINUX_STORAGE_COALESCE_MS ||
+         now_ms - _first_dirty_ms >= LINUX_STORAGE_MAX_DELAY_MS) &&
+        (_retry_ms == 0 || now_ms - _failed_ms >= _retry_ms);
+    pthread_mutex_unlock(&_dirty_mtx);
+    if (!ready) {
         return;
     }
-    uint32_t write_mask = (1U<<i);
-    // see how many lines to write
-    for (n=1; (i+n) < LINUX_STORAGE_NUM_LINES &&
-             n < (LINUX_STORAGE_MAX_WRITE>>LINUX_STORAGE_LINE_SHIFT); n++) {
-        if (!(_dirty_mask & (1<<(n+i)))) {
-            break;
-        }
-        // mark that line clean
-        write_mask |= (1<<(n+i));
+
+    if (!_thread_started) {
+        _thread_started = true;
+        _thread_ok = hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&Storage::_storage_thread, void),
+                                                  "storage", 4096, AP_HAL::Scheduler::PRIORITY_STORAGE, 0);
     }
 
     /*
-      write the lines. This also updates _dirty_mask. Note that
-      because this is a SCHED_FIFO thread it will not be preempted
-      by the main task except during blocking calls. This means we
-      don't need a semaphore around the _dirty_mask updates.
+      take the snapshot. _dirty_mask is cleared before the copy so a
+      write_block() racing with the copy marks its line dirty again and
+      is included in the next snapshot.
      */
-    if (lseek(_fd, i<<LINUX_STORAGE_LINE_SHIFT, SEEK_SET) == (i<<LINUX_STORAGE_LINE_SHIFT)) {
-        _dirty_mask &= ~write_mask;
-        if (write(_fd, &_buffer[i<<LINUX_STORAGE_LINE_SHIFT], n<<LINUX_STORAGE_LINE_SHIFT) != n<<LINUX_STORAGE_LINE_SHIFT) {
-            // write error - likely EINTR
-            _dirty_mask |= write_mask;
-            close(_fd);
-            _fd = -1;
-        }
-        if (_dirty_mask == 0) {
-            if (fsync(_fd) != 0) {
-                close(_fd);
-                _fd = -1;
-            }
+    if (!_thread_ok) {
+        // no storage thread, so write from this thread instead
+        pthread_mutex_lock(&_dirty_mtx);
+        _dirty_mask = 0;
+        pthread_mutex_unlock(&_dirty_mtx);
+        memcpy(_write_buffer, _buffer, sizeof(_write_buffer));
+        _write_done(_write_file(_write_buffer));
+        return;
+    }
+
+    // never block this thread waiting for the storage thread
+    if (pthread_mutex_trylock(&_write_mtx) != 0) {
+        return;
+    }
+    if (!_write_pending) {
+        pthread_mutex_lock(&_dirty_mtx);
+        _dirty_mask = 0;
+        pthread_mutex_unlock(&_dirty_mtx);
+        memcpy(_write_buffer, _buffer, sizeof(_write_buffer));
+        _write_pending = true;
+        pthread_cond_signal(&_write_cond);
+    }
+    pthread_mutex_unlock(&_write_mtx);
+}
+
+void Storage::_storage_thread(void)
+{
+    while (true) {
+        pthread_mutex_lock(&_write_mtx);
+        while (!_write_pending) {
+            pthread_cond_wait(&_write_cond, &_write_mtx);
         }
+        pthread_mutex_unlock(&_write_mtx);
+
+        // _write_buffer is not touched by _timer_tick while a write is pending
+        _write_done(_write_file(_write_buffer));
+
+        pthread_mutex_lock(&_write_mtx);
+        _write_pending = false;
+        pthread_mutex_unlock(&_write_mtx);
+    }
+}
+
+bool Storage::_write_file(const uint8_t *data)
+{
+    char tmp_path[sizeof(_path) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", _path);
+
+    int fd = open(tmp_path, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0666);
+    if (fd == -1) {
+        return false;
+    }
+    if (write(fd, data, LINUX_STORAGE_SIZE) != LINUX_STORAGE_SIZE ||
+        fsync(fd) != 0) {
+        // write error - likely EINTR or out of space
+        close(fd);
+        unlink(tmp_path);
+        return false;
     }
+    close(fd);
+
+    if (rename(tmp_path, _path) != 0) {
+        unlink(tmp_path);
+        return false;
+    }
+
+    // ensure the rename itself reaches the disk
+    char dir_path[sizeof(_path)];
+    snprintf(dir_path, sizeof(dir_path), "%s", _path);
+    int dfd = open(dirname(dir_path), O_RDONLY|O_CLOEXEC);
+    if (dfd != -1) {
+        fsync(dfd);
+        close(dfd);
+    }
+
+    return true;
 }
@@ -1,19 +1,39 @@
 #pragma once
 
+#include <pthread.h>
+
 #include <AP_HAL/AP_HAL.h>
 
 #define LINUX_STORAGE_SIZE HAL_STORAGE_SIZE
-#define LINUX_STORAGE_MAX_WRITE 512
 #define LINUX_STORAGE_LINE_SHIFT 9
 #define LINUX_STORAGE_LINE_SIZE (1<<LINUX_STORAGE_LINE_SHIFT)
 #define LINUX_STORAGE_NUM_LINES (LINUX_STORAGE_SIZE/LINUX_STORAGE_LINE_SIZE)
 
+// changes are written out once no further changes have been made for
+// LINUX_STORAGE_COALESCE_MS, or at most LINUX_STORAGE_MAX_DELAY_MS
+// after the first unwritten change
+#ifndef LINUX_STORAGE_COALESCE_MS
+#define LINUX_STORAGE_COALESCE_MS 100
+#endif
+#ifndef LINUX_STORAGE_MAX_DELAY_MS
+#define LINUX_STORAGE_MAX_DELAY_MS 1000
+#endif
+
+// after a failed write wait LINUX_STORAGE_RETRY_MS before trying again,
+// doubling the wait up to LINUX_STORAGE_MAX_RETRY_MS while writes fail
+#ifndef LINUX_STORAGE_RETRY_MS
+#define LINUX_STORAGE_RETRY_MS 1000
+#endif
+#ifndef LINUX_STORAGE_MAX_RETRY_MS
+#define LINUX_STORAGE_MAX_RETRY_MS 30000
+#endif
+
 namespace Linux {
 
 class Storage : public AP_HAL::Storage
 {
 public:
-    Storage() : _fd(-1),_dirty_mask(0) { }
+    Storage() : _dirty_mask(0) { }
 
     static Storage *from(AP_HAL::Storage *storage) {
         return static_cast<Storage*>(storage);
@@ -38,10 +58,35 @@ protected:
     void _mark_dirty(uint16_t loc, uint16_t length);
     int _storage_create(const char *dpath);
 
-    int _fd;
+    // write data to a temporary file and rename it over the storage
+    // file, so a crash leaves either the old or the new contents
+    bool _write_file(const uint8_t *data);
+
+    // thread which writes out snapshots handed over by _timer_tick
+    void _storage_thread(void);
+
+    // record the result of a write, marking the file dirty again and
+    // backing off if it failed
+    void _write_done(bool ok);
+
+    char _path[256];
     volatile bool _initialised;
     volatile uint32_t _dirty_mask;
+    volatile uint32_t _first_dirty_ms;
+    volatile uint32_t _last_dirty_ms;
+    uint32_t _failed_ms;
+    uint32_t _retry_ms;
+    // protects _dirty_mask, the dirty times and the retry state
+    pthread_mutex_t _dirty_mtx = PTHREAD_MUTEX_INITIALIZER;
     uint8_t _buffer[LINUX_STORAGE_SIZE];
+
+    // snapshot of _buffer being written by the storage thread
+    uint8_t _write_buffer[LINUX_STORAGE_SIZE];
+    pthread_mutex_t _write_mtx = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t _write_cond = PTHREAD_COND_INITIALIZER;
+    bool _write_pending;
+    bool _thread_started;
+    bool _thread_ok;
 };
 
 }
@@ -3,6 +3,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
@@ -32,6 +33,21 @@ ssize_t TCPServerDevice::write(const uint8_t *buf, uint16_t n)
     return sock->send(buf, n);
 }
 
+ssize_t TCPServerDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (sock == nullptr) {
+        return -1;
+    }
+
+    struct iovec iov[n_vec];
+    for (uint8_t i = 0; i < n_vec; i++) {
+        iov[i].iov_base = vec[i].data;
+        iov[i].iov_len = vec[i].len;
+    }
+
+    return ::writev(sock->get_fd(), iov, n_vec);
+}
+
 /*
   when we try to read we accept new connections if one isn't already
   established
@@ -42,6 +58,7 @@ ssize_t TCPServerDevice::read(uint8_t *buf, uint16_t n)
         sock = listener.accept(0);
         if (sock != nullptr) {
             sock->set_blocking(_blocking);
+            fd_changed();
         }
     }
     if (sock == nullptr) {
@@ -52,6 +69,7 @@ ssize_t TCPServerDevice::read(uint8_t *buf, uint16_t n)
         // EOF, go back to waiting for a new connection
         delete sock;
         sock = nullptr;
+        fd_changed();
         return -1;
     }
     return ret;
@@ -93,6 +111,7 @@ bool TCPServerDevice::open()
             sock = listener.accept(1000);
         }
         sock->set_blocking(_blocking);
+        fd_changed();
         ::printf("connected\n");
         ::fflush(stdout);
     }
@@ -105,6 +124,7 @@ bool TCPServerDevice::close()
     if (sock != nullptr) {
         delete sock;
         sock = nullptr;
+        fd_changed();
     }
     return true;
 }
@@ -14,6 +14,20 @@ public:
     virtual void set_speed(uint32_t speed) override;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
+    virtual ssize_t writev(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
+
+    /* Until a client connects the listening socket is waited on, as
+     * incoming connections are accepted by read() */
+    virtual int get_fd() const override
+    {
+        return sock != nullptr ? sock->get_fd() : listener.get_fd();
+    }
+
+    /* The listening socket stays open while a client is connected */
+    virtual bool owns_fd(int fd) const override
+    {
+        return fd >= 0 && (fd == listener.get_fd() || (sock != nullptr && fd == sock->get_fd()));
+    }
 
 private:
     SocketAPM listener{false};
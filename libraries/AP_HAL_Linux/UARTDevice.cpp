@@ -4,6 +4,7 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <stdio.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -27,6 +28,7 @@ bool UARTDevice::close()
     }
 
     _fd = -1;
+    fd_changed();
 
     return true;
 }
@@ -41,6 +43,8 @@ bool UARTDevice::open()
         return false;
     }
 
+    fd_changed();
+
     _disable_crlf();
 
     return true;
@@ -67,6 +71,23 @@ ssize_t UARTDevice::write(const uint8_t *buf, uint16_t n)
     return ret;
 }
 
+ssize_t UARTDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    struct iovec iov[n_vec];
+    for (uint8_t i = 0; i < n_vec; i++) {
+        iov[i].iov_base = vec[i].data;
+        iov[i].iov_len = vec[i].len;
+    }
+
+    /* the device is non-blocking, a full output queue gives EAGAIN */
+    ssize_t ret = ::writev(_fd, iov, n_vec);
+    if (ret < 0 && errno == EAGAIN) {
+        ret = 0;
+    }
+
+    return ret;
+}
+
 void UARTDevice::set_blocking(bool blocking)
 {
     int flags = fcntl(_fd, F_GETFL, 0);
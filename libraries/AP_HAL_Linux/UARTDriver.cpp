@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -20,6 +21,7 @@
 #include <AP_HAL/AP_HAL.h>
 
 #include "ConsoleDevice.h"
+#include "Scheduler.h"
 #include "TCPServerDevice.h"
 #include "UARTDevice.h"
 #include "UDPDevice.h"
@@ -218,10 +220,76 @@ void UARTDriver::end()
         hal.scheduler->delay(1);
     }
 
+    /*
+      the registration is removed by the UART thread so it doesn't
+      change while that thread is polling. If the thread isn't running
+      it is removed here instead
+     */
+    if (_pollable.get_fd() >= 0) {
+        _unregister_pending = true;
+        for (uint8_t i = 0; i < 100 && _unregister_pending; i++) {
+            hal.scheduler->delay(1);
+        }
+        if (_unregister_pending) {
+            _unregister_pollable();
+            _unregister_pending = false;
+        }
+    }
+
     _device->close();
     _deallocate_buffers();
 }
 
+/*
+  register the device's file descriptor with the UART thread, following
+  changes such as a TCP client connecting or disconnecting
+ */
+void UARTDriver::_update_pollable()
+{
+    const int fd = _device->get_fd();
+    const uint32_t generation = _device->get_fd_generation();
+    if (fd == _pollable.get_fd() && generation == _pollable_generation) {
+        return;
+    }
+
+    Poller *poller = Scheduler::from(hal.scheduler)->uart_poller();
+    if (poller == nullptr) {
+        return;
+    }
+
+    _unregister_pollable();
+    _pollable_generation = generation;
+    if (fd < 0) {
+        return;
+    }
+
+    /*
+      edge triggered: we are woken when new data arrives, and when the
+      device can take more output after a short write
+     */
+    _pollable.set_fd(fd);
+    if (!poller->register_pollable(&_pollable, EPOLLIN | EPOLLOUT | EPOLLET)) {
+        _pollable.set_fd(-1);
+    }
+}
+
+void UARTDriver::_unregister_pollable()
+{
+    if (_pollable.get_fd() < 0) {
+        return;
+    }
+
+    /*
+      a closed descriptor has already been removed from epoll, and its
+      number may now belong to another device's registration
+     */
+    Poller *poller = Scheduler::from(hal.scheduler)->uart_poller();
+    if (poller != nullptr && _device->owns_fd(_pollable.get_fd())) {
+        poller->unregister_pollable(&_pollable);
+    }
+    _pollable.set_fd(-1);
+}
+
 
 void UARTDriver::flush()
 {
@@ -308,8 +376,12 @@ size_t UARTDriver::write(uint8_t c)
         }
         hal.scheduler->delay(1);
     }
+    const bool was_empty = _writebuf.empty();
     size_t ret = _writebuf.write(&c, 1);
     _write_mutex.give();
+    if (was_empty) {
+        Scheduler::from(hal.scheduler)->uart_wakeup();
+    }
     return ret;
 }
 
@@ -337,8 +409,14 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
         return ret;
     }
 
+    const bool was_empty = _writebuf.empty();
     size_t ret = _writebuf.write(buffer, size);
     _write_mutex.give();
+    if (was_empty && ret > 0) {
+        // wake the UART thread to send the new bytes without waiting
+        // for its next tick
+        Scheduler::from(hal.scheduler)->uart_wakeup();
+    }
     return ret;
 }
 
@@ -361,6 +439,21 @@ int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
     return _device->write(buf, n);
 }
 
+/*
+  try writing several buffers at once, handling an unresponsive port
+ */
+int UARTDriver::_writev_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (!_connected) {
+        _connected = _device->open();
+    }
+    if (!_connected) {
+        return 0;
+    }
+
+    return _device->writev(vec, n_vec);
+}
+
 /*
   try reading n bytes, handling an unresponsive port
  */
@@ -398,17 +491,9 @@ bool UARTDriver::_write_pending_bytes(void)
         } else {
             ByteBuffer::IoVec vec[2];
             const auto n_vec = _writebuf.peekiovec(vec, n);
-            for (int i = 0; i < n_vec; i++) {
-                ret = _write_fd(vec[i].data, (uint16_t)vec[i].len);
-                if (ret < 0) {
-                    break;
-                }
+            ret = _writev_fd(vec, n_vec);
+            if (ret > 0) {
                 _writebuf.advance(ret);
-
-                /* We wrote less than we asked for, stop */
-                if ((unsigned)ret != vec[i].len) {
-                    break;
-                }
             }
         }
     }
@@ -417,16 +502,24 @@ bool UARTDriver::_write_pending_bytes(void)
 }
 
 /*
-  push any pending bytes to/from the serial port. This is called at
-  1kHz in the timer thread. Doing it this way reduces the system call
+  push any pending bytes to/from the serial port. This is called from
+  the UART thread when the device is ready, when new bytes have been
+  written and periodically. Doing it this way reduces the system call
   overhead in the main task enormously.
  */
 void UARTDriver::_timer_tick(void)
 {
+    if (_unregister_pending) {
+        _unregister_pollable();
+        _unregister_pending = false;
+    }
+
     if (!_initialised) return;
 
     _in_timer = true;
 
+    _update_pollable();
+
     uint8_t num_send = 10;
     while (num_send != 0 && _write_pending_bytes()) {
         num_send--;
@@ -4,6 +4,7 @@
 #include <AP_HAL/utility/RingBuffer.h>
 
 #include "AP_HAL_Linux.h"
+#include "Poller.h"
 #include "SerialDevice.h"
 #include "Semaphores.h"
 
@@ -68,7 +69,36 @@ public:
     uint64_t receive_time_constraint_us(uint16_t nbytes) override;
 
 private:
+    /*
+      registers the device's file descriptor with the UART thread, so
+      that the UART is ticked as soon as it is ready. The descriptor
+      belongs to the device
+     */
+    class DevicePollable : public Pollable {
+    public:
+        DevicePollable(UARTDriver &uart) : _uart(uart) { }
+        ~DevicePollable() { _fd = -1; }
+
+        void set_fd(int fd) { _fd = fd; }
+
+        void on_can_read() override { _uart._timer_tick(); }
+        void on_can_write() override
+        {
+            if (_uart.tx_pending()) {
+                _uart._timer_tick();
+            }
+        }
+
+    private:
+        UARTDriver &_uart;
+    };
+
     AP_HAL::OwnPtr<SerialDevice> _device;
+    DevicePollable _pollable{*this};
+    // device fd generation at registration, see SerialDevice::get_fd_generation()
+    uint32_t _pollable_generation;
+    // set by end() for the UART thread to remove the registration
+    volatile bool _unregister_pending;
     bool _nonblocking_writes;
     bool _console;
     volatile bool _in_timer;
@@ -81,6 +111,8 @@ private:
 
     void _allocate_buffers(uint16_t rxS, uint16_t txS);
     void _deallocate_buffers();
+    void _update_pollable();
+    void _unregister_pollable();
 
     AP_HAL::OwnPtr<SerialDevice> _parseDevicePath(const char *arg);
 
@@ -98,6 +130,7 @@ protected:
     ByteBuffer _writebuf{0};
 
     virtual int _write_fd(const uint8_t *buf, uint16_t n);
+    virtual int _writev_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec);
     virtual int _read_fd(uint8_t *buf, uint16_t n);
 
     Linux::Semaphore _write_mutex;
@@ -215,185 +215,110 @@ void SITL_State::wait_clock(uint64_t wait_time_usec)
 }
 
 #define streq(a, b) (!strcmp(a, b))
-int SITL_State::sim_fd(const char *name, const char *arg)
+SITL::SerialDevice *SITL_State::sim_device(const char *name, const char *arg)
 {
     if (streq(name, "vicon")) {
         if (vicon != nullptr) {
             AP_HAL::panic("Only one vicon system at a time");
         }
         vicon = new SITL::Vicon();
-        return vicon->fd();
+        return vicon;
     } else if (streq(name, "benewake_tf02")) {
         if (benewake_tf02 != nullptr) {
             AP_HAL::panic("Only one benewake_tf02 at a time");
         }
         benewake_tf02 = new SITL::RF_Benewake_TF02();
-        return benewake_tf02->fd();
+        return benewake_tf02;
     } else if (streq(name, "benewake_tf03")) {
         if (benewake_tf03 != nullptr) {
             AP_HAL::panic("Only one benewake_tf03 at a time");
         }
         benewake_tf03 = new SITL::RF_Benewake_TF03();
-        return benewake_tf03->fd();
+        return benewake_tf03;
     } else if (streq(name, "benewake_tfmini")) {
         if (benewake_tfmini != nullptr) {
             AP_HAL::panic("Only one benewake_tfmini at a time");
         }
         benewake_tfmini = new SITL::RF_Benewake_TFmini();
-        return benewake_tfmini->fd();
+        return benewake_tfmini;
     } else if (streq(name, "lightwareserial")) {
         if (lightwareserial != nullptr) {
             AP_HAL::panic("Only one lightwareserial at a time");
         }
         lightwareserial = new SITL::RF_LightWareSerial();
-        return lightwareserial->fd();
+        return lightwareserial;
     } else if (streq(name, "lanbao")) {
         if (lanbao != nullptr) {
             AP_HAL::panic("Only one lanbao at a time");
         }
         lanbao = new SITL::RF_Lanbao();
-        return lanbao->fd();
+        return lanbao;
     } else if (streq(name, "blping")) {
         if (blping != nullptr) {
             AP_HAL::panic("Only one blping at a time");
         }
         blping = new SITL::RF_BLping();
-        return blping->fd();
+        return blping;
     } else if (streq(name, "leddarone")) {
         if (leddarone != nullptr) {
             AP_HAL::panic("Only one leddarone at a time");
         }
         leddarone = new SITL::RF_LeddarOne();
-        return leddarone->fd();
+        return leddarone;
     } else if (streq(name, "ulanding_v0")) {
         if (ulanding_v0 != nullptr) {
             AP_HAL::panic("Only one ulanding_v0 at a time");
         }
         ulanding_v0 = new SITL::RF_uLanding_v0();
-        return ulanding_v0->fd();
+        return ulanding_v0;
     } else if (streq(name, "ulanding_v1")) {
         if (ulanding_v1 != nullptr) {
             AP_HAL::panic("Only one ulanding_v1 at a time");
         }
         ulanding_v1 = new SITL::RF_uLanding_v1();
-        return ulanding_v1->fd();
+        return ulanding_v1;
     } else if (streq(name, "maxsonarseriallv")) {
         if (maxsonarseriallv != nullptr) {
             AP_HAL::panic("Only one maxsonarseriallv at a time");
         }
         maxsonarseriallv = new SITL::RF_MaxsonarSerialLV();
-        return maxsonarseriallv->fd();
+        return maxsonarseriallv;
     } else if (streq(name, "wasp")) {
         if (wasp != nullptr) {
             AP_HAL::panic("Only one wasp at a time");
         }
         wasp = new SITL::RF_Wasp();
-        return wasp->fd();
+        return wasp;
     } else if (streq(name, "nmea")) {
         if (nmea != nullptr) {
             AP_HAL::panic("Only one nmea at a time");
         }
         nmea = new SITL::RF_NMEA();
-        return nmea->fd();
+        return nmea;
 
     } else if (streq(name, "frsky-d")) {
         if (frsky_d != nullptr) {
             AP_HAL::panic("Only one frsky_d at a time");
         }
         frsky_d = new SITL::Frsky_D();
-        return frsky_d->fd();
+        return frsky_d;
     // } else if (streq(name, "frsky-SPort")) {
     //     if (frsky_sport != nullptr) {
     //         AP_HAL::panic("Only one frsky_sport at a time");
     //     }
     //     frsky_sport = new SITL::Frsky_SPort();
-    //     return frsky_sport->fd();
+    //     return frsky_sport;
 
     // } else if (streq(name, "frsky-SPortPassthrough")) {
     //     if (frsky_sport_passthrough != nullptr) {
     //         AP_HAL::panic("Only one frsky_sport passthrough at a time");
     //     }
     //     frsky_sport = new SITL::Frsky_SPortPassthrough();
-    //     return frsky_sportpassthrough->fd();
+    //     return frsky_sportpassthrough;
     }
 
     AP_HAL::panic("unknown simulated device: %s", name);
 }
-int SITL_State::sim_fd_write(const char *name)
-{
-    if (streq(name, "vicon")) {
-        if (vicon == nullptr) {
-            AP_HAL::panic("No vicon created");
-        }
-        return vicon->write_fd();
-    } else if (streq(name, "benewake_tf02")) {
-        if (benewake_tf02 == nullptr) {
-            AP_HAL::panic("No benewake_tf02 created");
-        }
-        return benewake_tf02->write_fd();
-    } else if (streq(name, "benewake_tf03")) {
-        if (benewake_tf03 == nullptr) {
-            AP_HAL::panic("No benewake_tf03 created");
-        }
-        return benewake_tf03->write_fd();
-    } else if (streq(name, "benewake_tfmini")) {
-        if (benewake_tfmini == nullptr) {
-            AP_HAL::panic("No benewake_tfmini created");
-        }
-        return benewake_tfmini->write_fd();
-    } else if (streq(name, "lightwareserial")) {
-        if (lightwareserial == nullptr) {
-            AP_HAL::panic("No lightwareserial created");
-        }
-        return lightwareserial->write_fd();
-    } else if (streq(name, "lanbao")) {
-        if (lanbao == nullptr) {
-            AP_HAL::panic("No lanbao created");
-        }
-        return lanbao->write_fd();
-    } else if (streq(name, "blping")) {
-        if (blping == nullptr) {
-            AP_HAL::panic("No blping created");
-        }
-        return blping->write_fd();
-    } else if (streq(name, "leddarone")) {
-        if (leddarone == nullptr) {
-            AP_HAL::panic("No leddarone created");
-        }
-        return leddarone->write_fd();
-    } else if (streq(name, "ulanding_v0")) {
-        if (ulanding_v0 == nullptr) {
-            AP_HAL::panic("No ulanding_v0 created");
-        }
-        return ulanding_v0->write_fd();
-    } else if (streq(name, "ulanding_v1")) {
-        if (ulanding_v1 == nullptr) {
-            AP_HAL::panic("No ulanding_v1 created");
-        }
-        return ulanding_v1->write_fd();
-    } else if (streq(name, "maxsonarseriallv")) {
-        if (maxsonarseriallv == nullptr) {
-            AP_HAL::panic("No maxsonarseriallv created");
-        }
-        return maxsonarseriallv->write_fd();
-    } else if (streq(name, "wasp")) {
-        if (wasp == nullptr) {
-            AP_HAL::panic("No wasp created");
-        }
-        return wasp->write_fd();
-    } else if (streq(name, "nmea")) {
-        if (nmea == nullptr) {
-            AP_HAL::panic("No nmea created");
-        }
-        return nmea->write_fd();
-    } else if (streq(name, "frsky-d")) {
-        if (frsky_d == nullptr) {
-            AP_HAL::panic("No frsky-d created");
-        }
-        return frsky_d->write_fd();
-    }
-    AP_HAL::panic("unknown simulated device: %s", name);
-}
 
 #ifndef HIL_MODE
 /*
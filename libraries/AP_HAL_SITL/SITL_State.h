@@ -60,6 +60,7 @@ public:
     };
 
     int gps_pipe(uint8_t index);
+    ByteBuffer *gps_buffer(uint8_t index);
     ssize_t gps_read(int fd, void *buf, size_t count);
     uint16_t pwm_output[SITL_NUM_CHANNELS];
     uint16_t pwm_input[SITL_RC_INPUT_CHANNELS];
@@ -70,15 +71,19 @@ public:
         return _base_port;
     }
 
-    // create a file descriptor attached to a virtual device; type of
-    // device is given by name parameter
-    int sim_fd(const char *name, const char *arg);
-    // returns a write file descriptor for a created virtual device
-    int sim_fd_write(const char *name);
+    // create a virtual device; type of device is given by name
+    // parameter
+    SITL::SerialDevice *sim_device(const char *name, const char *arg);
 
     bool use_rtscts(void) const {
         return _use_rtscts;
     }
+
+    // true if simulated serial devices should be connected with
+    // pipes rather than in-process buffers
+    bool use_serial_pipes(void) const {
+        return _use_serial_pipes;
+    }
     
     // simulated airspeed, sonar and battery monitor
     uint16_t sonar_pin_value;    // pin 0
@@ -195,6 +200,7 @@ private:
     bool _synthetic_clock_mode;
 
     bool _use_rtscts;
+    bool _use_serial_pipes;
     bool _use_fg_view;
     
     const char *_fg_address;
@@ -87,6 +87,7 @@ void SITL_State::_usage(void)
            "\t--uartG device           set device string for UARTG\n"
            "\t--uartH device           set device string for UARTH\n"
            "\t--rtscts                 enable rtscts on serial ports (default false)\n"
+           "\t--serial-pipes           connect simulated serial devices with pipes instead of in-process buffers\n"
            "\t--base-port PORT         set port num for base port(default 5670) must be before -I option\n"
            "\t--rc-in-port PORT        set port num for rc in\n"
            "\t--sim-address ADDR       set address string for simulator\n"
@@ -211,6 +212,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_UARTG,
         CMDLINE_UARTH,
         CMDLINE_RTSCTS,
+        CMDLINE_SERIAL_PIPES,
         CMDLINE_BASE_PORT,
         CMDLINE_RCIN_PORT,
         CMDLINE_SIM_ADDRESS,
@@ -246,6 +248,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"uartG",           true,   0, CMDLINE_UARTG},
         {"uartH",           true,   0, CMDLINE_UARTH},
         {"rtscts",          false,  0, CMDLINE_RTSCTS},
+        {"serial-pipes",    false,  0, CMDLINE_SERIAL_PIPES},
         {"base-port",       true,   0, CMDLINE_BASE_PORT},
         {"rc-in-port",      true,   0, CMDLINE_RCIN_PORT},
         {"sim-address",     true,   0, CMDLINE_SIM_ADDRESS},
@@ -352,6 +355,9 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_RTSCTS:
             _use_rtscts = true;
             break;
+        case CMDLINE_SERIAL_PIPES:
+            _use_serial_pipes = true;
+            break;
         case CMDLINE_BASE_PORT:
             _base_port = atoi(gopt.optarg);
             break;
@@ -16,3 +16,17 @@ public:
 protected:
     pthread_mutex_t _lock;
 };
+
+class HALSITL::BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore(bool initial_state=false);
+
+    bool wait(uint32_t timeout_us) override;
+    bool wait_blocking(void) override;
+    void signal(void) override;
+
+protected:
+    pthread_mutex_t _mtx;
+    pthread_cond_t _cond;
+    bool _pending;
+};
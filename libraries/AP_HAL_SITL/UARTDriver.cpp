@@ -64,11 +64,19 @@ void UARTDriver::begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace)
     if (strcmp(path, "GPS1") == 0) {
         /* gps */
         _connected = true;
-        _fd = _sitlState->gps_pipe(0);
+        if (_sitlState->use_serial_pipes()) {
+            _fd = _sitlState->gps_pipe(0);
+        } else {
+            _sim_rx = _sitlState->gps_buffer(0);
+        }
     } else if (strcmp(path, "GPS2") == 0) {
         /* 2nd gps */
         _connected = true;
-        _fd = _sitlState->gps_pipe(1);
+        if (_sitlState->use_serial_pipes()) {
+            _fd = _sitlState->gps_pipe(1);
+        } else {
+            _sim_rx = _sitlState->gps_buffer(1);
+        }
     } else {
         /* parse type:args:flags string for path. 
            For example:
@@ -107,8 +115,15 @@ void UARTDriver::begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace)
             if (!_connected) {
                 ::printf("SIM connection %s:%s on port %u\n", args1, args2, _portNumber);
                 _connected = true;
-                _fd = _sitlState->sim_fd(args1, args2);
-                _fd_write = _sitlState->sim_fd_write(args1);
+                SITL::SerialDevice *device = _sitlState->sim_device(args1, args2);
+                if (_sitlState->use_serial_pipes()) {
+                    _fd = device->fd();
+                    _fd_write = device->write_fd();
+                } else {
+                    device->use_buffers();
+                    _sim_rx = device->to_autopilot_buffer();
+                    _sim_tx = device->from_autopilot_buffer();
+                }
             }
         } else if (strcmp(devtype, "udpclient") == 0) {
             // udp client connection
@@ -642,6 +657,11 @@ void UARTDriver::_timer_tick(void)
         last_tick_us = now;
     }
 
+    if (_sim_rx != nullptr) {
+        _sim_buffer_tick(max_bytes);
+        return;
+    }
+
     if (_packetise) {
         uint16_t n = _writebuffer.available();
         n = MIN(n, max_bytes);
@@ -746,6 +766,35 @@ void UARTDriver::_timer_tick(void)
     }
 }
 
+/*
+  move data between our buffers and the buffers of an in-process
+  simulated device, without going through the kernel
+ */
+void UARTDriver::_sim_buffer_tick(uint32_t max_bytes)
+{
+    uint32_t n;
+    const uint8_t *readptr = _writebuffer.readptr(n);
+    if (readptr != nullptr && n > 0) {
+        n = MIN(n, max_bytes);
+        if (_sim_tx != nullptr) {
+            n = _sim_tx->write(readptr, n);
+        }
+        // devices which don't read from us (e.g. the GPS) discard
+        // anything written to them
+        _writebuffer.advance(n);
+    }
+
+    readptr = _sim_rx->readptr(n);
+    if (readptr != nullptr && n > 0) {
+        n = MIN(n, MIN(_readbuffer.space(), max_bytes));
+        if (n > 0) {
+            _readbuffer.write(readptr, n);
+            _sim_rx->advance(n);
+            _receive_timestamp = AP_HAL::micros64();
+        }
+    }
+}
+
 /*
   return timestamp estimate in microseconds for when the start of
   a nbytes packet arrived on the uart. This should be treated as a
@@ -125,6 +125,12 @@ private:
     // _fd.  This is to support simulated serial devices, which use a
     // pipe for read and a pipe for write
     int _fd_write = -1;
+
+    // if these are not nullptr then data is exchanged with an
+    // in-process simulated device through them instead of _fd
+    ByteBuffer *_sim_rx = nullptr;
+    ByteBuffer *_sim_tx = nullptr;
+    void _sim_buffer_tick(uint32_t max_bytes);
 };
 
 #endif
@@ -37,6 +37,8 @@ extern const AP_HAL::HAL& hal;
 static struct gps_state {
     /* pipe emulating UBLOX GPS serial stream */
     int gps_fd, client_fd;
+    /* in-process buffer used instead of the pipe */
+    ByteBuffer *buffer;
     uint32_t last_update; // milliseconds
 
     uint8_t next_index;
@@ -82,6 +84,47 @@ int SITL_State::gps_pipe(uint8_t idx)
     return gps_state[idx].client_fd;
 }
 
+/*
+  setup GPS input buffer, used instead of gps_pipe() to avoid a
+  syscall per byte
+ */
+ByteBuffer *SITL_State::gps_buffer(uint8_t idx)
+{
+    if (gps_state[idx].buffer == nullptr) {
+        gps_state[idx].buffer = new ByteBuffer(8192);
+        if (gps_state[idx].buffer == nullptr) {
+            AP_HAL::panic("Failed to allocate GPS buffer");
+        }
+        gps_state[idx].last_update = AP_HAL::millis();
+    }
+    return gps_state[idx].buffer;
+}
+
+/*
+  return true if the simulated GPS is attached to a UART
+ */
+static bool gps_attached(uint8_t idx)
+{
+    return gps_state[idx].gps_fd != 0 || gps_state[idx].buffer != nullptr;
+}
+
+/*
+  write a run of bytes to the GPS pipe or buffer
+ */
+static void gps_write_run(uint8_t instance, const uint8_t *p, uint16_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    if (gps_state[instance].buffer != nullptr) {
+        // bytes which don't fit are lost, as they would be on a real
+        // UART with a full receive buffer
+        gps_state[instance].buffer->write(p, size);
+    } else if (gps_state[instance].gps_fd != 0) {
+        write(gps_state[instance].gps_fd, p, size);
+    }
+}
+
 /*
   write some bytes from the simulated GPS
  */
@@ -90,20 +133,23 @@ void SITL_State::_gps_write(const uint8_t *p, uint16_t size, uint8_t instance)
     if (instance == 1 && !_sitl->gps2_enable) {
         return;
     }
-    while (size--) {
-        if (_sitl->gps_byteloss > 0.0f) {
-            float r = ((((unsigned)random()) % 1000000)) / 1.0e4;
-            if (r < _sitl->gps_byteloss) {
-                // lose the byte
-                p++;
-                continue;
-            }
-        }
-        if (gps_state[instance].gps_fd != 0) {
-            write(gps_state[instance].gps_fd, p, 1);
+    if (_sitl->gps_byteloss <= 0.0f) {
+        gps_write_run(instance, p, size);
+        return;
+    }
+    // write the runs of bytes between lost bytes
+    uint16_t run = 0;
+    for (uint16_t i=0; i<size; i++) {
+        float r = ((((unsigned)random()) % 1000000)) / 1.0e4;
+        if (r < _sitl->gps_byteloss) {
+            // lose the byte
+            gps_write_run(instance, &p[i-run], run);
+            run = 0;
+            continue;
         }
-        p++;
+        run++;
     }
+    gps_write_run(instance, &p[size-run], run);
 }
 
 /*
@@ -1258,7 +1304,7 @@ void SITL_State::_update_gps(double latitude, double longitude, float altitude,
             }
         }
 
-        if (gps_state[idx].gps_fd == 0) {
+        if (!gps_attached(idx)) {
             continue;
         }
 
@@ -1269,7 +1315,7 @@ void SITL_State::_update_gps(double latitude, double longitude, float altitude,
         d.longitude += glitch_offsets.y;
         d.altitude += glitch_offsets.z;
 
-        if (gps_state[idx].gps_fd != 0) {
+        if (gps_attached(idx)) {
             _update_gps_instance((SITL::SITL::GPSType)_sitl->gps_type[idx].get(), &d, idx);
         }
     }
@@ -330,6 +330,7 @@ public:
 
         void init();
         void sample(uint8_t instance, IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &sample);
+        void sample_block(uint8_t instance, IMU_SENSOR_TYPE _type, uint64_t first_sample_us, const Vector3f *samples, uint8_t n);
 
         // a function called by the main thread at the main loop rate:
         void periodic();
@@ -10,6 +10,10 @@
 
 #define SENSOR_RATE_DEBUG 0
 
+// number of FIFO samples processed per semaphore hold. This bounds the
+// stack used for post-filter logging in the block notify functions
+#define INS_SAMPLE_BLOCK_MAX 16
+
 const extern AP_HAL::HAL& hal;
 
 AP_InertialSensor_Backend::AP_InertialSensor_Backend(AP_InertialSensor &imu) :
@@ -54,14 +58,14 @@ void AP_InertialSensor_Backend::_set_gyro_oversampling(uint8_t instance, uint8_t
   sensor may vary slightly from the system clock. This slowly adjusts
   the rate to the observed rate
 */
-void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const
+void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t nsamples) const
 {
     uint32_t now = AP_HAL::micros();
     if (start_us == 0) {
         count = 0;
         start_us = now;
     } else {
-        count++;
+        count += nsamples;
         if (now - start_us > 1000000UL) {
             float observed_rate_hz = count * 1.0e6f / (now - start_us);
 #if SENSOR_RATE_DEBUG
@@ -263,6 +267,113 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     }
 }
 
+/*
+  notify a block of gyro samples read from a FIFO. This does the same
+  work as _notify_new_gyro_raw_sample() for each sample, but takes the
+  semaphore once per INS_SAMPLE_BLOCK_MAX samples and logs the block in
+  one call
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyros, uint8_t n)
+{
+    if (((1U<<instance) & _imu.imu_kill_mask) || n == 0) {
+        return;
+    }
+
+    _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                        _imu._gyro_raw_sample_rates[instance], n);
+
+    // don't accept below 100Hz
+    if (_imu._gyro_raw_sample_rates[instance] < 100) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+    const uint32_t dt_us = dt * 1.0e6f;
+    const uint64_t now = AP_HAL::micros64();
+    const uint64_t last_sample_us = _imu._gyro_last_sample_us[instance];
+    _imu._gyro_last_sample_us[instance] = now;
+
+    // the newest sample in the FIFO is the one taken just before the read
+    const uint64_t span_us = uint64_t(n - 1) * dt_us;
+    const uint64_t first_sample_us = now > span_us ? now - span_us : now;
+
+    // zero accumulator if sensor was unhealthy for 0.1s
+    bool reset = (now - last_sample_us > 100000U);
+
+    for (uint8_t i = 0; i < n; i++) {
+#if AP_MODULE_SUPPORTED
+        // call gyro_sample hook if any
+        AP_Module::call_hook_gyro_sample(instance, dt, gyros[i]);
+#endif
+        // push gyros if optical flow present
+        if (hal.opticalflow) {
+            hal.opticalflow->push_gyro(gyros[i].x, gyros[i].y, dt);
+        }
+    }
+
+    const bool post_filter = _imu.batchsampler.doing_post_filter_logging();
+    Vector3f filtered[INS_SAMPLE_BLOCK_MAX];
+
+    for (uint8_t start = 0; start < n; start += INS_SAMPLE_BLOCK_MAX) {
+        const uint8_t count = MIN(n - start, INS_SAMPLE_BLOCK_MAX);
+        const Vector3f *block = &gyros[start];
+        {
+            WITH_SEMAPHORE(_sem);
+
+            for (uint8_t i = 0; i < count; i++) {
+                const Vector3f &gyro = block[i];
+                float sample_dt = dt;
+                if (reset) {
+                    _imu._delta_angle_acc[instance].zero();
+                    _imu._delta_angle_acc_dt[instance] = 0;
+                    sample_dt = 0;
+                    reset = false;
+                }
+
+                // delta angle and coning correction, as in _notify_new_gyro_raw_sample()
+                const Vector3f delta_angle = (gyro + _imu._last_raw_gyro[instance]) * 0.5f * sample_dt;
+                Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+                                         _imu._last_delta_angle[instance] * (1.0f / 6.0f));
+                delta_coning = delta_coning % delta_angle;
+                delta_coning *= 0.5f;
+
+                _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+                _imu._delta_angle_acc_dt[instance] += sample_dt;
+
+                _imu._last_delta_angle[instance] = delta_angle;
+                _imu._last_raw_gyro[instance] = gyro;
+#if HAL_WITH_DSP
+                // capture gyro window for FFT analysis
+                _last_gyro_window[_num_gyro_samples++] = gyro * _imu._gyro_raw_sampling_multiplier[instance];
+                _num_gyro_samples = _num_gyro_samples % INS_MAX_GYRO_WINDOW_SAMPLES; // protect against overrun
+#endif
+                Vector3f gyro_filtered = _imu._gyro_filter[instance].apply(gyro);
+                if (_gyro_notch_enabled()) {
+                    gyro_filtered = _imu._gyro_notch_filter[instance].apply(gyro_filtered);
+                }
+                if (gyro_harmonic_notch_enabled()) {
+                    gyro_filtered = _imu._gyro_harmonic_notch_filter[instance].apply(gyro_filtered);
+                }
+
+                // if the filtering failed in any way then reset the filters and keep the old value
+                if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
+                    _imu._gyro_filter[instance].reset();
+                    _imu._gyro_notch_filter[instance].reset();
+                    _imu._gyro_harmonic_notch_filter[instance].reset();
+                } else {
+                    _imu._gyro_filtered[instance] = gyro_filtered;
+                }
+                filtered[i] = _imu._gyro_filtered[instance];
+            }
+
+            _imu._new_gyro_data[instance] = true;
+        }
+
+        log_gyro_raw_block(instance, first_sample_us + uint64_t(start) * dt_us, dt_us,
+                           post_filter ? filtered : block, count);
+    }
+}
+
 void AP_InertialSensor_Backend::log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &gyro)
 {
     AP_Logger *logger = AP_Logger::get_singleton();
@@ -401,6 +512,116 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
     }
 }
 
+/*
+  notify a block of accel samples read from a FIFO, see
+  _notify_new_gyro_raw_samples()
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accels, uint8_t n, uint32_t fsync_mask)
+{
+    if (((1U<<instance) & _imu.imu_kill_mask) || n == 0) {
+        return;
+    }
+
+    _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                        _imu._accel_raw_sample_rates[instance], n);
+
+    // don't accept below 100Hz
+    if (_imu._accel_raw_sample_rates[instance] < 100) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+    const uint32_t dt_us = dt * 1.0e6f;
+    const uint64_t now = AP_HAL::micros64();
+    const uint64_t last_sample_us = _imu._accel_last_sample_us[instance];
+    _imu._accel_last_sample_us[instance] = now;
+
+    const uint64_t span_us = uint64_t(n - 1) * dt_us;
+    const uint64_t first_sample_us = now > span_us ? now - span_us : now;
+
+    // zero accumulator if sensor was unhealthy for 0.1s
+    bool reset = (now - last_sample_us > 100000U);
+
+    for (uint8_t i = 0; i < n; i++) {
+#if AP_MODULE_SUPPORTED
+        // call accel_sample hook if any
+        const bool fsync_set = i < 32 && (fsync_mask & (1UL<<i)) != 0;
+        AP_Module::call_hook_accel_sample(instance, dt, accels[i], fsync_set);
+#endif
+        _imu.calc_vibration_and_clipping(instance, accels[i], dt);
+    }
+
+    const bool post_filter = _imu.batchsampler.doing_post_filter_logging();
+    Vector3f filtered[INS_SAMPLE_BLOCK_MAX];
+
+    for (uint8_t start = 0; start < n; start += INS_SAMPLE_BLOCK_MAX) {
+        const uint8_t count = MIN(n - start, INS_SAMPLE_BLOCK_MAX);
+        const Vector3f *block = &accels[start];
+        {
+            WITH_SEMAPHORE(_sem);
+
+            for (uint8_t i = 0; i < count; i++) {
+                const Vector3f &accel = block[i];
+                float sample_dt = dt;
+                if (reset) {
+                    _imu._delta_velocity_acc[instance].zero();
+                    _imu._delta_velocity_acc_dt[instance] = 0;
+                    sample_dt = 0;
+                    reset = false;
+                }
+
+                _imu._delta_velocity_acc[instance] += accel * sample_dt;
+                _imu._delta_velocity_acc_dt[instance] += sample_dt;
+
+                _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
+                if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+                    _imu._accel_filter[instance].reset();
+                }
+                filtered[i] = _imu._accel_filtered[instance];
+
+                _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+            }
+
+            _imu._new_accel_data[instance] = true;
+        }
+
+        log_accel_raw_block(instance, first_sample_us + uint64_t(start) * dt_us, dt_us,
+                            post_filter ? filtered : block, count);
+    }
+}
+
+void AP_InertialSensor_Backend::log_accel_raw_block(uint8_t instance, uint64_t first_sample_us, uint32_t interval_us, const Vector3f *accels, uint8_t n)
+{
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr) {
+        // should not have been called
+        return;
+    }
+    if (should_log_imu_raw()) {
+        for (uint8_t i = 0; i < n; i++) {
+            log_accel_raw(instance, first_sample_us + uint64_t(i) * interval_us, accels[i]);
+        }
+    } else if (!_imu.batchsampler.doing_sensor_rate_logging()) {
+        _imu.batchsampler.sample_block(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, first_sample_us, accels, n);
+    }
+}
+
+void AP_InertialSensor_Backend::log_gyro_raw_block(uint8_t instance, uint64_t first_sample_us, uint32_t interval_us, const Vector3f *gyros, uint8_t n)
+{
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr) {
+        // should not have been called
+        return;
+    }
+    if (should_log_imu_raw()) {
+        for (uint8_t i = 0; i < n; i++) {
+            log_gyro_raw(instance, first_sample_us + uint64_t(i) * interval_us, gyros[i]);
+        }
+    } else if (!_imu.batchsampler.doing_sensor_rate_logging()) {
+        _imu.batchsampler.sample_block(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO, first_sample_us, gyros, n);
+    }
+}
+
 void AP_InertialSensor_Backend::_notify_new_accel_sensor_rate_sample(uint8_t instance, const Vector3f &accel)
 {
     if (!_imu.batchsampler.doing_sensor_rate_logging()) {
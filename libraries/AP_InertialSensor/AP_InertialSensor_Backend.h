@@ -145,6 +145,14 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false);
 
+    // block versions of the above for FIFO based sensors. The samples
+    // must be rotated and corrected and be in FIFO order, oldest
+    // first. Sample times are reconstructed from the time of the call
+    // and the measured sensor rate. Bit i of fsync_mask is the FSYNC
+    // flag of sample i
+    void _notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyros, uint8_t n);
+    void _notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accels, uint8_t n, uint32_t fsync_mask=0);
+
     // set the amount of oversamping a accel is doing
     void _set_accel_oversampling(uint8_t instance, uint8_t n);
 
@@ -178,7 +186,7 @@ protected:
     }
 
     // update the sensor rate for FIFO sensors
-    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const;
+    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t nsamples=1) const;
 
     // return true if the sensors are still converging and sampling rates could change significantly
     bool sensors_converging() const { return AP_HAL::millis() < 30000; }
@@ -319,5 +327,7 @@ private:
     bool should_log_imu_raw() const;
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel);
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &gryo);
+    void log_accel_raw_block(uint8_t instance, uint64_t first_sample_us, uint32_t interval_us, const Vector3f *accels, uint8_t n);
+    void log_gyro_raw_block(uint8_t instance, uint64_t first_sample_us, uint32_t interval_us, const Vector3f *gyros, uint8_t n);
 
 };
@@ -54,7 +54,7 @@ extern const AP_HAL::HAL& hal;
 #include "AP_InertialSensor_Invensense_registers.h"
 
 #define MPU_SAMPLE_SIZE 14
-#define MPU_FIFO_BUFFER_LEN 16
+#define MPU_FIFO_BUFFER_LEN 32
 
 #define int16_val(v, idx) ((int16_t)(((uint16_t)v[2*idx] << 8) | v[2*idx+1]))
 #define uint16_val(v, idx)(((uint16_t)v[2*idx] << 8) | v[2*idx+1])
@@ -82,6 +82,8 @@ AP_InertialSensor_Invensense::~AP_InertialSensor_Invensense()
     if (_fifo_buffer != nullptr) {
         hal.util->free_type(_fifo_buffer, MPU_FIFO_BUFFER_LEN * MPU_SAMPLE_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
     }
+    delete[] _accel_samples;
+    delete[] _gyro_samples;
     delete _auxiliary_bus;
 }
 
@@ -346,6 +348,13 @@ void AP_InertialSensor_Invensense::start()
         AP_HAL::panic("Invensense: Unable to allocate FIFO buffer");
     }
 
+    // converted samples, passed to the frontend a FIFO read at a time
+    _accel_samples = new Vector3f[MPU_FIFO_BUFFER_LEN];
+    _gyro_samples = new Vector3f[MPU_FIFO_BUFFER_LEN];
+    if (_accel_samples == nullptr || _gyro_samples == nullptr) {
+        AP_HAL::panic("Invensense: Unable to allocate sample buffers");
+    }
+
     // start the timer process to read samples
     _dev->register_periodic_callback(1000000UL / _backend_rate_hz, FUNCTOR_BIND_MEMBER(&AP_InertialSensor_Invensense::_poll_data, void));
 }
@@ -408,15 +417,25 @@ void AP_InertialSensor_Invensense::_poll_data()
     _read_fifo();
 }
 
+/*
+  convert the samples from a FIFO read and pass them to the frontend
+  as a block. Samples before a corrupt one are still used
+ */
 bool AP_InertialSensor_Invensense::_accumulate(uint8_t *samples, uint8_t n_samples)
 {
-    for (uint8_t i = 0; i < n_samples; i++) {
-        const uint8_t *data = samples + MPU_SAMPLE_SIZE * i;
-        Vector3f accel, gyro;
-        bool fsync_set = false;
+    uint32_t fsync_mask = 0;
+    bool ret = true;
+    uint8_t n;
+
+    for (n = 0; n < n_samples; n++) {
+        const uint8_t *data = samples + MPU_SAMPLE_SIZE * n;
+        Vector3f &accel = _accel_samples[n];
+        Vector3f &gyro = _gyro_samples[n];
 
 #if INVENSENSE_EXT_SYNC_ENABLE
-        fsync_set = (int16_val(data, 2) & 1U) != 0;
+        if ((int16_val(data, 2) & 1U) != 0) {
+            fsync_mask |= (1UL<<n);
+        }
 #endif
         
         accel = Vector3f(int16_val(data, 1),
@@ -427,8 +446,8 @@ bool AP_InertialSensor_Invensense::_accumulate(uint8_t *samples, uint8_t n_sampl
         int16_t t2 = int16_val(data, 3);
         if (!_check_raw_temp(t2)) {
             debug("temp reset IMU[%u] %d %d", _accel_instance, _raw_temp, t2);
-            _fifo_reset();
-            return false;
+            ret = false;
+            break;
         }
         float temp = t2 * temp_sensitivity + temp_zero;
         
@@ -440,12 +459,16 @@ bool AP_InertialSensor_Invensense::_accumulate(uint8_t *samples, uint8_t n_sampl
         _rotate_and_correct_accel(_accel_instance, accel);
         _rotate_and_correct_gyro(_gyro_instance, gyro);
 
-        _notify_new_accel_raw_sample(_accel_instance, accel, 0, fsync_set);
-        _notify_new_gyro_raw_sample(_gyro_instance, gyro);
-
         _temp_filtered = _temp_filter.apply(temp);
     }
-    return true;
+
+    _notify_new_accel_raw_samples(_accel_instance, _accel_samples, n, fsync_mask);
+    _notify_new_gyro_raw_samples(_gyro_instance, _gyro_samples, n);
+
+    if (!ret) {
+        _fifo_reset();
+    }
+    return ret;
 }
 
 /*
@@ -462,6 +485,7 @@ bool AP_InertialSensor_Invensense::_accumulate_sensor_rate_sampling(uint8_t *sam
     const int32_t unscaled_clip_limit = _clip_limit / _accel_scale;
     bool clipped = false;
     bool ret = true;
+    uint8_t n_out = 0;
     
     for (uint8_t i = 0; i < n_samples; i++) {
         const uint8_t *data = samples + MPU_SAMPLE_SIZE * i;
@@ -470,7 +494,6 @@ bool AP_InertialSensor_Invensense::_accumulate_sensor_rate_sampling(uint8_t *sam
         int16_t t2 = int16_val(data, 3);
         if (!_check_raw_temp(t2)) {
             debug("temp reset IMU[%u] %d %d", _accel_instance, _raw_temp, t2);
-            _fifo_reset();
             ret = false;
             break;
         }
@@ -508,10 +531,11 @@ bool AP_InertialSensor_Invensense::_accumulate_sensor_rate_sampling(uint8_t *sam
             
             _rotate_and_correct_accel(_accel_instance, _accum.accel);
             _rotate_and_correct_gyro(_gyro_instance, _accum.gyro);
-            
-            _notify_new_accel_raw_sample(_accel_instance, _accum.accel, 0, false);
-            _notify_new_gyro_raw_sample(_gyro_instance, _accum.gyro);
-            
+
+            _accel_samples[n_out] = _accum.accel;
+            _gyro_samples[n_out] = _accum.gyro;
+            n_out++;
+
             _accum.accel.zero();
             _accum.gyro.zero();
             _accum.count = 0;
@@ -522,7 +546,13 @@ bool AP_InertialSensor_Invensense::_accumulate_sensor_rate_sampling(uint8_t *sam
         increment_clip_count(_accel_instance);
     }
 
-    if (ret) {
+    // pass the downsampled samples to the frontend as one block
+    _notify_new_accel_raw_samples(_accel_instance, _accel_samples, n_out);
+    _notify_new_gyro_raw_samples(_gyro_instance, _gyro_samples, n_out);
+
+    if (!ret) {
+        _fifo_reset();
+    } else {
         float temp = (static_cast<float>(tsum)/n_samples)*temp_sensitivity + temp_zero;
         _temp_filtered = _temp_filter.apply(temp);
     }
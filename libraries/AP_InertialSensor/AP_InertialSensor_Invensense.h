@@ -147,6 +147,10 @@ private:
     // buffer for fifo read
     uint8_t *_fifo_buffer;
 
+    // converted samples from one fifo read
+    Vector3f *_accel_samples;
+    Vector3f *_gyro_samples;
+
     /*
       accumulators for sensor_rate sampling
       See description in _accumulate_sensor_rate_sampling()
@@ -286,3 +286,26 @@ void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSenso
 
     data_write_offset++; // may unblock the reading process
 }
+
+/*
+  add a block of consecutive samples, checking the logging conditions
+  once for the whole block
+ */
+void AP_InertialSensor::BatchSampler::sample_block(uint8_t _instance, AP_InertialSensor::IMU_SENSOR_TYPE _type, uint64_t first_sample_us, const Vector3f *_samples, uint8_t n)
+{
+    if (!should_log(_instance, _type)) {
+        return;
+    }
+    if (data_write_offset == 0) {
+        measurement_started_us = first_sample_us;
+    }
+
+    const uint16_t count = MIN(n, _required_count - data_write_offset);
+    for (uint16_t i = 0; i < count; i++) {
+        data_x[data_write_offset+i] = multiplier*_samples[i].x;
+        data_y[data_write_offset+i] = multiplier*_samples[i].y;
+        data_z[data_write_offset+i] = multiplier*_samples[i].z;
+    }
+
+    data_write_offset += count; // may unblock the reading process
+}
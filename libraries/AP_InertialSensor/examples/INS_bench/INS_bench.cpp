@@ -0,0 +1,130 @@
+//
+// Benchmark of the per-sample and block sample notification paths of
+// AP_InertialSensor_Backend. A simulated FIFO sensor feeds the same
+// data through both paths and the cost per sample is printed. On x86
+// (e.g. SITL) the cost is in TSC cycles, otherwise in microseconds.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_InertialSensor/AP_InertialSensor_Backend.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+static AP_InertialSensor ins;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_UNITS "cycles"
+static uint64_t bench_counter(void)
+{
+    return __builtin_ia32_rdtsc();
+}
+#else
+#define BENCH_UNITS "us"
+static uint64_t bench_counter(void)
+{
+    return AP_HAL::micros64();
+}
+#endif
+
+/*
+  a FIFO based sensor at 8kHz generating a vibration like signal
+ */
+class AP_InertialSensor_Bench : public AP_InertialSensor_Backend
+{
+public:
+    AP_InertialSensor_Bench(AP_InertialSensor &imu) :
+        AP_InertialSensor_Backend(imu)
+    {
+        gyro_instance = _imu.register_gyro(sample_hz,
+                                           AP_HAL::Device::make_bus_id(AP_HAL::Device::BUS_TYPE_SITL, 7, 1, DEVTYPE_SITL));
+        accel_instance = _imu.register_accel(sample_hz,
+                                             AP_HAL::Device::make_bus_id(AP_HAL::Device::BUS_TYPE_SITL, 7, 2, DEVTYPE_SITL));
+    }
+
+    bool update() override {
+        update_accel(accel_instance);
+        update_gyro(gyro_instance);
+        return true;
+    }
+
+    // return cost per sample of notifying nblocks blocks of block_size samples
+    float run(uint8_t block_size, uint16_t nblocks, bool batched);
+
+    static const uint8_t max_block = 32;
+
+private:
+    static const uint16_t sample_hz = 8000;
+
+    void generate(uint8_t n);
+
+    uint8_t gyro_instance;
+    uint8_t accel_instance;
+    float phase;
+    Vector3f gyros[max_block];
+    Vector3f accels[max_block];
+};
+
+void AP_InertialSensor_Bench::generate(uint8_t n)
+{
+    for (uint8_t i = 0; i < n; i++) {
+        phase += 2 * M_PI * 180.0f / sample_hz;
+        if (phase > M_PI) {
+            phase -= 2 * M_PI;
+        }
+        const float s = sinf(phase);
+        gyros[i] = Vector3f(0.3f * s, -0.2f * s, 0.1f * s);
+        accels[i] = Vector3f(2.0f * s, -1.5f * s, -GRAVITY_MSS + s);
+    }
+}
+
+float AP_InertialSensor_Bench::run(uint8_t block_size, uint16_t nblocks, bool batched)
+{
+    uint64_t total = 0;
+    for (uint16_t b = 0; b < nblocks; b++) {
+        generate(block_size);
+        const uint64_t start = bench_counter();
+        if (batched) {
+            _notify_new_accel_raw_samples(accel_instance, accels, block_size);
+            _notify_new_gyro_raw_samples(gyro_instance, gyros, block_size);
+        } else {
+            for (uint8_t i = 0; i < block_size; i++) {
+                _notify_new_accel_raw_sample(accel_instance, accels[i]);
+                _notify_new_gyro_raw_sample(gyro_instance, gyros[i]);
+            }
+        }
+        total += bench_counter() - start;
+        update();
+    }
+    return total / float(uint32_t(nblocks) * block_size);
+}
+
+static AP_InertialSensor_Bench *bench;
+
+void setup(void)
+{
+    hal.console->printf("INS sample notification benchmark\n");
+    bench = new AP_InertialSensor_Bench(ins);
+    // setup filter cutoffs
+    bench->update();
+}
+
+void loop(void)
+{
+    const uint8_t block_sizes[] = { 1, 4, 8, 16, AP_InertialSensor_Bench::max_block };
+    const uint16_t nblocks = 2000;
+
+    hal.console->printf("\n%6s %12s %12s (%s per sample)\n", "block", "per-sample", "batched", BENCH_UNITS);
+    for (uint8_t i = 0; i < ARRAY_SIZE(block_sizes); i++) {
+        const uint8_t n = block_sizes[i];
+        const float single = bench->run(n, nblocks, false);
+        const float batched = bench->run(n, nblocks, true);
+        hal.console->printf("%6u %12.1f %12.1f\n", n, (double)single, (double)batched);
+    }
+    hal.scheduler->delay(5000);
+}
+
+AP_HAL_MAIN();
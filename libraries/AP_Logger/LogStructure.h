@@ -1240,6 +1240,16 @@ struct PACKED log_Arm_Disarm {
     uint8_t method;
 };
 
+// time taken by a pre-arm check, logged when the check's result
+// changes or it is slow
+struct PACKED log_Arm_Check {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t  check;
+    uint8_t  passed;
+    uint32_t check_time_us;
+};
+
 // FMT messages define all message formats other than FMT
 // UNIT messages define units which can be referenced by FMTU messages
 // FMTU messages associate types (e.g. centimeters/second/second) to FMT message fields
@@ -1546,6 +1556,8 @@ struct PACKED log_Arm_Disarm {
       "EV",   "QB",           "TimeUS,Id", "s-", "F-" }, \
     { LOG_ARM_DISARM_MSG, sizeof(log_Arm_Disarm), \
       "ARM", "QBHBB", "TimeUS,ArmState,ArmChecks,Forced,Method", "s----", "F----" }, \
+    { LOG_ARM_CHECK_MSG, sizeof(log_Arm_Check), \
+      "ARMT", "QBBI", "TimeUS,Chk,Pass,T", "s#-s", "F--F" }, \
     { LOG_ERROR_MSG, sizeof(log_Error), \
       "ERR",   "QBB",         "TimeUS,Subsys,ECode", "s--", "F--" }
 
@@ -1699,6 +1711,7 @@ enum LogMessages : uint8_t {
     LOG_ARM_DISARM_MSG,
     LOG_OA_BENDYRULER_MSG,
     LOG_OA_DIJKSTRA_MSG,
+    LOG_ARM_CHECK_MSG,
 
     _LOG_LAST_MSG_
 };
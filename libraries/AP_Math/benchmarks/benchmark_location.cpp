@@ -0,0 +1,98 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Common/Location.h>
+
+static const uint16_t num_locations = 100;
+
+// a survey grid around a vehicle, as used by fences and path planners
+static void make_grid(Location &origin, Location *locs)
+{
+    origin = Location(-353632620, 1491652370, 58400, Location::AltFrame::ABSOLUTE);
+    for (uint16_t i = 0; i < num_locations; i++) {
+        locs[i] = origin;
+        locs[i].offset((i / 10) * 50.0f - 250.0f, (i % 10) * 50.0f - 250.0f);
+    }
+}
+
+static void BM_LocationDistanceNE(benchmark::State& state)
+{
+    Location origin;
+    Location locs[num_locations];
+    make_grid(origin, locs);
+    Vector2f ne[num_locations];
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < num_locations; i++) {
+            ne[i] = origin.get_distance_NE(locs[i]);
+        }
+        gbenchmark_escape(ne);
+    }
+}
+
+BENCHMARK(BM_LocationDistanceNE);
+
+static void BM_LocationDistanceNEBatch(benchmark::State& state)
+{
+    Location origin;
+    Location locs[num_locations];
+    make_grid(origin, locs);
+    Vector2f ne[num_locations];
+
+    while (state.KeepRunning()) {
+        origin.get_distance_NE(locs, num_locations, ne);
+        gbenchmark_escape(ne);
+    }
+}
+
+BENCHMARK(BM_LocationDistanceNEBatch);
+
+static void BM_LocationDistance(benchmark::State& state)
+{
+    Location origin;
+    Location locs[num_locations];
+    make_grid(origin, locs);
+    float dist[num_locations];
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < num_locations; i++) {
+            dist[i] = origin.get_distance(locs[i]);
+        }
+        gbenchmark_escape(dist);
+    }
+}
+
+BENCHMARK(BM_LocationDistance);
+
+static void BM_LocationDistanceBatch(benchmark::State& state)
+{
+    Location origin;
+    Location locs[num_locations];
+    make_grid(origin, locs);
+    float dist[num_locations];
+
+    while (state.KeepRunning()) {
+        origin.get_distance(locs, num_locations, dist);
+        gbenchmark_escape(dist);
+    }
+}
+
+BENCHMARK(BM_LocationDistanceBatch);
+
+static void BM_LocationDistanceNEDouble(benchmark::State& state)
+{
+    Location origin;
+    Location locs[num_locations];
+    make_grid(origin, locs);
+    Vector2d ne[num_locations];
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < num_locations; i++) {
+            ne[i] = origin.get_distance_NE_double(locs[i]);
+        }
+        gbenchmark_escape(ne);
+    }
+}
+
+BENCHMARK(BM_LocationDistanceNEDouble);
+
+BENCHMARK_MAIN()
@@ -1,6 +1,7 @@
 #include <AP_gbenchmark.h>
 
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/matrixN.h>
 
 static void BM_MatrixMultiplication(benchmark::State& state)
 {
@@ -19,4 +20,76 @@ static void BM_MatrixMultiplication(benchmark::State& state)
 
 BENCHMARK(BM_MatrixMultiplication);
 
+// a least squares normal matrix, as solved by the compass and accel calibrators
+template <uint8_t N>
+static MatrixN<float,N> normal_matrix(void)
+{
+    MatrixN<float,N> A;
+    for (uint8_t k = 0; k < 3*N; k++) {
+        for (uint8_t i = 0; i < N; i++) {
+            for (uint8_t j = 0; j < N; j++) {
+                A[i][j] += sinf(k + i) * sinf(k + j);
+            }
+        }
+    }
+    for (uint8_t i = 0; i < N; i++) {
+        A[i][i] += 0.1f;
+    }
+    return A;
+}
+
+static void BM_MatrixGenericInverse9(benchmark::State& state)
+{
+    const MatrixN<float,9> A = normal_matrix<9>();
+    float inv[81];
+
+    while (state.KeepRunning()) {
+        bool ok = inverse((float *)A[0], inv, 9);
+        gbenchmark_escape(&ok);
+        gbenchmark_escape(inv);
+    }
+}
+
+BENCHMARK(BM_MatrixGenericInverse9);
+
+template <uint8_t N>
+static void BM_MatrixNCholeskySolve(benchmark::State& state)
+{
+    const MatrixN<float,N> A = normal_matrix<N>();
+    VectorN<float,N> b;
+    for (uint8_t i = 0; i < N; i++) {
+        b[i] = i + 1;
+    }
+    VectorN<float,N> x;
+
+    while (state.KeepRunning()) {
+        bool ok = A.cholesky_solve(b, x);
+        gbenchmark_escape(&ok);
+        gbenchmark_escape(&x);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MatrixNCholeskySolve, 4);
+BENCHMARK_TEMPLATE(BM_MatrixNCholeskySolve, 9);
+
+template <uint8_t N>
+static void BM_MatrixNLUSolve(benchmark::State& state)
+{
+    const MatrixN<float,N> A = normal_matrix<N>();
+    VectorN<float,N> b;
+    for (uint8_t i = 0; i < N; i++) {
+        b[i] = i + 1;
+    }
+    VectorN<float,N> x;
+
+    while (state.KeepRunning()) {
+        bool ok = A.lu_solve(b, x);
+        gbenchmark_escape(&ok);
+        gbenchmark_escape(&x);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MatrixNLUSolve, 4);
+BENCHMARK_TEMPLATE(BM_MatrixNLUSolve, 9);
+
 BENCHMARK_MAIN()
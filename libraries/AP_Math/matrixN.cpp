@@ -4,6 +4,7 @@
 
 #pragma GCC optimize("O2")
 
+#include "AP_Math.h"
 #include "matrixN.h"
 
 
@@ -54,7 +55,177 @@ void MatrixN<T,N>::force_symmetry(void)
     }
 }
 
+/*
+  solve A*x = b using a Cholesky decomposition, A = L*L'. Work is
+  done in a copy on the stack so the matrix is left untouched
+ */
+template <typename T, uint8_t N>
+bool MatrixN<T,N>::cholesky_solve(const VectorN<T,N> &b, VectorN<T,N> &x) const
+{
+    T L[N][N];
+    for (uint8_t j = 0; j < N; j++) {
+        T d = v[j][j];
+        for (uint8_t k = 0; k < j; k++) {
+            d -= L[j][k] * L[j][k];
+        }
+        if (!(d > 0)) {
+            return false;
+        }
+        d = std::sqrt(d);
+        L[j][j] = d;
+        for (uint8_t i = j+1; i < N; i++) {
+            T sum = v[i][j];
+            for (uint8_t k = 0; k < j; k++) {
+                sum -= L[i][k] * L[j][k];
+            }
+            L[i][j] = sum / d;
+        }
+    }
+
+    // forward substitution with L, then back substitution with L'
+    for (uint8_t i = 0; i < N; i++) {
+        T sum = b[i];
+        for (uint8_t k = 0; k < i; k++) {
+            sum -= L[i][k] * x[k];
+        }
+        x[i] = sum / L[i][i];
+    }
+    for (int8_t i = N-1; i >= 0; i--) {
+        T sum = x[i];
+        for (uint8_t k = i+1; k < N; k++) {
+            sum -= L[k][i] * x[k];
+        }
+        x[i] = sum / L[i][i];
+    }
+    return true;
+}
+
+// LU decomposition with partial pivoting (Doolittle)
+template <typename T, uint8_t N>
+bool MatrixN<T,N>::lu_decompose(MatrixN<T,N> &LU, uint8_t pivot[N]) const
+{
+    LU = *this;
+    for (uint8_t i = 0; i < N; i++) {
+        pivot[i] = i;
+    }
+    for (uint8_t k = 0; k < N; k++) {
+        // pick the largest remaining element in the column as the pivot
+        uint8_t p = k;
+        T max = std::fabs(LU.v[k][k]);
+        for (uint8_t i = k+1; i < N; i++) {
+            const T a = std::fabs(LU.v[i][k]);
+            if (a > max) {
+                max = a;
+                p = i;
+            }
+        }
+        if (!(max > 0)) {
+            return false;
+        }
+        if (p != k) {
+            for (uint8_t j = 0; j < N; j++) {
+                const T tmp = LU.v[k][j];
+                LU.v[k][j] = LU.v[p][j];
+                LU.v[p][j] = tmp;
+            }
+            const uint8_t tmp = pivot[k];
+            pivot[k] = pivot[p];
+            pivot[p] = tmp;
+        }
+        const T inv_pivot = 1 / LU.v[k][k];
+        for (uint8_t i = k+1; i < N; i++) {
+            const T f = LU.v[i][k] * inv_pivot;
+            LU.v[i][k] = f;
+            for (uint8_t j = k+1; j < N; j++) {
+                LU.v[i][j] -= f * LU.v[k][j];
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T, uint8_t N>
+void MatrixN<T,N>::lu_substitute(const MatrixN<T,N> &LU, const uint8_t pivot[N], const T b[N], T x[N])
+{
+    for (uint8_t i = 0; i < N; i++) {
+        T sum = b[pivot[i]];
+        for (uint8_t k = 0; k < i; k++) {
+            sum -= LU.v[i][k] * x[k];
+        }
+        x[i] = sum;
+    }
+    for (int8_t i = N-1; i >= 0; i--) {
+        T sum = x[i];
+        for (uint8_t k = i+1; k < N; k++) {
+            sum -= LU.v[i][k] * x[k];
+        }
+        x[i] = sum / LU.v[i][i];
+    }
+}
+
+template <typename T, uint8_t N>
+bool MatrixN<T,N>::lu_solve(const VectorN<T,N> &b, VectorN<T,N> &x) const
+{
+    MatrixN<T,N> LU;
+    uint8_t pivot[N];
+    if (!lu_decompose(LU, pivot)) {
+        return false;
+    }
+    T bv[N], xv[N];
+    for (uint8_t i = 0; i < N; i++) {
+        bv[i] = b[i];
+    }
+    lu_substitute(LU, pivot, bv, xv);
+    for (uint8_t i = 0; i < N; i++) {
+        if (isnan(xv[i]) || isinf(xv[i])) {
+            return false;
+        }
+        x[i] = xv[i];
+    }
+    return true;
+}
+
+// invert by solving for each column of the identity
+template <typename T, uint8_t N>
+bool MatrixN<T,N>::inverse(MatrixN<T,N> &inv) const
+{
+    MatrixN<T,N> LU;
+    uint8_t pivot[N];
+    if (!lu_decompose(LU, pivot)) {
+        return false;
+    }
+    for (uint8_t j = 0; j < N; j++) {
+        T e[N] {};
+        T col[N];
+        e[j] = 1;
+        lu_substitute(LU, pivot, e, col);
+        for (uint8_t i = 0; i < N; i++) {
+            if (isnan(col[i]) || isinf(col[i])) {
+                return false;
+            }
+            inv.v[i][j] = col[i];
+        }
+    }
+    return true;
+}
+
 template void MatrixN<float,4>::mult(const VectorN<float,4> &A, const VectorN<float,4> &B);
 template MatrixN<float,4> &MatrixN<float,4>::operator -=(const MatrixN<float,4> &B);
 template MatrixN<float,4> &MatrixN<float,4>::operator +=(const MatrixN<float,4> &B);
 template void MatrixN<float,4>::force_symmetry(void);
+
+#define MATRIXN_SOLVERS(T, N) \
+    template bool MatrixN<T,N>::cholesky_solve(const VectorN<T,N> &b, VectorN<T,N> &x) const; \
+    template bool MatrixN<T,N>::lu_solve(const VectorN<T,N> &b, VectorN<T,N> &x) const; \
+    template bool MatrixN<T,N>::inverse(MatrixN<T,N> &inv) const;
+
+MATRIXN_SOLVERS(float, 3)
+MATRIXN_SOLVERS(float, 4)
+MATRIXN_SOLVERS(float, 5)
+MATRIXN_SOLVERS(float, 6)
+MATRIXN_SOLVERS(float, 7)
+MATRIXN_SOLVERS(float, 8)
+MATRIXN_SOLVERS(float, 9)
+MATRIXN_SOLVERS(double, 3)
+MATRIXN_SOLVERS(double, 4)
+MATRIXN_SOLVERS(double, 9)
@@ -6,6 +6,7 @@
 
 #include "math.h"
 #include <stdint.h>
+#include <AP_Common/AP_Common.h>
 #include "vectorN.h"
 
 template <typename T, uint8_t N>
@@ -43,6 +44,42 @@ public:
     // Matrix symmetry routine
     void force_symmetry(void);
 
+    // row access, m[i][j] is row i column j
+    inline T *operator[](uint8_t i) {
+        return v[i];
+    }
+    inline const T *operator[](uint8_t i) const {
+        return v[i];
+    }
+
+    /*
+      solve A*x = b for a symmetric positive definite matrix using a
+      Cholesky decomposition. Only the lower triangle is used. Returns
+      false if the matrix is not positive definite
+     */
+    bool cholesky_solve(const VectorN<T,N> &b, VectorN<T,N> &x) const WARN_IF_UNUSED;
+
+    /*
+      solve A*x = b using an LU decomposition with partial
+      pivoting. Returns false if the matrix is singular
+     */
+    bool lu_solve(const VectorN<T,N> &b, VectorN<T,N> &x) const WARN_IF_UNUSED;
+
+    /*
+      invert the matrix using an LU decomposition with partial
+      pivoting. Returns false if the matrix is singular
+     */
+    bool inverse(MatrixN<T,N> &inv) const WARN_IF_UNUSED;
+
 private:
+    // LU decompose into LU, L below the diagonal with an implied unit
+    // diagonal and U on and above it. pivot holds the source row of
+    // each row
+    bool lu_decompose(MatrixN<T,N> &LU, uint8_t pivot[N]) const;
+
+    // solve using a decomposition from lu_decompose()
+    static void lu_substitute(const MatrixN<T,N> &LU, const uint8_t pivot[N], const T b[N], T x[N]);
+
+
     T v[N][N];
 };
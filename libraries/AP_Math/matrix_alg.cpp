@@ -25,6 +25,7 @@
 #endif
 
 #include <AP_Math/AP_Math.h>
+#include "matrixN.h"
 
 extern const AP_HAL::HAL& hal;
 
@@ -422,6 +423,22 @@ bool inverse4x4(float m[],float invOut[])
     return true;
 }
 
+/*
+ *    matrix inverse for fixed sizes, working on the stack
+ */
+template <uint8_t N>
+static bool mat_inverse_fixed(const float *x, float *y)
+{
+    MatrixN<float,N> m;
+    MatrixN<float,N> inv;
+    memcpy(m[0], x, sizeof(float)*N*N);
+    if (!m.inverse(inv)) {
+        return false;
+    }
+    memcpy(y, inv[0], sizeof(float)*N*N);
+    return true;
+}
+
 /*
  *    generic matrix inverse code
  *
@@ -435,6 +452,11 @@ bool inverse(float x[], float y[], uint16_t dim)
     switch(dim){
         case 3: return inverse3x3(x,y);
         case 4: return inverse4x4(x,y);
+        case 5: return mat_inverse_fixed<5>(x,y);
+        case 6: return mat_inverse_fixed<6>(x,y);
+        case 7: return mat_inverse_fixed<7>(x,y);
+        case 8: return mat_inverse_fixed<8>(x,y);
+        case 9: return mat_inverse_fixed<9>(x,y);
         default: return mat_inverse(x,y,dim);
     }
 }
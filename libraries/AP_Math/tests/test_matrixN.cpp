@@ -0,0 +1,157 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/matrixN.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// a well conditioned symmetric positive definite matrix built from a
+// deterministic pseudo-random jacobian, as in a least squares fit
+template <uint8_t N>
+static MatrixN<float,N> make_spd(uint32_t seed)
+{
+    MatrixN<float,N> A;
+    for (uint8_t k = 0; k < 3*N; k++) {
+        float jacob[N];
+        for (uint8_t i = 0; i < N; i++) {
+            seed = seed * 1103515245U + 12345U;
+            jacob[i] = ((seed >> 16) & 0x7FFF) / 32768.0f - 0.5f;
+        }
+        for (uint8_t i = 0; i < N; i++) {
+            for (uint8_t j = 0; j < N; j++) {
+                A[i][j] += jacob[i] * jacob[j];
+            }
+        }
+    }
+    for (uint8_t i = 0; i < N; i++) {
+        A[i][i] += 0.1f;
+    }
+    return A;
+}
+
+template <uint8_t N>
+static float max_residual(const MatrixN<float,N> &A, const VectorN<float,N> &b, const VectorN<float,N> &x)
+{
+    float max = 0;
+    for (uint8_t i = 0; i < N; i++) {
+        float r = -b[i];
+        for (uint8_t j = 0; j < N; j++) {
+            r += A[i][j] * x[j];
+        }
+        max = MAX(max, fabsf(r));
+    }
+    return max;
+}
+
+TEST(MatrixNTest, CholeskySolve)
+{
+    const MatrixN<float,4> A4 = make_spd<4>(1);
+    const float b4v[4] {1, -2, 3, 0.5};
+    const VectorN<float,4> b4(b4v);
+    VectorN<float,4> x4;
+    EXPECT_TRUE(A4.cholesky_solve(b4, x4));
+    EXPECT_LT(max_residual(A4, b4, x4), 1.0e-4f);
+
+    const MatrixN<float,9> A9 = make_spd<9>(2);
+    const float b9v[9] {1, 2, 3, 4, 5, -6, -7, -8, -9};
+    const VectorN<float,9> b9(b9v);
+    VectorN<float,9> x9;
+    EXPECT_TRUE(A9.cholesky_solve(b9, x9));
+    EXPECT_LT(max_residual(A9, b9, x9), 1.0e-4f);
+}
+
+TEST(MatrixNTest, CholeskyUsesLowerTriangle)
+{
+    const MatrixN<float,9> A = make_spd<9>(3);
+    MatrixN<float,9> lower = A;
+    for (uint8_t i = 0; i < 9; i++) {
+        for (uint8_t j = i+1; j < 9; j++) {
+            lower[i][j] = 0;
+        }
+    }
+    const float bv[9] {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    const VectorN<float,9> b(bv);
+    VectorN<float,9> x1, x2;
+    EXPECT_TRUE(A.cholesky_solve(b, x1));
+    EXPECT_TRUE(lower.cholesky_solve(b, x2));
+    for (uint8_t i = 0; i < 9; i++) {
+        EXPECT_FLOAT_EQ(x1[i], x2[i]);
+    }
+}
+
+TEST(MatrixNTest, CholeskyNotPositiveDefinite)
+{
+    const float d[4] {1, 2, -1, 3};
+    const MatrixN<float,4> A(d);
+    const float bv[4] {1, 1, 1, 1};
+    VectorN<float,4> x;
+    EXPECT_FALSE(A.cholesky_solve(VectorN<float,4>(bv), x));
+}
+
+TEST(MatrixNTest, LUSolveNeedsPivot)
+{
+    // zero leading element, fails without row exchanges
+    MatrixN<float,3> A;
+    A[0][0] = 0; A[0][1] = 2; A[0][2] = 1;
+    A[1][0] = 1; A[1][1] = 1; A[1][2] = 0;
+    A[2][0] = 3; A[2][1] = 0; A[2][2] = 4;
+    const float bv[3] {6, 3, 11};
+    const VectorN<float,3> b(bv);
+    VectorN<float,3> x;
+    EXPECT_TRUE(A.lu_solve(b, x));
+    EXPECT_NEAR(1.0f, x[0], 1.0e-5f);
+    EXPECT_NEAR(2.0f, x[1], 1.0e-5f);
+    EXPECT_NEAR(2.0f, x[2], 1.0e-5f);
+}
+
+TEST(MatrixNTest, Inverse)
+{
+    const MatrixN<float,9> A = make_spd<9>(4);
+    MatrixN<float,9> inv;
+    EXPECT_TRUE(A.inverse(inv));
+    for (uint8_t i = 0; i < 9; i++) {
+        for (uint8_t j = 0; j < 9; j++) {
+            float sum = 0;
+            for (uint8_t k = 0; k < 9; k++) {
+                sum += A[i][k] * inv[k][j];
+            }
+            EXPECT_NEAR(i == j ? 1.0f : 0.0f, sum, 1.0e-4f);
+        }
+    }
+}
+
+TEST(MatrixNTest, InverseSingular)
+{
+    MatrixN<float,5> A;
+    for (uint8_t i = 0; i < 5; i++) {
+        for (uint8_t j = 0; j < 5; j++) {
+            A[i][j] = i + j;
+        }
+    }
+    // rank 2, elimination leaves an exact zero pivot
+    MatrixN<float,5> inv;
+    EXPECT_FALSE(A.inverse(inv));
+
+    MatrixN<float,5> zero;
+    EXPECT_FALSE(zero.inverse(inv));
+}
+
+// the generic inverse() uses the fixed size solvers from 5 to 9
+TEST(MatrixNTest, GenericInverse)
+{
+    const MatrixN<float,6> A = make_spd<6>(5);
+    float a[36], inv[36];
+    memcpy(a, A[0], sizeof(a));
+    EXPECT_TRUE(inverse(a, inv, 6));
+    for (uint8_t i = 0; i < 6; i++) {
+        for (uint8_t j = 0; j < 6; j++) {
+            float sum = 0;
+            for (uint8_t k = 0; k < 6; k++) {
+                sum += a[i*6+k] * inv[k*6+j];
+            }
+            EXPECT_NEAR(i == j ? 1.0f : 0.0f, sum, 1.0e-4f);
+        }
+    }
+}
+
+AP_GTEST_MAIN()
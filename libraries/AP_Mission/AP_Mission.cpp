@@ -27,7 +27,7 @@ const AP_Param::GroupInfo AP_Mission::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Mission options bitmask
     // @Description: Bitmask of what options to use in missions.
-    // @Bitmask: 0:Clear Mission on reboot, 1:Use distance to land calc on battery failsafe
+    // @Bitmask: 0:Clear Mission on reboot, 1:Use distance to land calc on battery failsafe, 2:Store mission in a file on the SD card (reboot required)
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Mission, _options, AP_MISSION_OPTIONS_DEFAULT),
 
@@ -52,6 +52,32 @@ void AP_Mission::init()
     // command list will be cleared if they do not match
     check_eeprom_version();
 
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_options & AP_MISSION_MASK_FILE_STORAGE) {
+        // a high capacity mission in a file replaces StorageMission
+        bool existing;
+        _file_store = new AP_Mission_FileStore();
+        if (_file_store == nullptr || !_file_store->init(existing)) {
+            delete _file_store;
+            _file_store = nullptr;
+            gcs().send_text(MAV_SEVERITY_WARNING, "Mission: file storage failed");
+        } else if (!existing) {
+            _cmd_total.set_and_save(0);
+        }
+    }
+#endif
+
+    // a mission may have been saved with a larger store
+    if ((unsigned)_cmd_total > num_commands_max()) {
+        truncate(num_commands_max());
+    }
+
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    // the cache is optional, without it commands are read from storage
+    _cmd_cache = new Mission_Command[AP_MISSION_CMD_CACHE_SIZE];
+    invalidate_cmd_cache();
+#endif
+
     // If Mission Clear bit is set then it should clear the mission, otherwise retain the mission.
     if (AP_MISSION_MASK_MISSION_CLEAR & _options) {
     	gcs().send_text(MAV_SEVERITY_INFO, "Clearing Mission");
@@ -71,6 +97,10 @@ void AP_Mission::start()
     
     // advance to the first command
     if (!advance_current_nav_cmd()) {
+        if (storage_busy()) {
+            // update() advances once the command has been loaded
+            return;
+        }
         // on failure set mission complete
         complete();
     }
@@ -105,6 +135,17 @@ void AP_Mission::resume()
 
     // ensure cache coherence
     if (!read_cmd_from_storage(_nav_cmd.index, _nav_cmd)) {
+        if (storage_busy()) {
+            // the command is still being loaded from file storage,
+            // restart the copies held in RAM
+            if (_flags.do_cmd_loaded && _do_cmd.index != AP_MISSION_CMD_INDEX_NONE) {
+                start_command(_do_cmd);
+            }
+            if (_flags.nav_cmd_loaded) {
+                start_command(_nav_cmd);
+            }
+            return;
+        }
         // if we failed to read the command from storage, then the command may have
         // been from a previously loaded mission it is illogical to ever resume
         // flying to a command that has been excluded from the current mission
@@ -196,6 +237,14 @@ bool AP_Mission::clear()
 
     // remove all commands
     _cmd_total.set_and_save(0);
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_file_store != nullptr) {
+        _file_store->clear();
+    }
+#endif
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    invalidate_cmd_cache();
+#endif
 
     // clear index to commands
     _nav_cmd.index = AP_MISSION_CMD_INDEX_NONE;
@@ -230,8 +279,16 @@ void AP_Mission::update()
 
     // check if we have an active nav command
     if (!_flags.nav_cmd_loaded || _nav_cmd.index == AP_MISSION_CMD_INDEX_NONE) {
-        // advance in mission if no active nav command
+        // advance in mission if no active nav command, once the
+        // commands are in RAM
+        if (!storage_ready(_nav_cmd.index == AP_MISSION_CMD_INDEX_NONE ? AP_MISSION_FIRST_REAL_COMMAND : _nav_cmd.index+1)) {
+            return;
+        }
         if (!advance_current_nav_cmd()) {
+            if (storage_busy()) {
+                // retry on the next update
+                return;
+            }
             // failure to advance nav command means mission has completed
             complete();
             return;
@@ -241,8 +298,15 @@ void AP_Mission::update()
         if (verify_command(_nav_cmd)) {
             // market _nav_cmd as complete (it will be started on the next iteration)
             _flags.nav_cmd_loaded = false;
+            // the next update advances if the commands are not in RAM yet
+            if (!storage_ready(_nav_cmd.index+1)) {
+                return;
+            }
             // immediately advance to the next mission command
             if (!advance_current_nav_cmd()) {
+                if (storage_busy()) {
+                    return;
+                }
                 // failure to advance nav command means mission has completed
                 complete();
                 return;
@@ -397,6 +461,12 @@ int32_t AP_Mission::get_next_ground_course_cd(int32_t default_angle)
 // set_current_cmd - jumps to command specified by index
 bool AP_Mission::set_current_cmd(uint16_t index)
 {
+    // nothing is changed while the commands are being loaded from
+    // file storage, the caller can retry
+    if (!storage_ready(index == 0 ? AP_MISSION_FIRST_REAL_COMMAND : index)) {
+        return false;
+    }
+
     // read command to check for DO_LAND_START
     Mission_Command cmd;
     if (!read_cmd_from_storage(index, cmd) || (cmd.id != MAV_CMD_DO_LAND_START)) {
@@ -530,22 +600,44 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    Mission_Command *cached = nullptr;
+    if (_cmd_cache != nullptr) {
+        cached = &_cmd_cache[index % AP_MISSION_CMD_CACHE_SIZE];
+        if (cached->index == index) {
+            cmd = *cached;
+            return true;
+        }
+    }
+#endif
+
     // Find out proper location in memory by using the start_byte position + the index
     // we can load a command, we don't process it yet
     // read WP position
-    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    uint8_t rec[AP_MISSION_EEPROM_COMMAND_SIZE];
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_file_store != nullptr) {
+        if (!_file_store->read_record(index, rec)) {
+            return false;
+        }
+    } else
+#endif
+    {
+        const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+        _storage.read_block(rec, pos_in_storage, sizeof(rec));
+    }
 
     PackedContent packed_content {};
 
-    const uint8_t b1 = _storage.read_byte(pos_in_storage);
+    const uint8_t b1 = rec[0];
     if (b1 == 0) {
-        cmd.id = _storage.read_uint16(pos_in_storage+1);
-        cmd.p1 = _storage.read_uint16(pos_in_storage+3);
-        _storage.read_block(packed_content.bytes, pos_in_storage+5, 10);
+        memcpy(&cmd.id, &rec[1], 2);
+        memcpy(&cmd.p1, &rec[3], 2);
+        memcpy(packed_content.bytes, &rec[5], 10);
     } else {
         cmd.id = b1;
-        cmd.p1 = _storage.read_uint16(pos_in_storage+1);
-        _storage.read_block(packed_content.bytes, pos_in_storage+3, 12);
+        memcpy(&cmd.p1, &rec[1], 2);
+        memcpy(packed_content.bytes, &rec[3], 12);
     }
 
     if (stored_in_location(cmd.id)) {
@@ -577,10 +669,36 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    if (cached != nullptr) {
+        *cached = cmd;
+    }
+#endif
+
     // return success
     return true;
 }
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+/// invalidate_cmd_cache - forget the decoded copy of a command, or all
+///     commands if index is AP_MISSION_CMD_INDEX_NONE
+void AP_Mission::invalidate_cmd_cache(uint16_t index)
+{
+    WITH_SEMAPHORE(_rsem);
+
+    if (_cmd_cache == nullptr) {
+        return;
+    }
+    if (index != AP_MISSION_CMD_INDEX_NONE) {
+        _cmd_cache[index % AP_MISSION_CMD_CACHE_SIZE].index = AP_MISSION_CMD_INDEX_NONE;
+        return;
+    }
+    for (uint16_t i=0; i<AP_MISSION_CMD_CACHE_SIZE; i++) {
+        _cmd_cache[i].index = AP_MISSION_CMD_INDEX_NONE;
+    }
+}
+#endif
+
 bool AP_Mission::stored_in_location(uint16_t id)
 {
     switch (id) {
@@ -637,19 +755,36 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         memcpy(packed.bytes, &cmd.content, 12);
     }
 
-    // calculate where in storage the command should be placed
-    uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    // the stored form may differ from cmd (e.g. 16 bit ids keep only
+    // 10 bytes of content) so re-decode on the next read
+    invalidate_cmd_cache(index);
+#endif
 
+    uint8_t rec[AP_MISSION_EEPROM_COMMAND_SIZE];
     if (cmd.id < 256) {
-        _storage.write_byte(pos_in_storage, cmd.id);
-        _storage.write_uint16(pos_in_storage+1, cmd.p1);
-        _storage.write_block(pos_in_storage+3, packed.bytes, 12);
+        rec[0] = cmd.id;
+        memcpy(&rec[1], &cmd.p1, 2);
+        memcpy(&rec[3], packed.bytes, 12);
     } else {
         // if the command ID is above 256 we store a 0 followed by the 16 bit command ID
-        _storage.write_byte(pos_in_storage, 0);
-        _storage.write_uint16(pos_in_storage+1, cmd.id);
-        _storage.write_uint16(pos_in_storage+3, cmd.p1);
-        _storage.write_block(pos_in_storage+5, packed.bytes, 10);
+        rec[0] = 0;
+        memcpy(&rec[1], &cmd.id, 2);
+        memcpy(&rec[3], &cmd.p1, 2);
+        memcpy(&rec[5], packed.bytes, 10);
+    }
+
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_file_store != nullptr) {
+        if (!_file_store->write_record(index, rec, cmd.id < 256 && stored_in_location(cmd.id))) {
+            return false;
+        }
+    } else
+#endif
+    {
+        // calculate where in storage the command should be placed
+        const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+        _storage.write_block(pos_in_storage, rec, sizeof(rec));
     }
 
     // remember when the mission last changed
@@ -1580,8 +1715,11 @@ void AP_Mission::advance_current_do_cmd()
     // find next do command
     Mission_Command cmd;
     if (!get_next_do_cmd(cmd_index, cmd)) {
-        // set flag to stop unnecessarily searching for do commands
-        _flags.do_cmd_all_done = true;
+        // set flag to stop unnecessarily searching for do commands,
+        // unless the command is still being loaded from file storage
+        if (!storage_busy()) {
+            _flags.do_cmd_all_done = true;
+        }
         return;
     }
 
@@ -1591,6 +1729,22 @@ void AP_Mission::advance_current_do_cmd()
     start_command(_do_cmd);
 }
 
+/// storage_ready - true unless the commands needed to advance from
+///     start_index are still being loaded from file storage. Looks
+///     ahead without starting commands or counting jumps, so a command
+///     not yet in RAM delays the advance instead of ending the mission
+bool AP_Mission::storage_ready(uint16_t start_index)
+{
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_file_store != nullptr) {
+        Mission_Command cmd;
+        get_next_nav_cmd(start_index, cmd);
+        return !_file_store->busy();
+    }
+#endif
+    return true;
+}
+
 /// get_next_cmd - gets next command found at or after start_index
 ///     returns true if found, false if not found (i.e. mission complete)
 ///     accounts for do_jump commands
@@ -1780,10 +1934,27 @@ void AP_Mission::check_eeprom_version()
  */
 uint16_t AP_Mission::num_commands_max(void) const
 {
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_file_store != nullptr) {
+        return _file_store->num_records_max();
+    }
+#endif
     // -4 to remove space for eeprom version number
     return (_storage.size() - 4) / AP_MISSION_EEPROM_COMMAND_SIZE;
 }
 
+/// storage_busy - true if a failed command read or write is waiting for
+///     file storage to load the command into RAM
+bool AP_Mission::storage_busy() const
+{
+#if AP_MISSION_FILE_STORE_ENABLED
+    if (_file_store != nullptr) {
+        return _file_store->busy();
+    }
+#endif
+    return false;
+}
+
 // find the nearest landing sequence starting point (DO_LAND_START) and
 // return its index.  Returns 0 if no appropriate DO_LAND_START point can
 // be found.
@@ -19,6 +19,7 @@
 #include <AP_Common/Location.h>
 #include <AP_Param/AP_Param.h>
 #include <StorageManager/StorageManager.h>
+#include "AP_Mission_FileStore.h"
 
 // definitions
 #define AP_MISSION_EEPROM_VERSION           0x65AE  // version number stored in first four bytes of eeprom.  increment this by one when eeprom format is changed
@@ -39,6 +40,18 @@
 #define AP_MISSION_OPTIONS_DEFAULT          0       // Do not clear the mission when rebooting
 #define AP_MISSION_MASK_MISSION_CLEAR       (1<<0)  // If set then Clear the mission on boot
 #define AP_MISSION_MASK_DIST_TO_LAND_CALC   (1<<1)  // Allow distance to best landing calculation to be run on failsafe
+#define AP_MISSION_MASK_FILE_STORAGE        (1<<2)  // Store the mission in a file on AP_Filesystem instead of StorageMission
+
+// number of decoded commands kept in RAM to save re-reading and decoding storage on mission advance and look-ahead
+#ifndef AP_MISSION_CMD_CACHE_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MISSION_CMD_CACHE_SIZE           128
+#elif HAL_MEM_CLASS >= HAL_MEM_CLASS_192
+#define AP_MISSION_CMD_CACHE_SIZE           32
+#else
+#define AP_MISSION_CMD_CACHE_SIZE           0
+#endif
+#endif
 
 /// @class    AP_Mission
 /// @brief    Object managing Mission
@@ -340,6 +353,10 @@ public:
     /// num_commands_max - returns maximum number of commands that can be stored
     uint16_t num_commands_max() const;
 
+    /// storage_busy - true if a failed command read or write is waiting
+    ///     for file storage to load the command into RAM and can be retried later
+    bool storage_busy() const;
+
     /// start - resets current commands to point to the beginning of the mission
     ///     To-Do: should we validate the mission first and return true/false?
     void start();
@@ -496,6 +513,11 @@ private:
 
     static StorageAccess _storage;
 
+#if AP_MISSION_FILE_STORE_ENABLED
+    // high capacity store used in place of _storage when enabled
+    AP_Mission_FileStore *_file_store;
+#endif
+
     static bool stored_in_location(uint16_t id);
 
     struct Mission_Flags {
@@ -523,6 +545,10 @@ private:
     //      returns true if command is advanced, false if failed (i.e. mission completed)
     bool advance_current_nav_cmd(uint16_t starting_index = 0);
 
+    /// storage_ready - true unless the commands needed to advance from
+    ///     start_index are still being loaded from file storage
+    bool storage_ready(uint16_t start_index);
+
     /// advance_current_do_cmd - moves current do command forward
     ///     accounts for do-jump commands
     ///     returns true if successfully advanced (can it ever be unsuccessful?)
@@ -596,6 +622,19 @@ private:
     // const functions
     static HAL_Semaphore _rsem;
 
+#if AP_MISSION_CMD_CACHE_SIZE > 0
+    // direct mapped cache of decoded commands, slot is index modulo
+    // the cache size. Walking the mission keeps a window of commands
+    // around the current index, including any DO_JUMP commands
+    // followed from there. A slot with an index of
+    // AP_MISSION_CMD_INDEX_NONE is empty
+    mutable Mission_Command *_cmd_cache = nullptr;
+
+    // invalidate the cached copy of a command, or of all commands if
+    // index is AP_MISSION_CMD_INDEX_NONE
+    void invalidate_cmd_cache(uint16_t index = AP_MISSION_CMD_INDEX_NONE);
+#endif
+
     // mission items common to all vehicles:
     bool start_command_do_gripper(const AP_Mission::Mission_Command& cmd);
     bool start_command_do_servorelayevents(const AP_Mission::Mission_Command& cmd);
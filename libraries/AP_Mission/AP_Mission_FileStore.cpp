@@ -0,0 +1,806 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  high capacity mission store in a file on AP_Filesystem
+ */
+
+#include "AP_Mission_FileStore.h"
+
+#if AP_MISSION_FILE_STORE_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Math/crc.h>
+#include <stdio.h>
+
+extern const AP_HAL::HAL& hal;
+
+#define MISSION_FILE_MAGIC   0x5346494DU // "MIFS"
+#define MISSION_FILE_VERSION 2
+
+// time with no writes before dirty blocks are written back
+#define MISSION_FILE_FLUSH_MS 200
+
+// time to wait after a failed file access before trying again
+#define MISSION_FILE_RETRY_MS 1000
+
+// the file is compacted once it is larger than this and less than
+// half of it holds the newest copy of a block
+#define MISSION_FILE_COMPACT_MIN_BYTES 16384
+
+// record encoding tag bits
+#define TAG_ID16           (1U<<0) // record uses the 16 bit command id layout
+#define TAG_P1_ZERO        (1U<<1) // p1 is zero and not stored
+#define TAG_LOCATION       (1U<<2) // content is a PackedLocation
+#define TAG_LATLNG_DELTA   (1U<<3) // lat/lng stored as int16 deltas from previous location
+#define TAG_ALT_REPEAT     (1U<<4) // alt same as previous location and not stored
+#define TAG_CONTENT_ZERO   (1U<<5) // content is all zero and not stored
+
+static_assert(AP_MISSION_FILE_BLOCK_RECORDS <= 32, "block valid mask is 32 bits");
+
+/*
+  open the newest mission file or create one
+ */
+bool AP_Mission_FileStore::init(bool &existing)
+{
+    existing = false;
+
+    for (uint8_t i=0; i<ARRAY_SIZE(_path); i++) {
+        if (asprintf(&_path[i], "%s/" AP_MISSION_FILE_NAME, HAL_BOARD_STORAGE_DIRECTORY, unsigned(i)) <= 0) {
+            _path[i] = nullptr;
+            return false;
+        }
+    }
+
+    _block_offset = new uint32_t[num_blocks];
+    _block_length = new uint16_t[num_blocks];
+    if (_block_offset == nullptr || _block_length == nullptr) {
+        return false;
+    }
+
+    for (uint8_t i=0; i<ARRAY_SIZE(_window); i++) {
+        _window[i].block_num = UINT16_MAX;
+    }
+
+    // use the complete file with the highest generation. The other
+    // file is either older or was cut short while being compacted
+    bool found = false;
+    for (uint8_t i=0; i<ARRAY_SIZE(_path); i++) {
+        const int fd = AP::FS().open(_path[i], O_RDONLY);
+        if (fd == -1) {
+            continue;
+        }
+        struct file_header hdr;
+        if (read_file_header(fd, hdr) && (!found || hdr.generation > _generation)) {
+            _file_idx = i;
+            _generation = hdr.generation;
+            found = true;
+        }
+        AP::FS().close(fd);
+    }
+
+    if (found) {
+        _fd = AP::FS().open(_path[_file_idx], O_RDWR);
+        if (_fd == -1) {
+            return false;
+        }
+        existing = scan();
+        // decode the start of the mission ahead of it being run
+        _prefetch_block = 0;
+    } else {
+        _file_idx = 0;
+        _generation = 1;
+        _fd = AP::FS().open(_path[_file_idx], O_RDWR|O_CREAT|O_TRUNC);
+        if (_fd == -1 ||
+            !write_file_header(_fd, MISSION_FILE_MAGIC, _generation) ||
+            AP::FS().fsync(_fd) != 0) {
+            return false;
+        }
+        _file_end = sizeof(file_header);
+    }
+
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_Mission_FileStore::io_timer, void));
+    return true;
+}
+
+/*
+  read the file header, returning true if it is a complete mission file
+ */
+bool AP_Mission_FileStore::read_file_header(int fd, struct file_header &hdr)
+{
+    return AP::FS().lseek(fd, 0, SEEK_SET) == 0 &&
+           AP::FS().read(fd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+           hdr.magic == MISSION_FILE_MAGIC &&
+           hdr.version == MISSION_FILE_VERSION &&
+           hdr.block_records == AP_MISSION_FILE_BLOCK_RECORDS;
+}
+
+/*
+  write the file header. A zero magic marks a file still being written
+ */
+bool AP_Mission_FileStore::write_file_header(int fd, uint32_t magic, uint32_t generation)
+{
+    const struct file_header hdr {
+        magic,
+        MISSION_FILE_VERSION,
+        AP_MISSION_FILE_BLOCK_RECORDS,
+        generation
+    };
+    return AP::FS().lseek(fd, 0, SEEK_SET) == 0 &&
+           AP::FS().write(fd, &hdr, sizeof(hdr)) == sizeof(hdr);
+}
+
+/*
+  find the newest copy of each block in the file. Returns true if the
+  file holds at least one block
+ */
+bool AP_Mission_FileStore::scan(void)
+{
+    bool found = false;
+    uint32_t offset = sizeof(file_header);
+    if (AP::FS().lseek(_fd, offset, SEEK_SET) != (off_t)offset) {
+        return false;
+    }
+    while (true) {
+        struct block_header hdr;
+        if (AP::FS().read(_fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+            hdr.block_num >= num_blocks ||
+            hdr.length > max_encoded_size ||
+            AP::FS().read(_fd, _io_buf, hdr.length) != hdr.length ||
+            crc16_ccitt(_io_buf, hdr.length, 0) != hdr.crc) {
+            // end of file, or a block cut short by a power loss which
+            // will be overwritten by the next block written
+            break;
+        }
+        if (_block_offset[hdr.block_num] != 0) {
+            _live_bytes -= _block_length[hdr.block_num];
+        }
+        _block_offset[hdr.block_num] = offset;
+        _block_length[hdr.block_num] = sizeof(hdr) + hdr.length;
+        _live_bytes += _block_length[hdr.block_num];
+        offset += sizeof(hdr) + hdr.length;
+        found = true;
+    }
+    _file_end = offset;
+    return found;
+}
+
+/*
+  encode a decoded block into buf, returning the encoded length
+ */
+uint16_t AP_Mission_FileStore::encode_block(const window &w, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    bool have_prev = false;
+    int32_t prev_lat = 0, prev_lng = 0;
+    uint8_t prev_alt[3] {};
+
+    for (uint8_t i=0; i<AP_MISSION_FILE_BLOCK_RECORDS; i++) {
+        if (!(w.valid_mask & (1U<<i))) {
+            continue;
+        }
+        const uint8_t *rec = w.records[i];
+        uint8_t *tag = p++;
+        *tag = 0;
+
+        // command id and p1
+        const uint8_t *content;
+        uint8_t content_len;
+        if (rec[0] == 0) {
+            *tag |= TAG_ID16;
+            memcpy(p, &rec[1], 2);
+            p += 2;
+            if (rec[3] == 0 && rec[4] == 0) {
+                *tag |= TAG_P1_ZERO;
+            } else {
+                memcpy(p, &rec[3], 2);
+                p += 2;
+            }
+            content = &rec[5];
+            content_len = 10;
+        } else {
+            *p++ = rec[0];
+            if (rec[1] == 0 && rec[2] == 0) {
+                *tag |= TAG_P1_ZERO;
+            } else {
+                memcpy(p, &rec[1], 2);
+                p += 2;
+            }
+            content = &rec[3];
+            content_len = 12;
+        }
+
+        if (!(*tag & TAG_ID16) && (w.location_mask & (1U<<i))) {
+            // options, 24 bit alt, lat, lng
+            *tag |= TAG_LOCATION;
+            *p++ = content[0];
+            if (have_prev && memcmp(&content[1], prev_alt, 3) == 0) {
+                *tag |= TAG_ALT_REPEAT;
+            } else {
+                memcpy(p, &content[1], 3);
+                p += 3;
+            }
+            int32_t lat, lng;
+            memcpy(&lat, &content[4], 4);
+            memcpy(&lng, &content[8], 4);
+            const int32_t dlat = lat - prev_lat;
+            const int32_t dlng = lng - prev_lng;
+            if (have_prev &&
+                dlat >= INT16_MIN && dlat <= INT16_MAX &&
+                dlng >= INT16_MIN && dlng <= INT16_MAX) {
+                *tag |= TAG_LATLNG_DELTA;
+                const int16_t d[2] { int16_t(dlat), int16_t(dlng) };
+                memcpy(p, d, 4);
+                p += 4;
+            } else {
+                memcpy(p, &content[4], 8);
+                p += 8;
+            }
+            memcpy(prev_alt, &content[1], 3);
+            prev_lat = lat;
+            prev_lng = lng;
+            have_prev = true;
+            continue;
+        }
+
+        bool zero = true;
+        for (uint8_t j=0; j<content_len; j++) {
+            if (content[j] != 0) {
+                zero = false;
+                break;
+            }
+        }
+        if (zero) {
+            *tag |= TAG_CONTENT_ZERO;
+        } else {
+            memcpy(p, content, content_len);
+            p += content_len;
+        }
+    }
+    return p - buf;
+}
+
+/*
+  decode an encoded block into w. The valid mask must already be set
+ */
+bool AP_Mission_FileStore::decode_block(window &w, const uint8_t *buf, uint16_t len)
+{
+    const uint8_t *p = buf;
+    const uint8_t *end = buf + len;
+    bool have_prev = false;
+    int32_t prev_lat = 0, prev_lng = 0;
+    uint8_t prev_alt[3] {};
+
+#define NEED(n) do { if (p + (n) > end) { return false; } } while (0)
+
+    w.location_mask = 0;
+    memset(w.records, 0, sizeof(w.records));
+    for (uint8_t i=0; i<AP_MISSION_FILE_BLOCK_RECORDS; i++) {
+        if (!(w.valid_mask & (1U<<i))) {
+            continue;
+        }
+        uint8_t *rec = w.records[i];
+        NEED(1);
+        const uint8_t tag = *p++;
+
+        uint8_t *content;
+        uint8_t content_len;
+        if (tag & TAG_ID16) {
+            NEED(2);
+            rec[0] = 0;
+            memcpy(&rec[1], p, 2);
+            p += 2;
+            if (!(tag & TAG_P1_ZERO)) {
+                NEED(2);
+                memcpy(&rec[3], p, 2);
+                p += 2;
+            }
+            content = &rec[5];
+            content_len = 10;
+        } else {
+            NEED(1);
+            rec[0] = *p++;
+            if (!(tag & TAG_P1_ZERO)) {
+                NEED(2);
+                memcpy(&rec[1], p, 2);
+                p += 2;
+            }
+            content = &rec[3];
+            content_len = 12;
+        }
+
+        if (tag & TAG_LOCATION) {
+            if (tag & TAG_ID16) {
+                return false;
+            }
+            w.location_mask |= (1U<<i);
+            NEED(1);
+            content[0] = *p++;
+            if (tag & TAG_ALT_REPEAT) {
+                if (!have_prev) {
+                    return false;
+                }
+                memcpy(&content[1], prev_alt, 3);
+            } else {
+                NEED(3);
+                memcpy(&content[1], p, 3);
+                p += 3;
+            }
+            int32_t lat, lng;
+            if (tag & TAG_LATLNG_DELTA) {
+                if (!have_prev) {
+                    return false;
+                }
+                int16_t d[2];
+                NEED(4);
+                memcpy(d, p, 4);
+                p += 4;
+                lat = prev_lat + d[0];
+                lng = prev_lng + d[1];
+            } else {
+                NEED(8);
+                memcpy(&lat, p, 4);
+                memcpy(&lng, p+4, 4);
+                p += 8;
+            }
+            memcpy(&content[4], &lat, 4);
+            memcpy(&content[8], &lng, 4);
+            memcpy(prev_alt, &content[1], 3);
+            prev_lat = lat;
+            prev_lng = lng;
+            have_prev = true;
+            continue;
+        }
+
+        if (!(tag & TAG_CONTENT_ZERO)) {
+            NEED(content_len);
+            memcpy(content, p, content_len);
+            p += content_len;
+        }
+    }
+#undef NEED
+
+    return p == end;
+}
+
+/*
+  read the encoded copy of a block at offset in the file into buf
+ */
+bool AP_Mission_FileStore::read_block(uint32_t offset, uint16_t block_num, uint8_t *buf, struct block_header &hdr)
+{
+    return AP::FS().lseek(_fd, offset, SEEK_SET) == (off_t)offset &&
+           AP::FS().read(_fd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+           hdr.block_num == block_num &&
+           hdr.length <= max_encoded_size &&
+           AP::FS().read(_fd, buf, hdr.length) == hdr.length &&
+           crc16_ccitt(buf, hdr.length, 0) == hdr.crc;
+}
+
+/*
+  load a block into the least recently used clean window. Called from
+  the IO thread, the file is read without holding _sem. Returns false
+  on a file error
+ */
+bool AP_Mission_FileStore::load_block(uint16_t block_num)
+{
+    uint32_t offset;
+    uint32_t clear_seq;
+    {
+        WITH_SEMAPHORE(_sem);
+        if (find_window(block_num) != nullptr || !on_file(block_num)) {
+            return true;
+        }
+        offset = _block_offset[block_num];
+        clear_seq = _clear_seq;
+    }
+
+    struct block_header hdr;
+    if (!read_block(offset, block_num, _io_buf, hdr)) {
+        return false;
+    }
+    _load_window.valid_mask = hdr.valid_mask;
+    if (!decode_block(_load_window, _io_buf, hdr.length)) {
+        return false;
+    }
+
+    WITH_SEMAPHORE(_sem);
+    if (clear_seq != _clear_seq || find_window(block_num) != nullptr) {
+        // cleared or written while loading
+        return true;
+    }
+    window *w = clean_window();
+    if (w == nullptr) {
+        // all windows are dirty, retried after they are written back
+        return true;
+    }
+    memcpy(w->records, _load_window.records, sizeof(w->records));
+    w->valid_mask = _load_window.valid_mask;
+    w->location_mask = _load_window.location_mask;
+    w->block_num = block_num;
+    w->last_use_ms = AP_HAL::millis();
+    return true;
+}
+
+/*
+  append a dirty window to the file. Called from the IO thread, the
+  window is encoded with _sem held and written without it
+ */
+bool AP_Mission_FileStore::write_back(window &w)
+{
+    struct block_header hdr;
+    uint16_t block_num;
+    uint32_t clear_seq;
+    {
+        WITH_SEMAPHORE(_sem);
+        if (!w.dirty) {
+            return true;
+        }
+        block_num = w.block_num;
+        hdr.block_num = block_num;
+        hdr.valid_mask = w.valid_mask;
+        hdr.length = encode_block(w, _io_buf);
+        hdr.crc = crc16_ccitt(_io_buf, hdr.length, 0);
+        clear_seq = _clear_seq;
+        // writes from now on mark the window dirty again
+        w.dirty = false;
+        w.writing = true;
+    }
+
+    const uint32_t offset = _file_end;
+    const bool ok = AP::FS().lseek(_fd, offset, SEEK_SET) == (off_t)offset &&
+                    AP::FS().write(_fd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+                    AP::FS().write(_fd, _io_buf, hdr.length) == hdr.length &&
+                    AP::FS().fsync(_fd) == 0;
+
+    WITH_SEMAPHORE(_sem);
+    const bool same = clear_seq == _clear_seq;
+    w.writing = false;
+    if (!ok) {
+        if (same && w.block_num == block_num) {
+            w.dirty = true;
+        }
+        return false;
+    }
+    _file_end += sizeof(hdr) + hdr.length;
+    if (same) {
+        if (_block_offset[block_num] != 0) {
+            _live_bytes -= _block_length[block_num];
+        }
+        _block_offset[block_num] = offset;
+        _block_length[block_num] = sizeof(hdr) + hdr.length;
+        _live_bytes += _block_length[block_num];
+    }
+    return true;
+}
+
+/*
+  copy the newest copy of each block, or nothing if empty is true, to
+  the other file and switch to it. Called from the IO thread. The
+  header magic is written last so a cut short copy is ignored at
+  startup
+ */
+bool AP_Mission_FileStore::compact(bool empty)
+{
+    uint32_t clear_seq;
+    {
+        WITH_SEMAPHORE(_sem);
+        clear_seq = _clear_seq;
+    }
+
+    const uint8_t idx = 1 - _file_idx;
+    const uint32_t generation = _generation + 1;
+    const int fd = AP::FS().open(_path[idx], O_RDWR|O_CREAT|O_TRUNC);
+    if (fd == -1) {
+        return false;
+    }
+
+    // block offsets are only changed on this thread, so are safe to
+    // read without _sem
+    bool ok = write_file_header(fd, 0, generation);
+    uint32_t file_end = sizeof(file_header);
+    for (uint16_t b=0; b<num_blocks && ok && !empty; b++) {
+        if (_block_offset[b] == 0) {
+            continue;
+        }
+        struct block_header hdr;
+        ok = read_block(_block_offset[b], b, _io_buf, hdr) &&
+             AP::FS().write(fd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+             AP::FS().write(fd, _io_buf, hdr.length) == hdr.length;
+        file_end += sizeof(hdr) + hdr.length;
+    }
+    ok = ok &&
+         AP::FS().fsync(fd) == 0 &&
+         write_file_header(fd, MISSION_FILE_MAGIC, generation) &&
+         AP::FS().fsync(fd) == 0;
+    if (!ok) {
+        AP::FS().close(fd);
+        return false;
+    }
+
+    {
+        WITH_SEMAPHORE(_sem);
+        AP::FS().close(_fd);
+        _fd = fd;
+        _file_idx = idx;
+        _generation = generation;
+        _file_end = file_end;
+        _live_bytes = file_end - sizeof(file_header);
+        if (empty) {
+            memset(_block_offset, 0, num_blocks * sizeof(_block_offset[0]));
+            if (clear_seq == _clear_seq) {
+                _clear_pending = false;
+            }
+        } else {
+            // blocks were copied in order
+            uint32_t offset = sizeof(file_header);
+            for (uint16_t b=0; b<num_blocks; b++) {
+                if (_block_offset[b] != 0) {
+                    _block_offset[b] = offset;
+                    offset += _block_length[b];
+                }
+            }
+        }
+    }
+
+    // the old file is no longer needed
+    AP::FS().unlink(_path[1-idx]);
+    return true;
+}
+
+/*
+  find the window holding a block
+ */
+AP_Mission_FileStore::window *AP_Mission_FileStore::find_window(uint16_t block_num)
+{
+    for (uint8_t i=0; i<ARRAY_SIZE(_window); i++) {
+        if (_window[i].block_num == block_num) {
+            return &_window[i];
+        }
+    }
+    return nullptr;
+}
+
+/*
+  find the least recently used window that can be reused without
+  writing it back, or nullptr if all windows are dirty
+ */
+AP_Mission_FileStore::window *AP_Mission_FileStore::clean_window(void)
+{
+    window *w = nullptr;
+    for (uint8_t i=0; i<ARRAY_SIZE(_window); i++) {
+        window &c = _window[i];
+        if (c.dirty || c.writing) {
+            continue;
+        }
+        if (c.block_num == UINT16_MAX) {
+            return &c;
+        }
+        if (w == nullptr || c.last_use_ms < w->last_use_ms) {
+            w = &c;
+        }
+    }
+    return w;
+}
+
+/*
+  get the window holding a block. This never accesses the file: a
+  block on file which is not in RAM, or a new block when there is no
+  clean window, is left for the IO thread and nullptr is returned with
+  busy() true
+ */
+AP_Mission_FileStore::window *AP_Mission_FileStore::get_window(uint16_t block_num, bool for_write)
+{
+    if (block_num >= num_blocks) {
+        return nullptr;
+    }
+
+    window *w = find_window(block_num);
+    if (w == nullptr) {
+        if (!for_write && !on_file(block_num)) {
+            // never written
+            return nullptr;
+        }
+        if (on_file(block_num) || (w = clean_window()) == nullptr) {
+            _wanted_block = block_num;
+            return nullptr;
+        }
+        w->block_num = block_num;
+        w->valid_mask = 0;
+        w->location_mask = 0;
+    }
+    if (_wanted_block == block_num) {
+        _wanted_block = UINT16_MAX;
+    }
+    w->last_use_ms = AP_HAL::millis();
+    if (for_write) {
+        w->dirty = true;
+        _last_write_ms = w->last_use_ms;
+    }
+    return w;
+}
+
+/*
+  read a record
+ */
+bool AP_Mission_FileStore::read_record(uint16_t index, uint8_t *rec)
+{
+    WITH_SEMAPHORE(_sem);
+
+    const uint16_t block_num = index / AP_MISSION_FILE_BLOCK_RECORDS;
+    const uint8_t i = index % AP_MISSION_FILE_BLOCK_RECORDS;
+    const window *w = get_window(block_num, false);
+    if (w == nullptr || !(w->valid_mask & (1U<<i))) {
+        return false;
+    }
+    memcpy(rec, w->records[i], AP_MISSION_FILE_RECORD_SIZE);
+
+    // decode the next block ahead of the mission reaching it
+    if (block_num+1U < num_blocks &&
+        on_file(block_num+1) &&
+        find_window(block_num+1) == nullptr) {
+        _prefetch_block = block_num+1;
+    }
+    return true;
+}
+
+/*
+  write a record
+ */
+bool AP_Mission_FileStore::write_record(uint16_t index, const uint8_t *rec, bool is_location)
+{
+    WITH_SEMAPHORE(_sem);
+
+    const uint16_t block_num = index / AP_MISSION_FILE_BLOCK_RECORDS;
+    const uint8_t i = index % AP_MISSION_FILE_BLOCK_RECORDS;
+    window *w = get_window(block_num, true);
+    if (w == nullptr) {
+        return false;
+    }
+    memcpy(w->records[i], rec, AP_MISSION_FILE_RECORD_SIZE);
+    w->valid_mask |= (1U<<i);
+    if (is_location) {
+        w->location_mask |= (1U<<i);
+    } else {
+        w->location_mask &= ~(1U<<i);
+    }
+    return true;
+}
+
+/*
+  discard all records. The IO thread starts a new empty file
+ */
+bool AP_Mission_FileStore::clear(void)
+{
+    WITH_SEMAPHORE(_sem);
+
+    for (uint8_t i=0; i<ARRAY_SIZE(_window); i++) {
+        _window[i].block_num = UINT16_MAX;
+        _window[i].dirty = false;
+    }
+    _prefetch_block = UINT16_MAX;
+    _wanted_block = UINT16_MAX;
+    _clear_pending = true;
+    _clear_seq++;
+    return _fd != -1;
+}
+
+/*
+  true if a failed read or write is waiting for the IO thread
+ */
+bool AP_Mission_FileStore::busy(void)
+{
+    WITH_SEMAPHORE(_sem);
+    return _wanted_block != UINT16_MAX && !_io_failure;
+}
+
+/*
+  record the result of a file access. After a failure file access is
+  retried after MISSION_FILE_RETRY_MS, and blocks in RAM can still be
+  used meanwhile
+ */
+void AP_Mission_FileStore::io_result(bool ok)
+{
+    WITH_SEMAPHORE(_sem);
+    _io_failure = !ok;
+    if (!ok) {
+        _io_fail_ms = AP_HAL::millis();
+    }
+}
+
+/*
+  start a new file after a clear, write back dirty blocks, load the
+  block a caller is waiting for or the next block ahead of the mission
+  and compact the file
+ */
+void AP_Mission_FileStore::io_timer(void)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    bool clear_pending;
+    bool waiting;
+    {
+        WITH_SEMAPHORE(_sem);
+        if (_io_failure && now_ms - _io_fail_ms < MISSION_FILE_RETRY_MS) {
+            return;
+        }
+        clear_pending = _clear_pending;
+        waiting = _wanted_block != UINT16_MAX;
+    }
+
+    if (clear_pending) {
+        const bool ok = compact(true);
+        io_result(ok);
+        if (!ok) {
+            return;
+        }
+    }
+
+    // write back once writes stop, or at once if a caller may be
+    // waiting for a clean window
+    for (uint8_t i=0; i<ARRAY_SIZE(_window); i++) {
+        bool write;
+        {
+            WITH_SEMAPHORE(_sem);
+            write = _window[i].dirty && (waiting || now_ms - _last_write_ms >= MISSION_FILE_FLUSH_MS);
+        }
+        if (write) {
+            const bool ok = write_back(_window[i]);
+            io_result(ok);
+            if (!ok) {
+                return;
+            }
+        }
+    }
+
+    uint16_t block_num;
+    {
+        WITH_SEMAPHORE(_sem);
+        block_num = _wanted_block;
+        if (block_num == UINT16_MAX) {
+            block_num = _prefetch_block;
+            _prefetch_block = UINT16_MAX;
+        }
+    }
+    if (block_num != UINT16_MAX) {
+        const bool ok = load_block(block_num);
+        io_result(ok);
+        if (!ok) {
+            return;
+        }
+        WITH_SEMAPHORE(_sem);
+        if (_wanted_block == block_num &&
+            (find_window(block_num) != nullptr || (!on_file(block_num) && clean_window() != nullptr))) {
+            // the caller can now retry
+            _wanted_block = UINT16_MAX;
+        }
+        return;
+    }
+
+    bool compact_now;
+    {
+        WITH_SEMAPHORE(_sem);
+        compact_now = !_clear_pending &&
+                      _file_end > MISSION_FILE_COMPACT_MIN_BYTES &&
+                      _live_bytes < (_file_end - sizeof(file_header)) / 2;
+        for (uint8_t i=0; i<ARRAY_SIZE(_window); i++) {
+            if (_window[i].dirty) {
+                compact_now = false;
+            }
+        }
+    }
+    if (compact_now) {
+        io_result(compact(false));
+    }
+}
+
+#endif // AP_MISSION_FILE_STORE_ENABLED
@@ -0,0 +1,191 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  high capacity mission store in a file on AP_Filesystem
+
+  Commands are handled as the same 15 byte records used in
+  StorageMission. Records are grouped into blocks of
+  AP_MISSION_FILE_BLOCK_RECORDS commands and each block is written to
+  the file with a compact encoding: small command ids and zero p1 and
+  altitude repeats take no space, and waypoint lat/lon are stored as
+  16 bit deltas from the previous location in the block where they
+  fit.
+
+  The file is a log of blocks. Rewriting a block appends the new copy
+  and the newest copy of each block wins when the file is scanned at
+  startup, so a power loss mid-write loses at most the block being
+  written. Once less than half of the file is live data the live
+  blocks are copied to the second file with a higher generation
+  number, which is only written to the header after all blocks are
+  on the file. Clearing the mission starts an empty file the same
+  way, and at startup the valid file with the highest generation is
+  used.
+
+  AP_MISSION_FILE_WINDOWS blocks are kept decoded in RAM and all file
+  access happens on the IO thread: loading blocks, writing back dirty
+  blocks once writes stop and decoding the block following the one
+  last read ahead of the mission. A read or write of a block that is
+  not in RAM fails with busy() true and should be retried once the IO
+  thread has loaded it.
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Filesystem/AP_Filesystem_Available.h>
+
+#ifndef AP_MISSION_FILE_STORE_ENABLED
+#if HAVE_FILESYSTEM_SUPPORT && HAL_MEM_CLASS >= HAL_MEM_CLASS_500 && defined(HAL_BOARD_STORAGE_DIRECTORY)
+#define AP_MISSION_FILE_STORE_ENABLED 1
+#else
+#define AP_MISSION_FILE_STORE_ENABLED 0
+#endif
+#endif
+
+#if AP_MISSION_FILE_STORE_ENABLED
+
+#define AP_MISSION_FILE_NAME            "mission%u.dat"
+#define AP_MISSION_FILE_BLOCK_RECORDS   32      // commands per block
+#define AP_MISSION_FILE_RECORD_SIZE     15      // same as AP_MISSION_EEPROM_COMMAND_SIZE
+
+#ifndef AP_MISSION_FILE_WINDOWS
+#define AP_MISSION_FILE_WINDOWS         4       // blocks decoded in RAM
+#endif
+
+#ifndef AP_MISSION_FILE_MAX_COMMANDS
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_1000
+#define AP_MISSION_FILE_MAX_COMMANDS    32000
+#else
+#define AP_MISSION_FILE_MAX_COMMANDS    8192
+#endif
+#endif
+
+class AP_Mission_FileStore {
+public:
+    AP_Mission_FileStore() {}
+
+    /* Do not allow copies */
+    AP_Mission_FileStore(const AP_Mission_FileStore &other) = delete;
+    AP_Mission_FileStore &operator=(const AP_Mission_FileStore&) = delete;
+
+    // open or create the mission file, returns false if the file
+    // store can't be used. existing is set true if a mission was
+    // loaded from the file
+    bool init(bool &existing);
+
+    // read a 15 byte record, returns false if it has never been
+    // written or if its block is not in RAM yet
+    bool read_record(uint16_t index, uint8_t *rec);
+
+    // write a 15 byte record. is_location is true when the content is
+    // a PackedLocation. Returns false if the block is not in RAM yet
+    bool write_record(uint16_t index, const uint8_t *rec, bool is_location);
+
+    // discard all records. The file is replaced on the IO thread
+    bool clear(void);
+
+    // true if a failed read or write is waiting for the IO thread and
+    // should be retried later
+    bool busy(void);
+
+    // number of commands the store can hold
+    uint16_t num_records_max(void) const {
+        return AP_MISSION_FILE_MAX_COMMANDS;
+    }
+
+private:
+    static const uint16_t num_blocks = (AP_MISSION_FILE_MAX_COMMANDS + AP_MISSION_FILE_BLOCK_RECORDS - 1) / AP_MISSION_FILE_BLOCK_RECORDS;
+
+    // largest encoded block: a tag byte plus the full record for each command
+    static const uint16_t max_encoded_size = AP_MISSION_FILE_BLOCK_RECORDS * (1 + AP_MISSION_FILE_RECORD_SIZE);
+
+    struct PACKED file_header {
+        uint32_t magic;         // zero until the file is complete
+        uint16_t version;
+        uint16_t block_records;
+        uint32_t generation;    // the valid file with the highest generation is used
+    };
+
+    struct PACKED block_header {
+        uint16_t block_num;
+        uint16_t length;        // encoded bytes following this header
+        uint32_t valid_mask;    // records present in the block
+        uint16_t crc;           // crc16_ccitt of the encoded bytes
+    };
+
+    // a decoded block
+    struct window {
+        uint16_t block_num;     // UINT16_MAX when unused
+        bool dirty;
+        bool writing;           // being written back by the IO thread
+        uint32_t last_use_ms;
+        uint32_t valid_mask;    // records present in the block
+        uint32_t location_mask; // records holding a PackedLocation
+        uint8_t records[AP_MISSION_FILE_BLOCK_RECORDS][AP_MISSION_FILE_RECORD_SIZE];
+    } _window[AP_MISSION_FILE_WINDOWS];
+
+    // block being loaded by the IO thread
+    struct window _load_window;
+
+    // file offset of the newest copy of each block, 0 if not on
+    // file, and the length of that copy including its header. Only
+    // changed by the IO thread with _sem held
+    uint32_t *_block_offset;
+    uint16_t *_block_length;
+
+    char *_path[2];
+    uint8_t _file_idx;
+    uint32_t _generation;
+    int _fd = -1;
+    uint32_t _file_end;
+    uint32_t _live_bytes;       // bytes of the file used by the newest block copies
+
+    bool _io_failure;
+    uint32_t _io_fail_ms;
+
+    // set by clear() until the IO thread has started an empty file
+    bool _clear_pending;
+    uint32_t _clear_seq;
+
+    uint32_t _last_write_ms;
+    uint16_t _prefetch_block = UINT16_MAX;
+    uint16_t _wanted_block = UINT16_MAX;    // block a failed read or write is waiting for
+
+    // encoded block being read or written by the IO thread
+    uint8_t _io_buf[max_encoded_size];
+
+    HAL_Semaphore _sem;
+
+    bool read_file_header(int fd, struct file_header &hdr);
+    bool write_file_header(int fd, uint32_t magic, uint32_t generation);
+    bool scan(void);
+    bool on_file(uint16_t block_num) const {
+        return !_clear_pending && _block_offset[block_num] != 0;
+    }
+    window *find_window(uint16_t block_num);
+    window *get_window(uint16_t block_num, bool for_write);
+    window *clean_window(void);
+    bool read_block(uint32_t offset, uint16_t block_num, uint8_t *buf, struct block_header &hdr);
+    bool load_block(uint16_t block_num);
+    bool write_back(window &w);
+    bool compact(bool empty);
+    void io_result(bool ok);
+
+    static uint16_t encode_block(const window &w, uint8_t *buf);
+    static bool decode_block(window &w, const uint8_t *buf, uint16_t len);
+
+    void io_timer(void);
+};
+
+#endif // AP_MISSION_FILE_STORE_ENABLED
@@ -71,43 +71,40 @@ void AP_MotorsMatrix::set_frame_class_and_type(motor_frame_class frame_class, mo
 
 void AP_MotorsMatrix::output_to_motors()
 {
-    int8_t i;
+    const uint8_t num_motors = _mix.num_motors;
 
     switch (_spool_state) {
         case SpoolState::SHUT_DOWN: {
             // no output
-            for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-                if (motor_enabled[i]) {
-                    _actuator[i] = 0.0f;
-                }
+            for (uint8_t k = 0; k < num_motors; k++) {
+                _actuator[_mix.motor[k]] = 0.0f;
             }
             break;
         }
         case SpoolState::GROUND_IDLE:
             // sends output to motors when armed but not flying
-            for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-                if (motor_enabled[i]) {
-                    set_actuator_with_slew(_actuator[i], actuator_spin_up_to_ground_idle());
-                }
+            for (uint8_t k = 0; k < num_motors; k++) {
+                set_actuator_with_slew(_actuator[_mix.motor[k]], actuator_spin_up_to_ground_idle());
             }
             break;
         case SpoolState::SPOOLING_UP:
         case SpoolState::THROTTLE_UNLIMITED:
         case SpoolState::SPOOLING_DOWN:
             // set motor output based on thrust requests
-            for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-                if (motor_enabled[i]) {
-                    set_actuator_with_slew(_actuator[i], thrust_to_actuator(_thrust_rpyt_out[i]));
-                }
+            for (uint8_t k = 0; k < num_motors; k++) {
+                const uint8_t i = _mix.motor[k];
+                set_actuator_with_slew(_actuator[i], thrust_to_actuator(_thrust_rpyt_out[i]));
             }
             break;
     }
 
-    // convert output to PWM and send to each motor
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            rc_write(i, output_to_pwm(_actuator[i]));
-        }
+    // convert output to PWM for all motors, then send them in one pass
+    uint16_t pwm[AP_MOTORS_MAX_NUM_MOTORS];
+    for (uint8_t k = 0; k < num_motors; k++) {
+        pwm[k] = output_to_pwm(_actuator[_mix.motor[k]]);
+    }
+    for (uint8_t k = 0; k < num_motors; k++) {
+        rc_write(_mix.motor[k], pwm[k]);
     }
 }
 
@@ -133,7 +130,8 @@ uint16_t AP_MotorsMatrix::get_motor_mask()
 // includes new scaling stability patch
 void AP_MotorsMatrix::output_armed_stabilizing()
 {
-    uint8_t i;                          // general purpose counter
+    const uint8_t num_motors = _mix.num_motors;
+    float   thrust[AP_MOTORS_MAX_NUM_MOTORS]; // roll, pitch and yaw thrust of each entry of the mix table
     float   roll_thrust;                // roll thrust input value, +/- 1.0
     float   pitch_thrust;               // pitch thrust input value, +/- 1.0
     float   yaw_thrust;                 // yaw thrust input value, +/- 1.0
@@ -193,31 +191,46 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // Octo-Quad (x8) + : MOT_YAW_HEADROOM = 300, ATC_RAT_RLL_IMAX = 0.5,   ATC_RAT_PIT_IMAX = 0.5,   ATC_RAT_YAW_IMAX = 0.25
     // Quads cannot make use of motor loss handling because it doesn't have enough degrees of freedom.
 
+    // mix table index of the lost motor, excluded from the limits below
+    // while thrust boost is active
+    int8_t lost = -1;
+    if (_thrust_boost) {
+        for (uint8_t k = 0; k < num_motors; k++) {
+            if (_mix.motor[k] == _motor_lost_index) {
+                lost = k;
+                break;
+            }
+        }
+    }
+
+    // calculate the thrust outputs for roll and pitch
+    for (uint8_t k = 0; k < num_motors; k++) {
+        thrust[k] = roll_thrust * _mix.roll[k] + pitch_thrust * _mix.pitch[k];
+    }
+
     // calculate amount of yaw we can fit into the throttle range
     // this is always equal to or less than the requested yaw from the pilot or rate controller
     float rp_low = 1.0f;    // lowest thrust value
     float rp_high = -1.0f;  // highest thrust value
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            // calculate the thrust outputs for roll and pitch
-            _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
-            // record lowest roll + pitch command
-            if (_thrust_rpyt_out[i] < rp_low) {
-                rp_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch command
-            if (_thrust_rpyt_out[i] > rp_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rp_high = _thrust_rpyt_out[i];
-            }
+    for (uint8_t k = 0; k < num_motors; k++) {
+        // record lowest roll + pitch command
+        if (thrust[k] < rp_low) {
+            rp_low = thrust[k];
+        }
+        if (k == lost) {
+            continue;
+        }
+        // record highest roll + pitch command
+        if (thrust[k] > rp_high) {
+            rp_high = thrust[k];
+        }
 
-            // Check the maximum yaw control that can be used on this channel
-            // Exclude any lost motors if thrust boost is enabled
-            if (!is_zero(_yaw_factor[i]) && (!_thrust_boost || i != _motor_lost_index)){
-                if (is_positive(yaw_thrust * _yaw_factor[i])) {
-                    yaw_allowed = MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + _thrust_rpyt_out[i]), 0.0f)/_yaw_factor[i]));
-                } else {
-                    yaw_allowed = MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + _thrust_rpyt_out[i], 0.0f)/_yaw_factor[i]));
-                }
+        // Check the maximum yaw control that can be used on this channel
+        if (!is_zero(_mix.yaw[k])) {
+            if (is_positive(yaw_thrust * _mix.yaw[k])) {
+                yaw_allowed = MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + thrust[k]), 0.0f)/_mix.yaw[k]));
+            } else {
+                yaw_allowed = MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + thrust[k], 0.0f)/_mix.yaw[k]));
             }
         }
     }
@@ -233,19 +246,19 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     yaw_allowed = MAX(yaw_allowed, yaw_allowed_min);
 
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost && motor_enabled[_motor_lost_index]) {
+    if (lost >= 0) {
         // record highest roll + pitch command
-        if (_thrust_rpyt_out[_motor_lost_index] > rp_high) {
-            rp_high = _thrust_boost_ratio * rp_high + (1.0f - _thrust_boost_ratio) * _thrust_rpyt_out[_motor_lost_index];
+        if (thrust[lost] > rp_high) {
+            rp_high = _thrust_boost_ratio * rp_high + (1.0f - _thrust_boost_ratio) * thrust[lost];
         }
 
         // Check the maximum yaw control that can be used on this channel
         // Exclude any lost motors if thrust boost is enabled
-        if (!is_zero(_yaw_factor[_motor_lost_index])){
-            if (is_positive(yaw_thrust * _yaw_factor[_motor_lost_index])) {
-                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index]), 0.0f)/_yaw_factor[_motor_lost_index]));
+        if (!is_zero(_mix.yaw[lost])){
+            if (is_positive(yaw_thrust * _mix.yaw[lost])) {
+                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + thrust[lost]), 0.0f)/_mix.yaw[lost]));
             } else {
-                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index], 0.0f)/_yaw_factor[_motor_lost_index]));
+                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + thrust[lost], 0.0f)/_mix.yaw[lost]));
             }
         }
     }
@@ -257,28 +270,28 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     }
 
     // add yaw control to thrust outputs
+    for (uint8_t k = 0; k < num_motors; k++) {
+        thrust[k] += yaw_thrust * _mix.yaw[k];
+    }
+
     float rpy_low = 1.0f;   // lowest thrust value
     float rpy_high = -1.0f; // highest thrust value
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
-
-            // record lowest roll + pitch + yaw command
-            if (_thrust_rpyt_out[i] < rpy_low) {
-                rpy_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch + yaw command
-            // Exclude any lost motors if thrust boost is enabled
-            if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rpy_high = _thrust_rpyt_out[i];
-            }
+    for (uint8_t k = 0; k < num_motors; k++) {
+        // record lowest roll + pitch + yaw command
+        if (thrust[k] < rpy_low) {
+            rpy_low = thrust[k];
+        }
+        // record highest roll + pitch + yaw command
+        // Exclude any lost motors if thrust boost is enabled
+        if (thrust[k] > rpy_high && k != lost) {
+            rpy_high = thrust[k];
         }
     }
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost) {
+    if (lost >= 0) {
         // record highest roll + pitch + yaw command
-        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
-            rpy_high = _thrust_boost_ratio * rpy_high + (1.0f - _thrust_boost_ratio) * _thrust_rpyt_out[_motor_lost_index];
+        if (thrust[lost] > rpy_high) {
+            rpy_high = _thrust_boost_ratio * rpy_high + (1.0f - _thrust_boost_ratio) * thrust[lost];
         }
     }
 
@@ -317,10 +330,8 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     }
 
     // add scaled roll, pitch, constrained yaw and throttle for each motor
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = throttle_thrust_best_rpy + thr_adj + (rpy_scale * _thrust_rpyt_out[i]);
-        }
+    for (uint8_t k = 0; k < num_motors; k++) {
+        _thrust_rpyt_out[_mix.motor[k]] = throttle_thrust_best_rpy + thr_adj + (rpy_scale * thrust[k]);
     }
 
     // determine throttle thrust for harmonic notch
@@ -344,26 +355,19 @@ void AP_MotorsMatrix::check_for_failed_motor(float throttle_thrust_best_plus_adj
 {
     // record filtered and scaled thrust output for motor loss monitoring purposes
     float alpha = 1.0f / (1.0f + _loop_rate * 0.5f);
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out_filt[i] += alpha * (_thrust_rpyt_out[i] - _thrust_rpyt_out_filt[i]);
-        }
-    }
-
     float rpyt_high = 0.0f;
     float rpyt_sum = 0.0f;
-    uint8_t number_motors = 0.0f;
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            number_motors += 1;
-            rpyt_sum += _thrust_rpyt_out_filt[i];
-            // record highest filtered thrust command
-            if (_thrust_rpyt_out_filt[i] > rpyt_high) {
-                rpyt_high = _thrust_rpyt_out_filt[i];
-                // hold motor lost index constant while thrust boost is active
-                if (!_thrust_boost) {
-                    _motor_lost_index = i;
-                }
+    const uint8_t number_motors = _mix.num_motors;
+    for (uint8_t k = 0; k < number_motors; k++) {
+        const uint8_t i = _mix.motor[k];
+        _thrust_rpyt_out_filt[i] += alpha * (_thrust_rpyt_out[i] - _thrust_rpyt_out_filt[i]);
+        rpyt_sum += _thrust_rpyt_out_filt[i];
+        // record highest filtered thrust command
+        if (_thrust_rpyt_out_filt[i] > rpyt_high) {
+            rpyt_high = _thrust_rpyt_out_filt[i];
+            // hold motor lost index constant while thrust boost is active
+            if (!_thrust_boost) {
+                _motor_lost_index = i;
             }
         }
     }
@@ -451,6 +455,8 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
 
         // call parent class method
         add_motor_num(motor_num);
+
+        update_mix_table();
     }
 }
 
@@ -481,6 +487,8 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
         _roll_factor[motor_num] = 0;
         _pitch_factor[motor_num] = 0;
         _yaw_factor[motor_num] = 0;
+
+        update_mix_table();
     }
 }
 
@@ -912,6 +920,24 @@ void AP_MotorsMatrix::normalise_rpy_factors()
             }
         }
     }
+
+    update_mix_table();
+}
+
+// rebuild the mix table from the enabled motors and their factors
+void AP_MotorsMatrix::update_mix_table()
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (motor_enabled[i]) {
+            _mix.motor[n] = i;
+            _mix.roll[n] = _roll_factor[i];
+            _mix.pitch[n] = _pitch_factor[i];
+            _mix.yaw[n] = _yaw_factor[i];
+            n++;
+        }
+    }
+    _mix.num_motors = n;
 }
 
 
@@ -80,6 +80,9 @@ protected:
     // normalizes the roll, pitch and yaw factors so maximum magnitude is 0.5
     void                normalise_rpy_factors();
 
+    // rebuild the mix table from the enabled motors and their factors
+    void                update_mix_table();
+
     // call vehicle supplied thrust compensation if set
     void                thrust_compensation(void) override;
 
@@ -94,4 +97,14 @@ protected:
     // motor failure handling
     float               _thrust_rpyt_out_filt[AP_MOTORS_MAX_NUM_MOTORS];    // filtered thrust outputs with 1 second time constant
     uint8_t             _motor_lost_index;  // index number of the lost motor
+
+    // mix table holding only the enabled motors, in motor number order, so
+    // the mixer runs over packed arrays without checking motor_enabled
+    struct {
+        uint8_t         num_motors;                         // number of enabled motors
+        uint8_t         motor[AP_MOTORS_MAX_NUM_MOTORS];    // motor number of each entry
+        float           roll[AP_MOTORS_MAX_NUM_MOTORS];     // roll factor of each entry
+        float           pitch[AP_MOTORS_MAX_NUM_MOTORS];    // pitch factor of each entry
+        float           yaw[AP_MOTORS_MAX_NUM_MOTORS];      // yaw factor of each entry
+    } _mix;
 };
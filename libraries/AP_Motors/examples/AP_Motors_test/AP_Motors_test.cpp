@@ -20,6 +20,7 @@ void loop();
 void motor_order_test();
 void stability_test();
 void update_motors();
+void performance_test();
 
 #define HELI_TEST       0   // set to 1 to test helicopters
 #define NUM_OUTPUTS     4   // set to 6 for hexacopter, 8 for octacopter and heli
@@ -68,7 +69,7 @@ void loop()
     int16_t value;
 
     // display help
-    hal.console->printf("Press 't' to run motor orders test, 's' to run stability patch test.  Be careful the motors will spin!\n");
+    hal.console->printf("Press 't' to run motor orders test, 's' to run stability patch test, 'p' to run mixer performance test.  Be careful the motors will spin!\n");
 
     // wait for user to enter something
     while( !hal.console->available() ) {
@@ -85,6 +86,11 @@ void loop()
     if (value == 's' || value == 'S') {
         stability_test();
     }
+#if HELI_TEST == 0
+    if (value == 'p' || value == 'P') {
+        performance_test();
+    }
+#endif
 }
 
 // stability_test
@@ -191,6 +197,62 @@ void stability_test()
     hal.console->printf("finished test.\n");
 }
 
+#if HELI_TEST == 0
+// performance_test - time the mixer and output for a range of frame sizes
+void performance_test()
+{
+    const struct {
+        const char *name;
+        AP_Motors::motor_frame_class frame_class;
+        AP_Motors::motor_frame_type frame_type;
+    } frames[] = {
+        { "quad",   AP_Motors::MOTOR_FRAME_QUAD,       AP_Motors::MOTOR_FRAME_TYPE_X },
+        { "hexa",   AP_Motors::MOTOR_FRAME_HEXA,       AP_Motors::MOTOR_FRAME_TYPE_X },
+        { "octa",   AP_Motors::MOTOR_FRAME_OCTA,       AP_Motors::MOTOR_FRAME_TYPE_X },
+        { "dodeca", AP_Motors::MOTOR_FRAME_DODECAHEXA, AP_Motors::MOTOR_FRAME_TYPE_X },
+    };
+    const uint32_t iterations = 20000;
+
+    hal.console->printf("\nTesting mixer performance\n");
+    for (uint8_t f = 0; f < ARRAY_SIZE(frames); f++) {
+        motors.armed(false);
+        motors.set_frame_class_and_type(frames[f].frame_class, frames[f].frame_type);
+
+        motors.armed(true);
+        motors.set_interlock(true);
+        SRV_Channels::enable_aux_servos();
+        motors.set_throttle(0.5f);
+        motors.set_desired_spool_state(AP_Motors::DesiredSpoolState::THROTTLE_UNLIMITED);
+        update_motors();
+
+        const uint32_t start_us = AP_HAL::micros();
+        for (uint32_t i = 0; i < iterations; i++) {
+            // sweep the inputs so both saturated and unsaturated paths are taken
+            const float in = ((i % 200) - 100) * 0.01f;
+            motors.set_roll(in);
+            motors.set_pitch(-in);
+            motors.set_yaw(0.5f * in);
+            motors.output();
+        }
+        const uint32_t dt_us = AP_HAL::micros() - start_us;
+        hal.console->printf("%-8s %2u motors: %.3f us per output\n",
+                            frames[f].name,
+                            (unsigned)__builtin_popcount(motors.get_motor_mask()),
+                            (double)(dt_us / float(iterations)));
+    }
+
+    // restore the default frame with zero inputs
+    motors.set_roll(0);
+    motors.set_pitch(0);
+    motors.set_yaw(0);
+    motors.set_throttle(0);
+    motors.armed(false);
+    motors.set_frame_class_and_type(AP_Motors::MOTOR_FRAME_QUAD, AP_Motors::MOTOR_FRAME_TYPE_X);
+
+    hal.console->printf("finished test.\n");
+}
+#endif
+
 void update_motors()
 {
     // call update motors 1000 times to get any ramp limiting complete
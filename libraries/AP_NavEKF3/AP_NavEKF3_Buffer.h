@@ -24,6 +24,7 @@ public:
         _head = 0;
         _tail = 0;
         _new_data = false;
+        _unordered = 0;
         return true;
     }
 
@@ -40,7 +41,7 @@ public:
             return false;
         }
         bool success = false;
-        uint8_t tail = _tail, bestIndex;
+        uint16_t tail = _tail, bestIndex;
 
         if(_head == tail) {
             if (buffer[tail].element.time_ms != 0 && buffer[tail].element.time_ms <= sample_time) {
@@ -51,6 +52,20 @@ public:
                     _new_data = false;
                 }
             }
+        } else if (_unordered == 0) {
+            // data from tail up to head is in time order, so search
+            // for the newest measurement at or before the fusion time
+            // horizon. Older ones would be staler still
+            const uint16_t count = (_head + _size - tail) % _size;
+            const uint16_t newer = first_newer_than(sample_time, count);
+            if (newer > 0) {
+                const uint16_t index = (tail + newer - 1) % _size;
+                if (buffer[index].element.time_ms != 0 &&
+                    ((sample_time - buffer[index].element.time_ms) < 100)) {
+                    bestIndex = index;
+                    success = true;
+                }
+            }
         } else {
             while(_head != tail) {
                 // find a measurement older than the fusion time horizon that we haven't checked before
@@ -85,6 +100,13 @@ public:
     */
     inline void push(element_type element)
     {
+        // an element older than the one before it stops the buffer
+        // being searched by time until it has been overwritten
+        if (element.time_ms < buffer[_head].element.time_ms) {
+            _unordered = _size;
+        } else if (_unordered > 0) {
+            _unordered--;
+        }
         // Advance head to next available index
         _head = (_head+1)%_size;
         // New data is written at the head
@@ -93,9 +115,10 @@ public:
     }
     // writes the same data to all elements in the ring buffer
     inline void reset_history(element_type element, uint32_t sample_time) {
-        for (uint8_t index=0; index<_size; index++) {
+        for (uint16_t index=0; index<_size; index++) {
             buffer[index].element = element;
         }
+        _unordered = 0;
     }
 
     // zeroes all data in the ring buffer
@@ -103,11 +126,48 @@ public:
         _head = 0;
         _tail = 0;
         _new_data = false;
+        _unordered = 0;
         memset((void *)buffer,0,_size*sizeof(element_t));
     }
 
 private:
-    uint8_t _size,_head,_tail,_new_data;
+    /*
+     * Returns the position, counting from the tail, of the first of
+     * count elements with a time later than sample_time, or count if
+     * there are none. The search gallops forward from the tail before
+     * halving, so the usual case of the answer being close to the tail
+     * takes a couple of comparisons while a long backlog takes log(n)
+    */
+    uint16_t first_newer_than(uint32_t sample_time, uint16_t count) const
+    {
+        uint16_t lo = 0;        // elements before lo are not newer
+        uint16_t hi = count;    // elements from hi on are newer
+        uint16_t step = 1;
+        while (lo < hi) {
+            const uint16_t probe = MIN(lo + step, hi) - 1;
+            if (buffer[(_tail + probe) % _size].element.time_ms <= sample_time) {
+                lo = probe + 1;
+                step *= 2;
+            } else {
+                hi = probe;
+                break;
+            }
+        }
+        while (lo < hi) {
+            const uint16_t mid = (lo + hi) / 2;
+            if (buffer[(_tail + mid) % _size].element.time_ms <= sample_time) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    uint16_t _size,_head,_tail;
+    bool _new_data;
+    // number of pushes until an out of order element has left the buffer
+    uint16_t _unordered;
 };
 
 
@@ -195,3 +255,120 @@ private:
     uint8_t _size,_oldest,_youngest;
     bool _filled;
 };
+
+
+// Following buffer model is for the output observer state history.
+// It is indexed the same way as the IMU buffer but each velocity and
+// position component is held in its own array, so corrections applied
+// to the whole history are loops over contiguous floats that the
+// compiler can vectorise
+template <typename element_type>
+class output_ring_buffer_t
+{
+public:
+    // initialise buffer, returns false when allocation has failed
+    bool init(uint32_t size)
+    {
+        _quat = new Quaternion[size];
+        _states = new float[6*size];
+        if (_quat == nullptr || _states == nullptr) {
+            delete[] _quat;
+            delete[] _states;
+            _quat = nullptr;
+            _states = nullptr;
+            return false;
+        }
+        for (uint8_t i=0; i<3; i++) {
+            _vel[i] = &_states[i*size];
+            _pos[i] = &_states[(3+i)*size];
+        }
+        _size = size;
+        reset();
+        return true;
+    }
+
+    // retrieves data from the ring buffer at a specified index
+    inline element_type get(uint8_t index) const {
+        element_type ret;
+        ret.quat = _quat[index];
+        ret.velocity = Vector3f(_vel[0][index], _vel[1][index], _vel[2][index]);
+        ret.position = Vector3f(_pos[0][index], _pos[1][index], _pos[2][index]);
+        return ret;
+    }
+
+    // writes data to the ring buffer at a specified index
+    inline void set(uint8_t index, const element_type &element) {
+        _quat[index] = element.quat;
+        for (uint8_t i=0; i<3; i++) {
+            _vel[i][index] = element.velocity[i];
+            _pos[i][index] = element.position[i];
+        }
+    }
+
+    // writes the same data to all elements in the ring buffer
+    inline void reset_history(const element_type &element) {
+        reset_quat(element.quat);
+        for (uint8_t i=0; i<3; i++) {
+            reset_velocity(i, element.velocity[i]);
+            reset_position(i, element.position[i]);
+        }
+    }
+
+    // writes the same quaternion to all elements in the ring buffer
+    inline void reset_quat(const Quaternion &quat) {
+        for (uint8_t index=0; index<_size; index++) {
+            _quat[index] = quat;
+        }
+    }
+
+    // rotates the quaternion of all elements in the ring buffer
+    inline void rotate_quat(const Quaternion &deltaQuat) {
+        for (uint8_t index=0; index<_size; index++) {
+            _quat[index] = _quat[index]*deltaQuat;
+        }
+    }
+
+    // writes the same value of one velocity or position axis to all elements
+    inline void reset_velocity(uint8_t axis, float value) {
+        fill(_vel[axis], value);
+    }
+    inline void reset_position(uint8_t axis, float value) {
+        fill(_pos[axis], value);
+    }
+
+    // adds a constant correction to the velocity or position of all elements
+    inline void correct_velocity(const Vector3f &correction) {
+        for (uint8_t i=0; i<3; i++) {
+            add(_vel[i], correction[i]);
+        }
+    }
+    inline void correct_position(const Vector3f &correction) {
+        for (uint8_t i=0; i<3; i++) {
+            add(_pos[i], correction[i]);
+        }
+    }
+
+    // zeroes all data in the ring buffer
+    inline void reset() {
+        memset((void *)_quat,0,_size*sizeof(_quat[0]));
+        memset((void *)_states,0,6*_size*sizeof(_states[0]));
+    }
+
+private:
+    inline void fill(float * __restrict data, float value) {
+        for (uint8_t index=0; index<_size; index++) {
+            data[index] = value;
+        }
+    }
+    inline void add(float * __restrict data, float value) {
+        for (uint8_t index=0; index<_size; index++) {
+            data[index] += value;
+        }
+    }
+
+    Quaternion *_quat;
+    float *_states;
+    float *_vel[3];
+    float *_pos[3];
+    uint8_t _size;
+};
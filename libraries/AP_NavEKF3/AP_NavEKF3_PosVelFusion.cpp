@@ -55,10 +55,8 @@ void NavEKF3_core::ResetVelocity(void)
             lastVelPassTime_ms = imuSampleTime_ms;
         }
     }
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].velocity.x = stateStruct.velocity.x;
-        storedOutput[i].velocity.y = stateStruct.velocity.y;
-    }
+    storedOutput.reset_velocity(0, stateStruct.velocity.x);
+    storedOutput.reset_velocity(1, stateStruct.velocity.y);
     outputDataNew.velocity.x = stateStruct.velocity.x;
     outputDataNew.velocity.y = stateStruct.velocity.y;
     outputDataDelayed.velocity.x = stateStruct.velocity.x;
@@ -121,10 +119,8 @@ void NavEKF3_core::ResetPosition(void)
             lastRngBcnPassTime_ms = imuSampleTime_ms;
         }
     }
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].position.x = stateStruct.position.x;
-        storedOutput[i].position.y = stateStruct.position.y;
-    }
+    storedOutput.reset_position(0, stateStruct.position.x);
+    storedOutput.reset_position(1, stateStruct.position.y);
     outputDataNew.position.x = stateStruct.position.x;
     outputDataNew.position.y = stateStruct.position.y;
     outputDataDelayed.position.x = stateStruct.position.x;
@@ -161,9 +157,7 @@ void NavEKF3_core::ResetHeight(void)
         // can make no assumption other than vehicle is not below ground level
         terrainState = MAX(stateStruct.position.z + rngOnGnd , terrainState);
     }
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].position.z = stateStruct.position.z;
-    }
+    storedOutput.reset_position(2, stateStruct.position.z);
     vertCompFiltState.pos = stateStruct.position.z;
 
     // Calculate the position jump due to the reset
@@ -190,9 +184,7 @@ void NavEKF3_core::ResetHeight(void)
     } else if (onGround) {
         stateStruct.velocity.z = 0.0f;
     }
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].velocity.z = stateStruct.velocity.z;
-    }
+    storedOutput.reset_velocity(2, stateStruct.velocity.z);
     outputDataNew.velocity.z = stateStruct.velocity.z;
     outputDataDelayed.velocity.z = stateStruct.velocity.z;
     vertCompFiltState.vel = outputDataNew.velocity.z;
@@ -330,10 +322,7 @@ void NavEKF3_core::SelectVelPosFusion()
         posResetNE.y = stateStruct.position.y - posResetNE.y;
 
         // Add the offset to the output observer states
-        for (uint8_t i=0; i<imu_buffer_length; i++) {
-            storedOutput[i].position.x += posResetNE.x;
-            storedOutput[i].position.y += posResetNE.y;
-        }
+        storedOutput.correct_position(Vector3f(posResetNE.x, posResetNE.y, 0.0f));
         outputDataNew.position.x += posResetNE.x;
         outputDataNew.position.y += posResetNE.y;
         outputDataDelayed.position.x += posResetNE.x;
@@ -357,9 +346,7 @@ void NavEKF3_core::SelectVelPosFusion()
             outputDataNew.position.z += posResetD;
             vertCompFiltState.pos = outputDataNew.position.z;
             outputDataDelayed.position.z += posResetD;
-            for (uint8_t i=0; i<imu_buffer_length; i++) {
-                storedOutput[i].position.z += posResetD;
-            }
+            storedOutput.correct_position(Vector3f(0.0f, 0.0f, posResetD));
 
             // store the time of the reset
             lastPosResetD_ms = imuSampleTime_ms;
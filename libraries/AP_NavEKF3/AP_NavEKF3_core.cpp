@@ -806,10 +806,10 @@ void NavEKF3_core::calcOutputStates()
     // store INS states in a ring buffer that with the same length and time coordinates as the IMU data buffer
     if (runUpdates) {
         // store the states at the output time horizon
-        storedOutput[storedIMU.get_youngest_index()] = outputDataNew;
+        storedOutput.set(storedIMU.get_youngest_index(), outputDataNew);
 
         // recall the states from the fusion time horizon
-        outputDataDelayed = storedOutput[storedIMU.get_oldest_index()];
+        outputDataDelayed = storedOutput.get(storedIMU.get_oldest_index());
 
         // compare quaternion data with EKF quaternion at the fusion time horizon and calculate correction
 
@@ -864,22 +864,11 @@ void NavEKF3_core::calcOutputStates()
         // this method is too expensive to use for the attitude states due to the quaternion operations required
         // but does not introduce a time delay in the 'correction loop' and allows smaller tracking time constants
         // to be used
-        output_elements outputStates;
-        for (unsigned index=0; index < imu_buffer_length; index++) {
-            outputStates = storedOutput[index];
-
-            // a constant  velocity correction is applied
-            outputStates.velocity += velCorrection;
-
-            // a constant position correction is applied
-            outputStates.position += posCorrection;
-
-            // push the updated data to the buffer
-            storedOutput[index] = outputStates;
-        }
+        storedOutput.correct_velocity(velCorrection);
+        storedOutput.correct_position(posCorrection);
 
         // update output state to corrected values
-        outputDataNew = storedOutput[storedIMU.get_youngest_index()];
+        outputDataNew = storedOutput.get(storedIMU.get_youngest_index());
 
     }
 }
@@ -1423,9 +1412,7 @@ void NavEKF3_core::StoreOutputReset()
     outputDataNew.velocity = stateStruct.velocity;
     outputDataNew.position = stateStruct.position;
     // write current measurement to entire table
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i] = outputDataNew;
-    }
+    storedOutput.reset_history(outputDataNew);
     outputDataDelayed = outputDataNew;
     // reset the states for the complementary filter used to provide a vertical position derivative output
     vertCompFiltState.pos = stateStruct.position.z;
@@ -1437,9 +1424,7 @@ void NavEKF3_core::StoreQuatReset()
 {
     outputDataNew.quat = stateStruct.quat;
     // write current measurement to entire table
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].quat = outputDataNew.quat;
-    }
+    storedOutput.reset_quat(outputDataNew.quat);
     outputDataDelayed.quat = outputDataNew.quat;
 }
 
@@ -1447,10 +1432,8 @@ void NavEKF3_core::StoreQuatReset()
 void NavEKF3_core::StoreQuatRotate(const Quaternion &deltaQuat)
 {
     outputDataNew.quat = outputDataNew.quat*deltaQuat;
-    // write current measurement to entire table
-    for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].quat = storedOutput[i].quat*deltaQuat;
-    }
+    // rotate the entire table
+    storedOutput.rotate_quat(deltaQuat);
     outputDataDelayed.quat = outputDataDelayed.quat*deltaQuat;
 }
 
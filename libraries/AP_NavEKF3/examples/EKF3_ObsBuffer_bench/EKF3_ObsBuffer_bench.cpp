@@ -0,0 +1,87 @@
+//
+// Benchmark of EKF3 observation buffer recall. Measurements arrive
+// every 10ms, as from 100Hz visual odometry, and are recalled at the
+// fusion time horizon 150ms behind. Recall cost is printed against
+// buffer length, both when every EKF step fuses and when fusion only
+// happens every 20 steps so a backlog builds up behind the horizon.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_NavEKF3/AP_NavEKF3_Buffer.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+struct obs_elements {
+    Vector3f    vel;
+    uint32_t    time_ms;
+};
+
+static const uint16_t lengths[] { 16, 64, 256, 1024 };
+static const uint8_t num_lengths = ARRAY_SIZE(lengths);
+static const uint32_t steps = 20000;
+static const uint32_t delay_ms = 150;
+
+static obs_ring_buffer_t<obs_elements> buffers[num_lengths];
+
+// run the EKF at 12ms for a number of steps, recalling every recall_interval steps
+static float run(obs_ring_buffer_t<obs_elements> &buf, uint8_t recall_interval, uint32_t &found)
+{
+    buf.reset();
+    uint32_t now_ms = 1000;
+    uint32_t next_obs_ms = now_ms;
+    uint32_t recalls = 0;
+    uint64_t recall_us = 0;
+    found = 0;
+    for (uint32_t i = 0; i < steps; i++) {
+        now_ms += 12;
+        while (next_obs_ms <= now_ms) {
+            obs_elements obs;
+            obs.vel = Vector3f(1, 0, 0);
+            obs.time_ms = next_obs_ms;
+            buf.push(obs);
+            next_obs_ms += 10;
+        }
+        if (i % recall_interval != 0) {
+            continue;
+        }
+        obs_elements obs;
+        const uint64_t start_us = AP_HAL::micros64();
+        if (buf.recall(obs, now_ms - delay_ms)) {
+            found++;
+        }
+        recall_us += AP_HAL::micros64() - start_us;
+        recalls++;
+    }
+    return recall_us / float(recalls);
+}
+
+void setup(void)
+{
+    hal.console->printf("EKF3 observation buffer benchmark\n");
+
+    for (uint8_t i = 0; i < num_lengths; i++) {
+        if (!buffers[i].init(lengths[i])) {
+            AP_HAL::panic("buffer allocation failed");
+        }
+    }
+}
+
+void loop(void)
+{
+    for (uint8_t i = 0; i < num_lengths; i++) {
+        uint32_t found_every, found_backlog;
+        const float every_us = run(buffers[i], 1, found_every);
+        const float backlog_us = run(buffers[i], 20, found_backlog);
+        hal.console->printf("length %4u: %.3f us per recall fusing every step (%u found), %.3f us with a backlog (%u found)\n",
+                            (unsigned)lengths[i],
+                            (double)every_us, (unsigned)found_every,
+                            (double)backlog_us, (unsigned)found_backlog);
+    }
+    hal.scheduler->delay(2000);
+}
+
+AP_HAL_MAIN();
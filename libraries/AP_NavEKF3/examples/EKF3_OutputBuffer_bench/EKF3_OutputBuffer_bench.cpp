@@ -0,0 +1,110 @@
+//
+// Benchmark of the EKF3 output observer history. Each EKF step stores
+// the output states, recalls the delayed states and applies a velocity
+// and position correction to the whole history, as done in
+// NavEKF3_core::calcOutputStates(). The cost of a step is printed for
+// the old buffer of structures and the split arrays now used by the
+// EKF, for buffer lengths from a fast GPS up to the 250ms maximum
+// delay at the 12ms EKF update rate.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_NavEKF3/AP_NavEKF3_Buffer.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+struct output_elements {
+    Quaternion  quat;
+    Vector3f    velocity;
+    Vector3f    position;
+};
+
+static const uint8_t lengths[] { 6, 11, 21 };
+static const uint8_t num_lengths = ARRAY_SIZE(lengths);
+static const uint32_t steps = 20000;
+
+static imu_ring_buffer_t<output_elements> aos_buffers[num_lengths];
+static output_ring_buffer_t<output_elements> soa_buffers[num_lengths];
+
+// integrate the output states over one EKF step
+static void predict(output_elements &out)
+{
+    out.velocity.x += 0.001f;
+    out.position += out.velocity * 0.012f;
+}
+
+// velocity and position correction towards a constant EKF state
+static Vector3f correction(const output_elements &delayed)
+{
+    return (Vector3f(1.0f, 0.5f, -0.2f) - delayed.velocity) * 0.01f;
+}
+
+static float run_aos(imu_ring_buffer_t<output_elements> &buf, uint8_t length, output_elements &out)
+{
+    buf.reset();
+    out = output_elements {};
+    const uint64_t start_us = AP_HAL::micros64();
+    for (uint32_t i = 0; i < steps; i++) {
+        const uint8_t youngest = i % length;
+        predict(out);
+        buf[youngest] = out;
+        const Vector3f corr = correction(buf[(youngest + 1) % length]);
+        for (uint8_t index = 0; index < length; index++) {
+            output_elements states = buf[index];
+            states.velocity += corr;
+            states.position += corr;
+            buf[index] = states;
+        }
+        out = buf[youngest];
+    }
+    return (AP_HAL::micros64() - start_us) / float(steps);
+}
+
+static float run_soa(output_ring_buffer_t<output_elements> &buf, uint8_t length, output_elements &out)
+{
+    buf.reset();
+    out = output_elements {};
+    const uint64_t start_us = AP_HAL::micros64();
+    for (uint32_t i = 0; i < steps; i++) {
+        const uint8_t youngest = i % length;
+        predict(out);
+        buf.set(youngest, out);
+        const Vector3f corr = correction(buf.get((youngest + 1) % length));
+        buf.correct_velocity(corr);
+        buf.correct_position(corr);
+        out = buf.get(youngest);
+    }
+    return (AP_HAL::micros64() - start_us) / float(steps);
+}
+
+void setup(void)
+{
+    hal.console->printf("EKF3 output buffer benchmark\n");
+
+    for (uint8_t i = 0; i < num_lengths; i++) {
+        if (!aos_buffers[i].init(lengths[i]) || !soa_buffers[i].init(lengths[i])) {
+            AP_HAL::panic("buffer allocation failed");
+        }
+    }
+}
+
+void loop(void)
+{
+    for (uint8_t i = 0; i < num_lengths; i++) {
+        output_elements out_aos, out_soa;
+        const float aos_us = run_aos(aos_buffers[i], lengths[i], out_aos);
+        const float soa_us = run_soa(soa_buffers[i], lengths[i], out_soa);
+        const bool match = (out_aos.velocity - out_soa.velocity).length() < 1.0e-4f &&
+                           (out_aos.position - out_soa.position).length() < 1.0e-2f;
+        hal.console->printf("length %2u: %.3f us per step structs, %.3f us per step arrays%s\n",
+                            (unsigned)lengths[i], (double)aos_us, (double)soa_us,
+                            match ? "" : " MISMATCH");
+    }
+    hal.scheduler->delay(2000);
+}
+
+AP_HAL_MAIN();
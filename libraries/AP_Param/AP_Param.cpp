@@ -73,6 +73,7 @@ uint16_t AP_Param::_num_vars;
 
 // cached parameter count
 uint16_t AP_Param::_parameter_count;
+uint32_t AP_Param::_change_count;
 
 // storage and naming information about all types that can be saved
 const AP_Param::Info *AP_Param::_var_info;
@@ -1134,6 +1135,8 @@ void AP_Param::save_sync(bool force_save)
 */
 void AP_Param::save(bool force_save)
 {
+    _change_count++;
+
     struct param_save p;
     p.param = this;
     p.force_save = force_save;
@@ -2350,6 +2353,7 @@ bool AP_Param::set_default_by_name(const char *name, float value)
     if (vp == nullptr) {
         return false;
     }
+    _change_count++;
     switch (vtype) {
     case AP_PARAM_INT8:
         ((AP_Int8 *)vp)->set_default(value);
@@ -2396,6 +2400,7 @@ bool AP_Param::set_by_name(const char *name, float value)
     if (vp == nullptr) {
         return false;
     }
+    _change_count++;
     switch (vtype) {
     case AP_PARAM_INT8:
         ((AP_Int8 *)vp)->set(value);
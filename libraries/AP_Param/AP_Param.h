@@ -289,6 +289,10 @@ public:
     // name helper for scripting
     static bool set(const char *name, float value) { return set_by_name(name, value); };
 
+    // return a count which changes whenever a parameter is saved or
+    // set by name, for caching results which depend on parameters
+    static uint32_t get_change_count(void) { return _change_count; }
+
     /// gat a value by name, used by scripting
     ///
     /// @param  name            The full name of the variable to be found.
@@ -667,6 +671,7 @@ private:
     static StorageAccess        _storage;
     static uint16_t             _num_vars;
     static uint16_t             _parameter_count;
+    static uint32_t             _change_count;
     static const struct Info *  _var_info;
 
     /*
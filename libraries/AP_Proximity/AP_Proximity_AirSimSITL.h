@@ -26,7 +26,12 @@ class AP_Proximity_AirSimSITL : public AP_Proximity_Backend
 
 public:
     // constructor
-    using AP_Proximity_Backend::AP_Proximity_Backend;
+    AP_Proximity_AirSimSITL(AP_Proximity &_frontend, AP_Proximity::Proximity_State &_state) :
+        AP_Proximity_Backend(_frontend, _state)
+    {
+        // scanning sensor, keep its readings at high resolution
+        init_sectors(PROXIMITY_MAX_SECTORS);
+    }
 
     // update state
     void update(void) override;
@@ -29,8 +29,8 @@ AP_Proximity_Backend::AP_Proximity_Backend(AP_Proximity &_frontend, AP_Proximity
         frontend(_frontend),
         state(_state)
 {
-    // initialise sector edge vector used for building the boundary fence
-    init_boundary();
+    // initialise sectors and the sector edge vector used for building the boundary fence
+    init_sectors(PROXIMITY_NUM_SECTORS);
 }
 
 // get distance and angle to closest object (used for pre-arm check)
@@ -41,7 +41,7 @@ bool AP_Proximity_Backend::get_closest_object(float& angle_deg, float &distance)
     uint8_t sector = 0;
 
     // check all sectors for shorter distance
-    for (uint8_t i=0; i<PROXIMITY_NUM_SECTORS; i++) {
+    for (uint8_t i=0; i<_num_sectors; i++) {
         if (_distance_valid[i]) {
             if (!sector_found || (_distance[i] < _distance[sector])) {
                 sector = i;
@@ -60,14 +60,14 @@ bool AP_Proximity_Backend::get_closest_object(float& angle_deg, float &distance)
 // get number of objects, used for non-GPS avoidance
 uint8_t AP_Proximity_Backend::get_object_count() const
 {
-    return PROXIMITY_NUM_SECTORS;
+    return _num_sectors;
 }
 
 // get an object's angle and distance, used for non-GPS avoidance
 // returns false if no angle or distance could be returned for some reason
 bool AP_Proximity_Backend::get_object_angle_and_distance(uint8_t object_number, float& angle_deg, float &distance) const
 {
-    if (object_number < PROXIMITY_NUM_SECTORS && _distance_valid[object_number]) {
+    if (object_number < _num_sectors && _distance_valid[object_number]) {
         angle_deg = _angle[object_number];
         distance = _distance[object_number];
         return true;
@@ -80,7 +80,7 @@ bool AP_Proximity_Backend::get_horizontal_distances(AP_Proximity::Proximity_Dist
 {
     // exit immediately if we have no good ranges
     bool valid_distances = false;
-    for (uint8_t i=0; i<PROXIMITY_NUM_SECTORS; i++) {
+    for (uint8_t i=0; i<_num_sectors; i++) {
         if (_distance_valid[i]) {
             valid_distances = true;
             break;
@@ -100,7 +100,7 @@ bool AP_Proximity_Backend::get_horizontal_distances(AP_Proximity::Proximity_Dist
     }
 
     // cycle through all sectors filling in distances
-    for (uint8_t i=0; i<PROXIMITY_NUM_SECTORS; i++) {
+    for (uint8_t i=0; i<_num_sectors; i++) {
         if (_distance_valid[i]) {
             // convert angle to orientation
             int16_t orientation = static_cast<int16_t>(_angle[i] * (PROXIMITY_MAX_DIRECTION / 360.0f));
@@ -136,7 +136,7 @@ const Vector2f* AP_Proximity_Backend::get_boundary_points(uint16_t& num_points)
 
     // check at least one sector has valid data, if not, exit
     bool some_valid = false;
-    for (uint8_t i=0; i<PROXIMITY_NUM_SECTORS; i++) {
+    for (uint8_t i=0; i<_num_sectors; i++) {
         if (_distance_valid[i]) {
             some_valid = true;
             break;
@@ -148,16 +148,29 @@ const Vector2f* AP_Proximity_Backend::get_boundary_points(uint16_t& num_points)
     }
 
     // return boundary points
-    num_points = PROXIMITY_NUM_SECTORS;
+    num_points = _num_sectors;
     return _boundary_point;
 }
 
+// set the number of sectors the sensor's readings are held in, limited to PROXIMITY_MAX_SECTORS.
+// sectors must be a whole number of degrees wide. Clears all readings and the boundary
+void AP_Proximity_Backend::init_sectors(uint8_t num_sectors)
+{
+    _num_sectors = constrain_int16(num_sectors, PROXIMITY_NUM_SECTORS, PROXIMITY_MAX_SECTORS);
+    _sector_width_deg = 360.0f / _num_sectors;
+    for (uint8_t sector=0; sector < _num_sectors; sector++) {
+        _sector_middle_deg[sector] = (uint16_t)sector * 360 / _num_sectors;
+        _distance_valid[sector] = false;
+    }
+    init_boundary();
+}
+
 // initialise the boundary and sector_edge_vector array used for object avoidance
 //   should be called if the sector_middle_deg or _setor_width_deg arrays are changed
 void AP_Proximity_Backend::init_boundary()
 {
-    for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-        float angle_rad = radians((float)_sector_middle_deg[sector]+(PROXIMITY_SECTOR_WIDTH_DEG/2.0f));
+    for (uint8_t sector=0; sector < _num_sectors; sector++) {
+        float angle_rad = radians((float)_sector_middle_deg[sector]+(_sector_width_deg/2.0f));
         _sector_edge_vector[sector].x = cosf(angle_rad) * 100.0f;
         _sector_edge_vector[sector].y = sinf(angle_rad) * 100.0f;
         _boundary_point[sector] = _sector_edge_vector[sector] * PROXIMITY_BOUNDARY_DIST_DEFAULT;
@@ -170,7 +183,7 @@ void AP_Proximity_Backend::init_boundary()
 void AP_Proximity_Backend::update_boundary_for_sector(const uint8_t sector, const bool push_to_OA_DB)
 {
     // sanity check
-    if (sector >= PROXIMITY_NUM_SECTORS) {
+    if (sector >= _num_sectors) {
         return;
     }
 
@@ -180,7 +193,7 @@ void AP_Proximity_Backend::update_boundary_for_sector(const uint8_t sector, cons
 
     // find adjacent sector (clockwise)
     uint8_t next_sector = sector + 1;
-    if (next_sector >= PROXIMITY_NUM_SECTORS) {
+    if (next_sector >= _num_sectors) {
         next_sector = 0;
     }
 
@@ -204,7 +217,7 @@ void AP_Proximity_Backend::update_boundary_for_sector(const uint8_t sector, cons
     }
 
     // repeat for edge between sector and previous sector
-    uint8_t prev_sector = (sector == 0) ? PROXIMITY_NUM_SECTORS-1 : sector-1;
+    uint8_t prev_sector = (sector == 0) ? _num_sectors-1 : sector-1;
     shortest_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
     if (_distance_valid[prev_sector] && _distance_valid[sector]) {
         shortest_distance = MIN(_distance[prev_sector], _distance[sector]);
@@ -216,12 +229,27 @@ void AP_Proximity_Backend::update_boundary_for_sector(const uint8_t sector, cons
     _boundary_point[prev_sector] = _sector_edge_vector[prev_sector] * shortest_distance;
 
     // if the sector counter-clockwise from the previous sector has an invalid distance, set boundary to create a cup like boundary
-    uint8_t prev_sector_ccw = (prev_sector == 0) ? PROXIMITY_NUM_SECTORS - 1 : prev_sector - 1;
+    uint8_t prev_sector_ccw = (prev_sector == 0) ? _num_sectors - 1 : prev_sector - 1;
     if (!_distance_valid[prev_sector_ccw]) {
         _boundary_point[prev_sector_ccw] = _sector_edge_vector[prev_sector_ccw] * shortest_distance;
     }
 }
 
+// update every sector within half of width_deg of angle_deg with a single reading and update their boundary points
+//   used by sensors with a field of view wider than a sector
+void AP_Proximity_Backend::update_sectors_in_arc(float angle_deg, float width_deg, float distance, bool valid)
+{
+    const uint8_t count = constrain_int16(width_deg / _sector_width_deg + 0.5f, 1, _num_sectors);
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t sector = convert_angle_to_sector(angle_deg + (i - (count - 1) * 0.5f) * _sector_width_deg);
+        // the object may be anywhere in the arc so spread it across the sectors
+        _angle[sector] = (count > 1) ? _sector_middle_deg[sector] : angle_deg;
+        _distance[sector] = distance;
+        _distance_valid[sector] = valid;
+        update_boundary_for_sector(sector, false);
+    }
+}
+
 // set status and update valid count
 void AP_Proximity_Backend::set_status(AP_Proximity::Status status)
 {
@@ -230,7 +258,9 @@ void AP_Proximity_Backend::set_status(AP_Proximity::Status status)
 
 uint8_t AP_Proximity_Backend::convert_angle_to_sector(float angle_degrees) const
 {
-    return wrap_360(angle_degrees + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) / 45.0f;
+    const uint8_t sector = wrap_360(angle_degrees + (_sector_width_deg * 0.5f)) / _sector_width_deg;
+    // guard against rounding up to 360 degrees
+    return MIN(sector, _num_sectors - 1);
 }
 
 // check if a reading should be ignored because it falls into an ignore area
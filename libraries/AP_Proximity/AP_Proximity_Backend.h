@@ -19,8 +19,16 @@
 #include "AP_Proximity.h"
 #include <AP_Common/Location.h>
 
-#define PROXIMITY_NUM_SECTORS           8       // number of sectors
-#define PROXIMITY_SECTOR_WIDTH_DEG      45.0f   // width of sectors in degrees
+#define PROXIMITY_NUM_SECTORS           8       // default number of sectors, 45 degrees wide
+
+// maximum number of sectors for sensors which scan at high resolution
+#ifndef PROXIMITY_MAX_SECTORS
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define PROXIMITY_MAX_SECTORS           72      // 5 degree sectors
+#else
+#define PROXIMITY_MAX_SECTORS           PROXIMITY_NUM_SECTORS
+#endif
+#endif
 #define PROXIMITY_BOUNDARY_DIST_MIN 0.6f    // minimum distance for a boundary point.  This ensures the object avoidance code doesn't think we are outside the boundary.
 #define PROXIMITY_BOUNDARY_DIST_DEFAULT 100 // if we have no data for a sector, boundary is placed 100m out
 
@@ -67,6 +75,10 @@ protected:
     // set status and update valid_count
     void set_status(AP_Proximity::Status status);
 
+    // set the number of sectors the sensor's readings are held in, limited to PROXIMITY_MAX_SECTORS.
+    // sectors must be a whole number of degrees wide. Clears all readings and the boundary
+    void init_sectors(uint8_t num_sectors);
+
     // find which sector a given angle falls into
     uint8_t convert_angle_to_sector(float angle_degrees) const;
 
@@ -79,6 +91,10 @@ protected:
     //   the boundary point is set to the shortest distance found in the two adjacent sectors, this is a conservative boundary around the vehicle
     void update_boundary_for_sector(const uint8_t sector, const bool push_to_OA_DB);
 
+    // update every sector within half of width_deg of angle_deg with a single reading and update their boundary points
+    //   used by sensors with a field of view wider than a sector
+    void update_sectors_in_arc(float angle_deg, float width_deg, float distance, bool valid);
+
     // check if a reading should be ignored because it falls into an ignore area
     // angles should be in degrees and in the range of 0 to 360
     bool ignore_reading(uint16_t angle_deg) const;
@@ -92,14 +108,16 @@ protected:
     AP_Proximity::Proximity_State &state;   // reference to this instances state
 
     // sectors
-    const uint16_t _sector_middle_deg[PROXIMITY_NUM_SECTORS] = {0, 45, 90, 135, 180, 225, 270, 315};    // middle angle of each sector
+    uint8_t _num_sectors;                               // number of sectors in use
+    float _sector_width_deg;                            // width of each sector in degrees
+    uint16_t _sector_middle_deg[PROXIMITY_MAX_SECTORS]; // middle angle of each sector
 
     // sensor data
-    float _angle[PROXIMITY_NUM_SECTORS];            // angle to closest object within each sector
-    float _distance[PROXIMITY_NUM_SECTORS];         // distance to closest object within each sector
-    bool _distance_valid[PROXIMITY_NUM_SECTORS];    // true if a valid distance received for each sector
+    float _angle[PROXIMITY_MAX_SECTORS];            // angle to closest object within each sector
+    float _distance[PROXIMITY_MAX_SECTORS];         // distance to closest object within each sector
+    bool _distance_valid[PROXIMITY_MAX_SECTORS];    // true if a valid distance received for each sector
 
     // fence boundary
-    Vector2f _sector_edge_vector[PROXIMITY_NUM_SECTORS];    // vector for right-edge of each sector, used to speed up calculation of boundary
-    Vector2f _boundary_point[PROXIMITY_NUM_SECTORS];        // bounding polygon around the vehicle calculated conservatively for object avoidance
+    Vector2f _sector_edge_vector[PROXIMITY_MAX_SECTORS];    // vector for right-edge of each sector, used to speed up calculation of boundary
+    Vector2f _boundary_point[PROXIMITY_MAX_SECTORS];        // bounding polygon around the vehicle calculated conservatively for object avoidance
 };
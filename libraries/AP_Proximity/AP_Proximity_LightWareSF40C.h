@@ -12,7 +12,12 @@ class AP_Proximity_LightWareSF40C : public AP_Proximity_Backend_Serial
 
 public:
     // constructor
-    using AP_Proximity_Backend_Serial::AP_Proximity_Backend_Serial;
+    AP_Proximity_LightWareSF40C(AP_Proximity &_frontend, AP_Proximity::Proximity_State &_state) :
+        AP_Proximity_Backend_Serial(_frontend, _state)
+    {
+        // scanning sensor, keep its readings at high resolution
+        init_sectors(PROXIMITY_MAX_SECTORS);
+    }
 
     uint16_t rxspace() const override {
         return 1280;
@@ -197,14 +197,14 @@ bool AP_Proximity_LightWareSF40C_v09::send_request_for_distance()
 
     // increment sector
     _last_sector++;
-    if (_last_sector >= PROXIMITY_NUM_SECTORS) {
+    if (_last_sector >= _num_sectors) {
         _last_sector = 0;
     }
 
     // prepare request
     char request_str[16];
     snprintf(request_str, sizeof(request_str), "?TS,%u,%u\r\n",
-             (unsigned int)PROXIMITY_SECTOR_WIDTH_DEG,
+             (unsigned int)_sector_width_deg,
              _sector_middle_deg[_last_sector]);
     _uart->write(request_str);
 
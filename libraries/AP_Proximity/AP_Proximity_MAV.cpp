@@ -53,14 +53,17 @@ void AP_Proximity_MAV::handle_msg(const mavlink_message_t &msg)
 
         // store distance to appropriate sector based on orientation field
         if (packet.orientation <= MAV_SENSOR_ROTATION_YAW_315) {
-            uint8_t sector = packet.orientation;
-            _angle[sector] = sector * 45;
-            _distance[sector] = packet.current_distance * 0.01f;
+            const float angle = packet.orientation * 45;
+            const float distance = packet.current_distance * 0.01f;
             _distance_min = packet.min_distance * 0.01f;
             _distance_max = packet.max_distance * 0.01f;
-            _distance_valid[sector] = (_distance[sector] >= _distance_min) && (_distance[sector] <= _distance_max);
+            const bool valid = (distance >= _distance_min) && (distance <= _distance_max);
             _last_update_ms = AP_HAL::millis();
-            update_boundary_for_sector(sector, true);
+            // each orientation covers 45 degrees
+            update_sectors_in_arc(angle, 45.0f, distance, valid);
+            if (valid) {
+                database_push(angle, distance);
+            }
         }
 
         // store upward distance
@@ -108,13 +111,18 @@ void AP_Proximity_MAV::handle_msg(const mavlink_message_t &msg)
         const bool database_ready = database_prepare_for_push(current_pos, current_heading);
 
         // initialise updated array and proximity sector angles (to closest object) and distances
-        bool sector_updated[PROXIMITY_NUM_SECTORS];
-        for (uint8_t i = 0; i < PROXIMITY_NUM_SECTORS; i++) {
+        bool sector_updated[PROXIMITY_MAX_SECTORS];
+        bool sector_was_valid[PROXIMITY_MAX_SECTORS];
+        for (uint8_t i = 0; i < _num_sectors; i++) {
             sector_updated[i] = false;
+            sector_was_valid[i] = _distance_valid[i];
             _angle[i] = _sector_middle_deg[i];
             _distance[i] = MAX_DISTANCE;
         }
 
+        // readings wider than a sector are spread over several sectors
+        const uint8_t sectors_per_reading = constrain_int16(fabsf(increment) / _sector_width_deg + 0.5f, 1, _num_sectors);
+
         // iterate over message's sectors
         for (uint8_t j = 0; j < total_distances; j++) {
             const uint16_t distance_cm = packet.distances[j];
@@ -130,11 +138,10 @@ void AP_Proximity_MAV::handle_msg(const mavlink_message_t &msg)
             const float packet_distance_m = distance_cm * 0.01f;
             const float mid_angle = wrap_360((float)j * increment + yaw_correction);
 
-            // iterate over proximity sectors
-            for (uint8_t i = 0; i < PROXIMITY_NUM_SECTORS; i++) {
-                float angle_diff = fabsf(wrap_180(_sector_middle_deg[i] - mid_angle));
-                // update distance array sector with shortest distance from message
-                if ((angle_diff <= (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) && (packet_distance_m < _distance[i])) {
+            // update the sectors covered by the reading with the shortest distance from message
+            for (uint8_t k = 0; k < sectors_per_reading; k++) {
+                const uint8_t i = convert_angle_to_sector(mid_angle + (k - (sectors_per_reading - 1) * 0.5f) * _sector_width_deg);
+                if (packet_distance_m < _distance[i]) {
                     _distance[i] = packet_distance_m;
                     _angle[i] = mid_angle;
                     sector_updated[i] = true;
@@ -147,10 +154,12 @@ void AP_Proximity_MAV::handle_msg(const mavlink_message_t &msg)
             }
         }
 
-        // update proximity sectors validity and boundary point
-        for (uint8_t i = 0; i < PROXIMITY_NUM_SECTORS; i++) {
+        // update proximity sectors validity and the boundary points of sectors which changed
+        for (uint8_t i = 0; i < _num_sectors; i++) {
             _distance_valid[i] = (_distance[i] >= _distance_min) && (_distance[i] <= _distance_max);
-            if (sector_updated[i]) {
+        }
+        for (uint8_t i = 0; i < _num_sectors; i++) {
+            if (sector_updated[i] || sector_was_valid[i] != _distance_valid[i]) {
                 update_boundary_for_sector(i, false);
             }
         }
@@ -8,7 +8,12 @@ class AP_Proximity_MAV : public AP_Proximity_Backend
 
 public:
     // constructor
-    using AP_Proximity_Backend::AP_Proximity_Backend;
+    AP_Proximity_MAV(AP_Proximity &_frontend, AP_Proximity::Proximity_State &_state) :
+        AP_Proximity_Backend(_frontend, _state)
+    {
+        // OBSTACLE_DISTANCE messages usually hold 72 readings, keep them at high resolution
+        init_sectors(PROXIMITY_MAX_SECTORS);
+    }
 
     // update state
     void update(void) override;
@@ -61,7 +61,7 @@ void AP_Proximity_MorseSITL::update(void)
 
 #if 0
     printf("npoints=%u\n", points.length);
-    for (uint16_t i=0; i<PROXIMITY_NUM_SECTORS; i++) {
+    for (uint16_t i=0; i<_num_sectors; i++) {
         printf("sector[%u] ang=%.1f dist=%.1f\n", i, _angle[i], _distance[i]);
     }
 #endif
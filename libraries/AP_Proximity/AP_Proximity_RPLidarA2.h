@@ -39,7 +39,12 @@ class AP_Proximity_RPLidarA2 : public AP_Proximity_Backend_Serial
 
 public:
 
-    using AP_Proximity_Backend_Serial::AP_Proximity_Backend_Serial;
+    AP_Proximity_RPLidarA2(AP_Proximity &_frontend, AP_Proximity::Proximity_State &_state) :
+        AP_Proximity_Backend_Serial(_frontend, _state)
+    {
+        // scanning sensor, keep its readings at high resolution
+        init_sectors(PROXIMITY_MAX_SECTORS);
+    }
 
     // update state
     void update(void) override;
@@ -0,0 +1,135 @@
+//
+// Benchmark of the proximity sector model and its use by AC_Avoid.
+// 72 reading OBSTACLE_DISTANCE messages describing a room are fed to
+// the MAVLink proximity backend and the cost of handling each message
+// and of adjusting the velocity against the resulting boundary is
+// printed.
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_Baro/AP_Baro.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_Compass/AP_Compass.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_AHRS/AP_AHRS_DCM.h>
+#include <AP_Proximity/AP_Proximity.h>
+#include <AC_Avoidance/AC_Avoid.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+const struct AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+class Parameters {
+public:
+    enum {
+        k_param_proximity = 1,
+        k_param_avoid,
+    };
+};
+
+static AP_InertialSensor ins;
+static AP_Baro baro;
+static AP_GPS gps;
+static Compass compass;
+static AP_AHRS_DCM ahrs{};
+static GCS_Dummy _gcs;
+static AP_Proximity proximity;
+static AC_Avoid avoid;
+
+const struct AP_Param::Info var_info[] = {
+    { AP_PARAM_GROUP, "PRX", Parameters::k_param_proximity, (const void *)&proximity, {group_info : AP_Proximity::var_info} },
+    { AP_PARAM_GROUP, "AVOID_", Parameters::k_param_avoid, (const void *)&avoid, {group_info : AC_Avoid::var_info} },
+    AP_VAREND
+};
+
+static AP_Param param{var_info};
+
+static const uint8_t readings = 72;
+
+// distance from the vehicle to the walls of a 12m x 8m room in a direction, with a pillar 3m ahead
+static float room_distance(float angle_deg, const Vector2f &pos)
+{
+    const Vector2f dir(cosf(radians(angle_deg)), sinf(radians(angle_deg)));
+    float dist = 100.0f;
+    if (!is_zero(dir.x)) {
+        dist = MIN(dist, ((dir.x > 0 ? 6.0f : -6.0f) - pos.x) / dir.x);
+    }
+    if (!is_zero(dir.y)) {
+        dist = MIN(dist, ((dir.y > 0 ? 4.0f : -4.0f) - pos.y) / dir.y);
+    }
+    Vector2f intersection;
+    if (Vector2f::circle_segment_intersection(pos, pos + dir * dist, Vector2f(3.0f, 0.5f), 0.5f, intersection)) {
+        dist = (intersection - pos).length();
+    }
+    return dist;
+}
+
+static void send_scan(uint32_t n)
+{
+    const Vector2f pos(-2.0f + 0.5f * sinf(n * 0.05f), 0.5f * cosf(n * 0.05f));
+
+    mavlink_obstacle_distance_t packet {};
+    packet.increment = 360 / readings;
+    packet.min_distance = 20;
+    packet.max_distance = 2000;
+    for (uint8_t i = 0; i < readings; i++) {
+        packet.distances[i] = room_distance(i * packet.increment, pos) * 100;
+    }
+
+    mavlink_message_t msg;
+    mavlink_msg_obstacle_distance_encode(1, 1, &msg, &packet);
+    proximity.handle_msg(msg);
+}
+
+void setup(void)
+{
+    hal.console->printf("Proximity benchmark\n");
+
+    AP_Param::setup();
+    AP_Param::set_by_name("PRX_TYPE", (float)AP_Proximity::Type::MAV);
+    AP_Param::set_by_name("AVOID_ENABLE", AC_AVOID_USE_PROXIMITY_SENSOR);
+    proximity.init();
+}
+
+void loop(void)
+{
+    const uint16_t iterations = 1000;
+    static uint32_t n;
+
+    uint64_t msg_us = 0;
+    uint64_t avoid_us = 0;
+    float speed_sum = 0;
+    for (uint16_t i = 0; i < iterations; i++, n++) {
+        uint64_t start_us = AP_HAL::micros64();
+        send_scan(n);
+        msg_us += AP_HAL::micros64() - start_us;
+        proximity.update();
+
+        // fly at 5m/s in a direction sweeping round the room
+        const float heading = radians((n * 7) % 360);
+        Vector2f vel_cms(cosf(heading) * 500.0f, sinf(heading) * 500.0f);
+        start_us = AP_HAL::micros64();
+        avoid.adjust_velocity(1.0f, 100.0f, vel_cms, 0.0025f);
+        avoid_us += AP_HAL::micros64() - start_us;
+        speed_sum += vel_cms.length();
+    }
+
+    uint16_t num_points = 0;
+    proximity.get_boundary_points(num_points);
+    hal.console->printf("%u boundary points: %.1f us per message, %.2f us per adjust_velocity, mean speed %.0f cm/s\n",
+                        (unsigned)num_points,
+                        (double)(msg_us / float(iterations)),
+                        (double)(avoid_us / float(iterations)),
+                        (double)(speed_sum / iterations));
+    hal.scheduler->delay(2000);
+}
+
+AP_HAL_MAIN();
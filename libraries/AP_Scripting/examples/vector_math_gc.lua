@@ -0,0 +1,51 @@
+-- This script compares the memory allocated by vector math using the
+-- operators against the in place methods, which modify the first vector
+-- instead of creating a new one for every result
+
+local iterations = 1000
+
+local function test_operators(a, b)
+  local sum = Vector3f()
+  for i = 1, iterations do
+    sum = sum + a
+    sum = sum - b
+  end
+  return sum
+end
+
+local function test_inplace(a, b)
+  local sum = Vector3f()
+  for i = 1, iterations do
+    sum:add_inplace(a)
+    sum:sub_inplace(b)
+  end
+  return sum
+end
+
+local function measure_kb(func, a, b)
+  collectgarbage("collect")
+  collectgarbage("stop")
+  local start = collectgarbage("count")
+  func(a, b)
+  local used = collectgarbage("count") - start
+  collectgarbage("restart")
+  return used
+end
+
+function update() -- this is the loop which periodically runs
+  local a = Vector3f()
+  local b = Vector3f()
+  a:x(1.0)
+  a:y(2.0)
+  a:z(3.0)
+  b:x(0.5)
+
+  local op_kb = measure_kb(test_operators, a, b)
+  local inplace_kb = measure_kb(test_inplace, a, b)
+  gcs:send_text(6, string.format("vector math per iteration: operators %.1f bytes, in place %.1f bytes",
+                                 op_kb * 1024 / iterations, inplace_kb * 1024 / iterations))
+
+  return update, 5000 -- reschedules the loop
+end
+
+return update() -- run immediately before starting to reschedule
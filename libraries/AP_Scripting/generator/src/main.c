@@ -1574,6 +1574,24 @@ const char * get_name_for_operation(enum operator_type op) {
   return NULL;
 }
 
+// name of the mutating method emitted alongside each operator, this allows
+// scripts to do math without allocating a new userdata for every result
+const char * get_inplace_name_for_operation(enum operator_type op) {
+  switch (op) {
+    case OP_ADD:
+      return "add_inplace";
+    case OP_SUB:
+      return "sub_inplace";
+    case OP_MUL:
+      return "mul_inplace";
+    case OP_DIV:
+      return "div_inplace";
+    case OP_LAST:
+      return NULL;
+  }
+  return NULL;
+}
+
 void emit_operators(struct userdata *data) {
   trace(TRACE_USERDATA, "Emitting operators for %s", data->name);
 
@@ -1616,6 +1634,17 @@ void emit_operators(struct userdata *data) {
     fprintf(source, "    return 1;\n");
     fprintf(source, "}\n\n");
 
+    // in place variant, modifies the first argument and returns it
+    fprintf(source, "static int %s_%s(lua_State *L) {\n", data->sanatized_name, get_inplace_name_for_operation((data->operations) & i));
+    fprintf(source, "    binding_argcheck(L, 2);\n");
+    fprintf(source, "    %s *ud = check_%s(L, 1);\n", data->name, data->sanatized_name);
+    fprintf(source, "    %s *ud2 = check_%s(L, 2);\n", data->name, data->sanatized_name);
+    fprintf(source, "    *ud %c= *ud2;\n", op_sym);
+    // leave only the first argument on the stack to be returned
+    fprintf(source, "    lua_settop(L, 1);\n");
+    fprintf(source, "    return 1;\n");
+    fprintf(source, "}\n\n");
+
   }
 }
 
@@ -1659,6 +1688,8 @@ void emit_userdata_metatables(void) {
         continue;
       }
       fprintf(source, "    {\"%s\", %s_%s},\n", op_name, node->sanatized_name, op_name);
+      const char * inplace_name = get_inplace_name_for_operation((node->operations) & i);
+      fprintf(source, "    {\"%s\", %s_%s},\n", inplace_name, node->sanatized_name, inplace_name);
     }
 
     fprintf(source, "    {NULL, NULL}\n");
@@ -340,6 +340,15 @@ static int Vector2f___add(lua_State *L) {
     return 1;
 }
 
+static int Vector2f_add_inplace(lua_State *L) {
+    binding_argcheck(L, 2);
+    Vector2f *ud = check_Vector2f(L, 1);
+    Vector2f *ud2 = check_Vector2f(L, 2);
+    *ud += *ud2;
+    lua_settop(L, 1);
+    return 1;
+}
+
 static int Vector2f___sub(lua_State *L) {
     binding_argcheck(L, 2);
     Vector2f *ud = check_Vector2f(L, 1);
@@ -349,6 +358,15 @@ static int Vector2f___sub(lua_State *L) {
     return 1;
 }
 
+static int Vector2f_sub_inplace(lua_State *L) {
+    binding_argcheck(L, 2);
+    Vector2f *ud = check_Vector2f(L, 1);
+    Vector2f *ud2 = check_Vector2f(L, 2);
+    *ud -= *ud2;
+    lua_settop(L, 1);
+    return 1;
+}
+
 static int Vector3f_is_zero(lua_State *L) {
     binding_argcheck(L, 1);
     Vector3f * ud = check_Vector3f(L, 1);
@@ -402,6 +420,15 @@ static int Vector3f___add(lua_State *L) {
     return 1;
 }
 
+static int Vector3f_add_inplace(lua_State *L) {
+    binding_argcheck(L, 2);
+    Vector3f *ud = check_Vector3f(L, 1);
+    Vector3f *ud2 = check_Vector3f(L, 2);
+    *ud += *ud2;
+    lua_settop(L, 1);
+    return 1;
+}
+
 static int Vector3f___sub(lua_State *L) {
     binding_argcheck(L, 2);
     Vector3f *ud = check_Vector3f(L, 1);
@@ -411,6 +438,15 @@ static int Vector3f___sub(lua_State *L) {
     return 1;
 }
 
+static int Vector3f_sub_inplace(lua_State *L) {
+    binding_argcheck(L, 2);
+    Vector3f *ud = check_Vector3f(L, 1);
+    Vector3f *ud2 = check_Vector3f(L, 2);
+    *ud -= *ud2;
+    lua_settop(L, 1);
+    return 1;
+}
+
 static int Location_get_distance_NE(lua_State *L) {
     binding_argcheck(L, 2);
     Location * ud = check_Location(L, 1);
@@ -498,7 +534,9 @@ const luaL_Reg Vector2f_meta[] = {
     {"normalize", Vector2f_normalize},
     {"length", Vector2f_length},
     {"__add", Vector2f___add},
+    {"add_inplace", Vector2f_add_inplace},
     {"__sub", Vector2f___sub},
+    {"sub_inplace", Vector2f_sub_inplace},
     {NULL, NULL}
 };
 
@@ -512,7 +550,9 @@ const luaL_Reg Vector3f_meta[] = {
     {"normalize", Vector3f_normalize},
     {"length", Vector3f_length},
     {"__add", Vector3f___add},
+    {"add_inplace", Vector3f_add_inplace},
     {"__sub", Vector3f___sub},
+    {"sub_inplace", Vector3f_sub_inplace},
     {NULL, NULL}
 };
 
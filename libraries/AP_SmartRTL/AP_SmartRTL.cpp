@@ -30,8 +30,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3.5k of memory.
+    // @Range: 0 2000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -104,17 +104,20 @@ void AP_SmartRTL::init()
 
     _prune.loops_max = _points_max * SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT;
     _prune.loops = (prune_loop_t*)calloc(_prune.loops_max, sizeof(prune_loop_t));
+    _prune.path_length = (float*)calloc(_points_max, sizeof(float));
 
     _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
     _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
 
     // check if memory allocation failed
-    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
+    if (_path == nullptr || _prune.loops == nullptr || _prune.path_length == nullptr || _simplify.stack == nullptr) {
         log_action(SRTL_DEACTIVATED_INIT_FAILED);
         gcs().send_text(MAV_SEVERITY_WARNING, "SmartRTL deactivated: init failed");
         free(_path);
         free(_prune.loops);
+        free(_prune.path_length);
         free(_simplify.stack);
+        _path = nullptr;
         return;
     }
 
@@ -526,6 +529,8 @@ void AP_SmartRTL::detect_simplifications()
 *   This method runs for the allotted time, and detects loops in a path. Any detected loops are added to _prune.loops,
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
 *   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
+*   Segments are skipped without being compared if their distance along the path from a point is less than that point's
+*   distance from the outer segment (i.e. the path could not have come back close enough to form a loop).
 *
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
@@ -558,6 +563,28 @@ void AP_SmartRTL::detect_loops()
             }
         }
 
+        // the inner loop's segments from j onwards are all within (path_length[k] - path_length[j-1]) of point j-1 so
+        // cannot come within SMARTRTL_PRUNING_DELTA of the outer loop's segment while this is less than clearance
+        const Vector3f &seg_start = _path[_prune.i];
+        const Vector3f &seg_end = _path[_prune.i-1];
+        const float clearance = (_path[_prune.j-1] - (seg_start + seg_end) * 0.5f).length() - (seg_start - seg_end).length() * 0.5f - SMARTRTL_PRUNING_DELTA;
+        if (clearance > _prune.path_length[_prune.j] - _prune.path_length[_prune.j-1]) {
+            // binary search for the last segment that cannot be close enough, the inner loop will advance past it
+            const float max_path_length = _prune.path_length[_prune.j-1] + clearance;
+            uint16_t low = _prune.j;
+            uint16_t high = _prune.i - 2;
+            while (low < high) {
+                const uint16_t mid = high - (high - low) / 2;
+                if (_prune.path_length[mid] < max_path_length) {
+                    low = mid;
+                } else {
+                    high = mid - 1;
+                }
+            }
+            _prune.j = low;
+            continue;
+        }
+
         // find the closest distance between two line segments and the mid-point
         dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
         if (dp.distance < SMARTRTL_PRUNING_DELTA) {
@@ -615,6 +642,14 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
     _prune.j = 0;
     _prune.path_points_count = path_points_count;
+
+    // calculate distance along the path to each point
+    if (path_points_count > 0) {
+        _prune.path_length[0] = 0.0f;
+    }
+    for (uint16_t k = 1; k < path_points_count; k++) {
+        _prune.path_length[k] = _prune.path_length[k-1] + (_path[k] - _path[k-1]).length();
+    }
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
@@ -33,6 +33,9 @@ void setup();
 void loop();
 void reset();
 void check_path(const std::vector<Vector3f> &correct_path, const char* test_name, uint32_t time_us);
+void benchmark_pruning(const std::vector<Vector3f> &path, const char* test_name);
+std::vector<Vector3f> lawnmower_path(uint16_t num_points);
+std::vector<Vector3f> random_path(uint16_t num_points);
 
 void setup()
 {
@@ -76,6 +79,10 @@ void loop()
     run_time = AP_HAL::micros() - reference_time;
     check_path(test_path_complete, "simplify and pruning", run_time);
 
+    // time pruning of generated paths that nearly fill the path array
+    benchmark_pruning(lawnmower_path(SMARTRTL_POINTS_DEFAULT - SMARTRTL_CLEANUP_START_MARGIN), "lawnmower pruning");
+    benchmark_pruning(random_path(SMARTRTL_POINTS_DEFAULT - SMARTRTL_CLEANUP_START_MARGIN), "random pruning");
+
     // delay before next display
     hal.scheduler->delay(5e3); // 5 seconds
 }
@@ -129,4 +136,54 @@ void check_path(const std::vector<Vector3f>& correct_path, const char* test_name
     }
 }
 
+// upload path to smart_rtl and display the time taken to find and remove all loops
+void benchmark_pruning(const std::vector<Vector3f> &path, const char* test_name)
+{
+    hal.scheduler->delay(5);    // delay 5 milliseconds because request_through_cleanup uses millisecond timestamps
+    smart_rtl.set_home(true, Vector3f{0.0f, 0.0f, 0.0f});
+    for (const Vector3f &v : path) {
+        smart_rtl.update(true, v);
+    }
+    const uint16_t points_before = smart_rtl.get_num_points();
+
+    const uint32_t reference_time = AP_HAL::micros();
+    while (!smart_rtl.request_thorough_cleanup(AP_SmartRTL::THOROUGH_CLEAN_PRUNE_ONLY)) {
+        smart_rtl.run_background_cleanup();
+    }
+    const uint32_t run_time = AP_HAL::micros() - reference_time;
+
+    hal.console->printf("%s: time:%u us\n", test_name, (unsigned)run_time);
+    hal.console->printf("   points before %u, after %u\n", (unsigned)points_before, (unsigned)smart_rtl.get_num_points());
+}
+
+// survey pattern of parallel 3m spaced lines, 60m long and 10m apart, which never comes back on itself
+std::vector<Vector3f> lawnmower_path(uint16_t num_points)
+{
+    std::vector<Vector3f> path;
+    const uint16_t points_per_line = 20;
+    for (uint16_t i = 1; i <= num_points; i++) {
+        const uint16_t line = i / points_per_line;
+        const uint16_t pos = i % points_per_line;
+        const float north = (line % 2 == 0) ? pos * 3.0f : (points_per_line - pos) * 3.0f;
+        path.push_back(Vector3f{north, line * 10.0f, 0.0f});
+    }
+    return path;
+}
+
+// random walk with 3m steps which crosses itself many times
+std::vector<Vector3f> random_path(uint16_t num_points)
+{
+    std::vector<Vector3f> path;
+    Vector3f pos;
+    uint32_t seed = 1;
+    for (uint16_t i = 1; i <= num_points; i++) {
+        // simple linear congruential generator so the path is the same on every board
+        seed = seed * 1103515245U + 12345U;
+        const float heading = radians((seed >> 16) % 360);
+        pos += Vector3f{cosf(heading), sinf(heading), 0.0f} * 3.0f;
+        path.push_back(pos);
+    }
+    return path;
+}
+
 AP_HAL_MAIN();
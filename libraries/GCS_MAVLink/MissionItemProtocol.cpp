@@ -11,6 +11,8 @@ void MissionItemProtocol::init_send_requests(GCS_MAVLINK &_link,
     timelast_receive_ms = AP_HAL::millis();    // set time we last received commands to now
     receiving = true;              // record that we expect to receive commands
     request_i = _request_first;                 // reset the next expected command number to zero
+    request_sent = _request_first;
+    committing = false;
     request_last = _request_last;         // record how many commands we expect to receive
 
     dest_sysid = msg.sysid;       // record system id of GCS who wants to upload the mission
@@ -142,6 +144,9 @@ void MissionItemProtocol::handle_mission_request_int(const GCS_MAVLINK &_link,
     const MAV_MISSION_RESULT result_code = get_item(_link, msg, packet, ret_packet);
 
     if (result_code != MAV_MISSION_ACCEPTED) {
+        if (item_busy()) {
+            return;
+        }
         // send failure message
         send_mission_ack(_link, msg, result_code);
         return;
@@ -174,6 +179,9 @@ void MissionItemProtocol::handle_mission_request(const GCS_MAVLINK &_link,
 
     MAV_MISSION_RESULT ret = get_item(_link, msg, request_int, item_int);
     if (ret != MAV_MISSION_ACCEPTED) {
+        if (item_busy()) {
+            return;
+        }
         send_mission_ack(_link, msg, ret);
         return;
     }
@@ -220,6 +228,11 @@ void MissionItemProtocol::handle_mission_item(const mavlink_message_t &msg, cons
 
     // check if this is the requested waypoint
     if (cmd.seq != request_i) {
+        if (max_outstanding_requests() > 1 && cmd.seq < request_sent) {
+            // a duplicate, or an item following one which was lost
+            // and will be requested again
+            return;
+        }
         send_mission_ack(msg, MAV_MISSION_INVALID_SEQUENCE);
         return;
     }
@@ -259,6 +272,12 @@ void MissionItemProtocol::handle_mission_item(const mavlink_message_t &msg, cons
     request_i++;
 
     if (request_i > request_last) {
+        if (items_pending()) {
+            // acknowledge from update() once the backend has stored
+            // all items
+            committing = true;
+            return;
+        }
         transfer_is_complete(*link, msg);
         return;
     }
@@ -305,7 +324,7 @@ void MissionItemProtocol::send_mission_ack(const GCS_MAVLINK &_link,
  */
 void MissionItemProtocol::queued_request_send()
 {
-    if (!receiving) {
+    if (!receiving || committing) {
         return;
     }
     if (request_i > request_last) {
@@ -315,13 +334,24 @@ void MissionItemProtocol::queued_request_send()
         AP::internalerror().error(AP_InternalError::error_t::gcs_bad_missionprotocol_link);
         return;
     }
-    mavlink_msg_mission_request_send(
-        link->get_chan(),
-        dest_sysid,
-        dest_compid,
-        request_i,
-        mission_type());
-    timelast_request_ms = AP_HAL::millis();
+    if (request_sent < request_i) {
+        request_sent = request_i;
+    }
+    // send requests up to the end of the window or until the link
+    // is out of space; update() will queue any remaining
+    const uint32_t request_limit = MIN(uint32_t(request_last) + 1,
+                                       uint32_t(request_i) + max_outstanding_requests());
+    while (request_sent < request_limit &&
+           HAVE_PAYLOAD_SPACE(link->get_chan(), MISSION_REQUEST)) {
+        mavlink_msg_mission_request_send(
+            link->get_chan(),
+            dest_sysid,
+            dest_compid,
+            request_sent,
+            mission_type());
+        timelast_request_ms = AP_HAL::millis();
+        request_sent++;
+    }
 }
 
 void MissionItemProtocol::update()
@@ -334,8 +364,16 @@ void MissionItemProtocol::update()
         AP::internalerror().error(AP_InternalError::error_t::gcs_bad_missionprotocol_link);
         return;
     }
-    // stop waypoint receiving if timeout
     const uint32_t tnow = AP_HAL::millis();
+    if (committing && !items_pending()) {
+        // all items received and stored
+        mavlink_message_t msg {};
+        msg.sysid = dest_sysid;
+        msg.compid = dest_compid;
+        transfer_is_complete(*link, msg);
+        return;
+    }
+    // stop waypoint receiving if timeout
     if (tnow - timelast_receive_ms > upload_timeout_ms) {
         receiving = false;
         timeout();
@@ -348,10 +386,19 @@ void MissionItemProtocol::update()
         free_upload_resources();
         return;
     }
+    if (committing) {
+        return;
+    }
     // resend request if we haven't gotten one:
     const uint32_t wp_recv_timeout_ms = 1000U + (link->get_stream_slowdown_ms()*20);
     if (tnow - timelast_request_ms > wp_recv_timeout_ms) {
         timelast_request_ms = tnow;
+        request_sent = request_i;
+        link->send_message(next_item_ap_message_id());
+    } else if (request_sent <= request_last &&
+               request_sent < uint32_t(request_i) + max_outstanding_requests()) {
+        // room in the request window, e.g. the backend has stored
+        // some items
         link->send_message(next_item_ap_message_id());
     }
 }
@@ -21,6 +21,12 @@
 // Starting of uploads (for the same protocol) is also blocked -
 // essentially the GCS uploading a set of items (e.g. a mission) has a
 // mutex over the mission.
+//
+// Backends may allow more than one item request to be outstanding at
+// a time, so a link with a long round trip time is not limited to
+// one item per round trip.  Backends which store items asynchronously
+// report items_pending() until they are stored, and the upload is
+// only acknowledged once all items are stored.
 class MissionItemProtocol
 {
 public:
@@ -78,6 +84,8 @@ private:
     virtual void truncate(const mavlink_mission_count_t &packet) = 0;
 
     uint16_t        request_i; // request index
+    uint16_t        request_sent; // next index to request
+    bool            committing; // all items received, waiting for the backend to store them
 
     // waypoints
     uint8_t         dest_sysid;  // where to send requests
@@ -104,6 +112,17 @@ private:
     }
     virtual void free_upload_resources() { }
 
+    // max_outstanding_requests - number of item requests which may be
+    // sent before the first of them is answered
+    virtual uint16_t max_outstanding_requests() const { return 1; }
+
+    // items_pending - true if received items are yet to be stored
+    virtual bool items_pending() const { return false; }
+
+    // item_busy - true if the last get_item() failed because the item
+    // is still being loaded. No error is sent and the GCS requests it again
+    virtual bool item_busy() const { return false; }
+
     void send_mission_ack(const mavlink_message_t &msg, MAV_MISSION_RESULT result) const;
     void send_mission_ack(const GCS_MAVLINK &link, const mavlink_message_t &msg, MAV_MISSION_RESULT result) const;
 
@@ -23,9 +23,15 @@
 
 #include "GCS.h"
 
+extern const AP_HAL::HAL& hal;
+
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::append_item(const mavlink_mission_item_int_t &mission_item_int)
 {
-    // sanity check for DO_JUMP command
+    return stage_item(mission_item_int);
+}
+
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::stage_item(const mavlink_mission_item_int_t &mission_item_int)
+{
     AP_Mission::Mission_Command cmd {};
 
     const MAV_MISSION_RESULT res = AP_Mission::mavlink_int_to_mission_cmd(mission_item_int, cmd);
@@ -33,15 +39,32 @@ MAV_MISSION_RESULT MissionItemProtocol_Waypoints::append_item(const mavlink_miss
         return res;
     }
 
+    // sanity check for DO_JUMP command
     if (cmd.id == MAV_CMD_DO_JUMP) {
         if ((cmd.content.jump.target >= item_count() && cmd.content.jump.target > request_last) || cmd.content.jump.target == 0) {
             return MAV_MISSION_ERROR;
         }
     }
 
-    if (!mission.add_cmd(cmd)) {
+    if (stage == nullptr) {
+        // no staging buffer, store the item now
+        if (cmd.index < mission.num_commands()) {
+            if (!mission.replace_cmd(cmd.index, cmd)) {
+                return MAV_MISSION_ERROR;
+            }
+        } else if (!mission.add_cmd(cmd)) {
+            return MAV_MISSION_ERROR;
+        }
+        return MAV_MISSION_ACCEPTED;
+    }
+
+    WITH_SEMAPHORE(stage_sem);
+
+    if (stage_failed || stage_count >= MISSION_UPLOAD_STAGE_ITEMS) {
         return MAV_MISSION_ERROR;
     }
+    stage[(stage_head + stage_count) % MISSION_UPLOAD_STAGE_ITEMS] = cmd;
+    stage_count++;
     return MAV_MISSION_ACCEPTED;
 }
 
@@ -52,6 +75,9 @@ bool MissionItemProtocol_Waypoints::clear_all_items()
 
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::complete(const GCS_MAVLINK &_link)
 {
+    if (stage_failed) {
+        return MAV_MISSION_ERROR;
+    }
     _link.send_text(MAV_SEVERITY_INFO, "Flight plan received");
     AP::logger().Write_EntireMission();
     return MAV_MISSION_ACCEPTED;
@@ -100,7 +126,15 @@ MAV_MISSION_RESULT MissionItemProtocol_Waypoints::get_item(const GCS_MAVLINK &_l
 }
 
 uint16_t MissionItemProtocol_Waypoints::item_count() const {
-    return mission.num_commands();
+    WITH_SEMAPHORE(stage_sem);
+
+    // staged items are numbered sequentially and may extend the mission
+    uint16_t count = mission.num_commands();
+    if (stage_count != 0) {
+        const uint16_t last = stage[(stage_head + stage_count - 1) % MISSION_UPLOAD_STAGE_ITEMS].index;
+        count = MAX(count, uint16_t(last + 1));
+    }
+    return count;
 }
 
 uint16_t MissionItemProtocol_Waypoints::max_items() const {
@@ -109,23 +143,7 @@ uint16_t MissionItemProtocol_Waypoints::max_items() const {
 
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::replace_item(const mavlink_mission_item_int_t &mission_item_int)
 {
-    AP_Mission::Mission_Command cmd {};
-
-    const MAV_MISSION_RESULT res = AP_Mission::mavlink_int_to_mission_cmd(mission_item_int, cmd);
-    if (res != MAV_MISSION_ACCEPTED) {
-        return res;
-    }
-
-    // sanity check for DO_JUMP command
-    if (cmd.id == MAV_CMD_DO_JUMP) {
-        if ((cmd.content.jump.target >= item_count() && cmd.content.jump.target > request_last) || cmd.content.jump.target == 0) {
-            return MAV_MISSION_ERROR;
-        }
-    }
-    if (!mission.replace_cmd(cmd.index, cmd)) {
-        return MAV_MISSION_ERROR;
-    }
-    return MAV_MISSION_ACCEPTED;
+    return stage_item(mission_item_int);
 }
 
 void MissionItemProtocol_Waypoints::timeout()
@@ -138,3 +156,80 @@ void MissionItemProtocol_Waypoints::truncate(const mavlink_mission_count_t &pack
     // new mission arriving, truncate mission to be the same length
     mission.truncate(packet.count);
 }
+
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::allocate_receive_resources(const uint16_t count)
+{
+    return allocate_update_resources();
+}
+
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::allocate_update_resources()
+{
+    if (stage == nullptr) {
+        // without a staging buffer items are stored as they arrive,
+        // one request at a time
+        stage = new AP_Mission::Mission_Command[MISSION_UPLOAD_STAGE_ITEMS];
+    }
+    if (stage != nullptr && !io_registered) {
+        io_registered = true;
+        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&MissionItemProtocol_Waypoints::io_timer, void));
+    }
+
+    WITH_SEMAPHORE(stage_sem);
+    stage_head = 0;
+    stage_count = 0;
+    stage_failed = false;
+    return MAV_MISSION_ACCEPTED;
+}
+
+void MissionItemProtocol_Waypoints::free_upload_resources()
+{
+    // the staging buffer is kept for the next upload; drop any
+    // items not yet stored from a failed upload
+    WITH_SEMAPHORE(stage_sem);
+    stage_count = 0;
+}
+
+uint16_t MissionItemProtocol_Waypoints::max_outstanding_requests() const
+{
+    if (stage == nullptr) {
+        return 1;
+    }
+    // never request more items than can be staged
+    return MAX(MIN(MISSION_UPLOAD_WINDOW, MISSION_UPLOAD_STAGE_ITEMS - stage_count), 1);
+}
+
+/*
+  store staged items in the mission. The mission semaphore is only
+  held while an item is stored, which copies it into RAM, so the main
+  thread is never blocked for longer than that. The staging semaphore
+  is held with it so an item discarded by a restarted or abandoned
+  upload is never stored
+ */
+void MissionItemProtocol_Waypoints::io_timer()
+{
+    while (true) {
+        WITH_SEMAPHORE(mission.get_semaphore());
+        WITH_SEMAPHORE(stage_sem);
+
+        if (stage_count == 0) {
+            return;
+        }
+        const AP_Mission::Mission_Command &cmd = stage[stage_head];
+        bool ok;
+        if (cmd.index < mission.num_commands()) {
+            ok = mission.replace_cmd(cmd.index, cmd);
+        } else {
+            ok = mission.add_cmd(cmd);
+        }
+        if (!ok && mission.storage_busy()) {
+            // file storage is making room for the item, retry on
+            // the next call
+            return;
+        }
+        if (!ok) {
+            stage_failed = true;
+        }
+        stage_head = (stage_head + 1) % MISSION_UPLOAD_STAGE_ITEMS;
+        stage_count--;
+    }
+}
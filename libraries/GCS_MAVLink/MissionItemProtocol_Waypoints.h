@@ -2,6 +2,18 @@
 
 #include "MissionItemProtocol.h"
 
+#include <AP_Mission/AP_Mission.h>
+
+// received items are staged in RAM and stored by the IO thread
+#ifndef MISSION_UPLOAD_STAGE_ITEMS
+#define MISSION_UPLOAD_STAGE_ITEMS 32
+#endif
+
+// maximum number of item requests outstanding during an upload
+#ifndef MISSION_UPLOAD_WINDOW
+#define MISSION_UPLOAD_WINDOW 16
+#endif
+
 class MissionItemProtocol_Waypoints : public MissionItemProtocol {
 public:
     MissionItemProtocol_Waypoints(class AP_Mission &_mission) :
@@ -64,5 +76,28 @@ private:
     // replace_item() replaces an item in the stored list
     MAV_MISSION_RESULT replace_item(const mavlink_mission_item_int_t &) override WARN_IF_UNUSED;
 
+    // stage_item() checks an item and queues it to be stored by the
+    // IO thread, or stores it immediately if there is no staging
+    // buffer
+    MAV_MISSION_RESULT stage_item(const mavlink_mission_item_int_t &mission_item_int);
+
+    MAV_MISSION_RESULT allocate_receive_resources(const uint16_t count) override WARN_IF_UNUSED;
+    MAV_MISSION_RESULT allocate_update_resources() override WARN_IF_UNUSED;
+    void free_upload_resources() override;
+
+    uint16_t max_outstanding_requests() const override;
+    bool items_pending() const override { return stage_count != 0; }
+    bool item_busy() const override { return mission.storage_busy(); }
+
+    // store staged items, called on the IO thread
+    void io_timer();
+
+    // ring of items received but not yet stored
+    AP_Mission::Mission_Command *stage;
+    uint8_t stage_head;
+    uint8_t stage_count;
+    bool stage_failed;    // storing a staged item failed
+    bool io_registered;
+    mutable HAL_Semaphore stage_sem;
 };
 
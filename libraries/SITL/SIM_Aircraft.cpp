@@ -441,7 +441,27 @@ void Aircraft::update_model(const struct sitl_input &input)
         loc.alt = sitl->opos.alt.get() * 1.0e2;
         set_start_location(loc, sitl->opos.hdg.get());
     }
-    update(input);
+
+    const uint8_t substeps = (use_substeps && sitl != nullptr) ? constrain_int16(sitl->phys_substeps, 1, 16) : 1;
+    if (substeps <= 1) {
+        update(input);
+        return;
+    }
+
+    // run the physics at a multiple of the frame rate. Only the last
+    // step is synchronised with the wall clock
+    const uint64_t full_frame_time_us = frame_time_us;
+    const bool time_sync = use_time_sync;
+    frame_time_us = full_frame_time_us / substeps;
+    use_time_sync = false;
+    for (uint8_t i=0; i<substeps; i++) {
+        if (i == substeps-1) {
+            frame_time_us = full_frame_time_us - frame_time_us * (substeps-1);
+            use_time_sync = time_sync;
+        }
+        update(input);
+    }
+    frame_time_us = full_frame_time_us;
 }
 
 /*
@@ -450,8 +470,10 @@ void Aircraft::update_model(const struct sitl_input &input)
 void Aircraft::update_dynamics(const Vector3f &rot_accel)
 {
     const float delta_time = frame_time_us * 1.0e-6f;
+    const bool trapezoidal = sitl != nullptr && sitl->phys_integrator == SITL::PHYS_INTEGRATOR_TRAPEZOIDAL;
 
     // update rotational rates in body frame
+    const Vector3f gyro_start = gyro;
     gyro += rot_accel * delta_time;
 
     gyro.x = constrain_float(gyro.x, -radians(2000.0f), radians(2000.0f));
@@ -463,8 +485,13 @@ void Aircraft::update_dynamics(const Vector3f &rot_accel)
     ang_accel = (gyro - gyro_prev) / delta_time;
     gyro_prev = gyro;
 
-    // update attitude
-    dcm.rotate(gyro * delta_time);
+    // update attitude. With the trapezoidal scheme the rotation uses
+    // the mean rate over the step
+    if (trapezoidal) {
+        dcm.rotate((gyro_start + gyro) * (0.5f * delta_time));
+    } else {
+        dcm.rotate(gyro * delta_time);
+    }
     dcm.normalize();
 
     Vector3f accel_earth = dcm * accel_body;
@@ -481,11 +508,17 @@ void Aircraft::update_dynamics(const Vector3f &rot_accel)
     accel_body = dcm.transposed() * (accel_earth + Vector3f(0.0f, 0.0f, -GRAVITY_MSS));
 
     // new velocity vector
+    const Vector3f velocity_start = velocity_ef;
     velocity_ef += accel_earth * delta_time;
 
     const bool was_on_ground = on_ground();
-    // new position vector
-    position += velocity_ef * delta_time;
+    // new position vector. The trapezoidal scheme is exact for
+    // constant acceleration over the step
+    if (trapezoidal) {
+        position += (velocity_start + velocity_ef) * (0.5f * delta_time);
+    } else {
+        position += velocity_ef * delta_time;
+    }
 
     // velocity relative to air mass, in earth frame
     velocity_air_ef = velocity_ef + wind_ef;
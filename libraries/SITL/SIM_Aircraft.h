@@ -198,6 +198,9 @@ protected:
     const char *autotest_dir;
     const char *frame;
     bool use_time_sync = true;
+    // true if update() may be called several times per frame with a
+    // shorter frame time, see SIM_PHYS_SUBSTEP
+    bool use_substeps = false;
     float last_speedup = -1.0f;
     const char *config_ = "";
 
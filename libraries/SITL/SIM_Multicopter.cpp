@@ -44,6 +44,7 @@ MultiCopter::MultiCopter(const char *frame_str) :
     frame_height = 0.1;
     num_motors = frame->num_motors;
     ground_behavior = GROUND_BEHAVIOR_NO_MOVEMENT;
+    use_substeps = true;
 }
 
 // calculate rotational and linear accelerations
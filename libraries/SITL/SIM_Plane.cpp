@@ -37,6 +37,7 @@ Plane::Plane(const char *frame_str) :
     num_motors = 1;
 
     ground_behavior = GROUND_BEHAVIOR_FWD_ONLY;
+    use_substeps = true;
     
     if (strstr(frame_str, "-heavy")) {
         mass = 8;
@@ -59,6 +59,18 @@ SerialDevice::SerialDevice()
 
 }
 
+void SerialDevice::use_buffers()
+{
+    if (to_autopilot != nullptr) {
+        return;
+    }
+    to_autopilot = new ByteBuffer(8192);
+    from_autopilot = new ByteBuffer(8192);
+    if (to_autopilot == nullptr || from_autopilot == nullptr) {
+        AP_HAL::panic("SerialDevice buffer allocation failed");
+    }
+}
+
 bool SerialDevice::init_sitl_pointer()
 {
     if (_sitl == nullptr) {
@@ -73,6 +85,9 @@ bool SerialDevice::init_sitl_pointer()
 
 ssize_t SerialDevice::read_from_autopilot(char *buffer, const size_t size)
 {
+    if (from_autopilot != nullptr) {
+        return from_autopilot->read((uint8_t *)buffer, size);
+    }
     const ssize_t ret = ::read(read_fd_my_end, buffer, size);
     // if (ret > 0) {
     //     ::fprintf(stderr, "SIM_SerialDevice: read from autopilot: (");
@@ -90,6 +105,9 @@ ssize_t SerialDevice::read_from_autopilot(char *buffer, const size_t size)
 
 ssize_t SerialDevice::write_to_autopilot(const char *buffer, const size_t size)
 {
+    if (to_autopilot != nullptr) {
+        return to_autopilot->write((const uint8_t *)buffer, size);
+    }
     const ssize_t ret = write(fd_my_end, buffer, size);
     // ::fprintf(stderr, "write to autopilot: (");
     // for (ssize_t i=0; i<ret; i++) {
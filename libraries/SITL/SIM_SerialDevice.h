@@ -35,6 +35,17 @@ public:
     // return fd on which data to the device can be written
     int write_fd() { return read_fd_their_end; }
 
+    // switch to in-process buffers instead of the pipes.  Must be
+    // called before the device is first updated
+    void use_buffers();
+
+    // buffer from which data from the device can be read, nullptr if
+    // the device is using pipes
+    ByteBuffer *to_autopilot_buffer() { return to_autopilot; }
+    // buffer to which data to the device can be written, nullptr if
+    // the device is using pipes
+    ByteBuffer *from_autopilot_buffer() { return from_autopilot; }
+
     ssize_t read_from_autopilot(char *buffer, size_t size);
     ssize_t write_to_autopilot(const char *buffer, size_t size);
 
@@ -48,6 +59,11 @@ protected:
     int read_fd_their_end;
     int read_fd_my_end;
 
+    // single-producer single-consumer buffers used instead of the
+    // pipes, avoiding a syscall per read and write
+    ByteBuffer *to_autopilot = nullptr;
+    ByteBuffer *from_autopilot = nullptr;
+
     bool init_sitl_pointer();
 };
 
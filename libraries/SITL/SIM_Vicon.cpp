@@ -73,7 +73,7 @@ void Vicon::update_vicon_position_estimate(const Location &loc,
         uint8_t msgbuf[300];
         uint16_t msgbuf_len = mavlink_msg_to_send_buffer(msgbuf, &obs_msg);
 
-        if (::write(fd_my_end, (void*)&msgbuf, msgbuf_len) != msgbuf_len) {
+        if (write_to_autopilot((char*)msgbuf, msgbuf_len) != msgbuf_len) {
             ::fprintf(stderr, "Vicon: write failure\n");
         }
         time_send_us = 0;
@@ -228,6 +228,13 @@ const AP_Param::GroupInfo SITL::var_info3[] = {
     AP_GROUPINFO("MAG7_DEVID",    9, SITL,  mag_devid[6], 0),
     AP_GROUPINFO("MAG8_DEVID",    10, SITL,  mag_devid[7], 0),
 
+    // integration scheme for rigid body state, 0:Euler, 1:Trapezoidal.
+    // Euler by default so existing simulations are unchanged
+    AP_GROUPINFO("PHYS_INTEG",    11, SITL,  phys_integrator, SITL::PHYS_INTEGRATOR_EULER),
+    // number of physics steps per simulation frame, allowing the
+    // physics to run faster than the sensors for stiff models
+    AP_GROUPINFO("PHYS_SUBSTEP",  12, SITL,  phys_substeps, 1),
+
     AP_GROUPEND
 
 };
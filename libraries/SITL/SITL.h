@@ -187,6 +187,14 @@ public:
     AP_Float mag_scaling; // scaling factor on first compasses
     AP_Int32 mag_devid[MAX_CONNECTED_MAGS]; // Mag devid
 
+    // rigid body integration scheme
+    enum PhysIntegrator {
+        PHYS_INTEGRATOR_EULER = 0,
+        PHYS_INTEGRATOR_TRAPEZOIDAL = 1,
+    };
+    AP_Int8  phys_integrator; // integration scheme for rigid body state
+    AP_Int8  phys_substeps; // physics steps per simulation frame
+
     // EFI type
     enum EFIType {
         EFI_TYPE_NONE = 0,
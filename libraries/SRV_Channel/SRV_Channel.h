@@ -527,6 +527,9 @@ private:
 
     SRV_Channel obj_channels[NUM_SERVO_CHANNELS];
 
+    // index of functions to channels, rebuilt by
+    // update_aux_servo_function() so output by function does not need
+    // to search all channels
     static struct srv_function {
         // mask of what channels this applies to
         SRV_Channel::servo_mask_t channel_mask;
@@ -543,5 +546,16 @@ private:
         return disabled_passthrough;
     }
 
+    // mask of channels assigned to a function
+    static SRV_Channel::servo_mask_t function_channels(SRV_Channel::Aux_servo_function_t function);
+
+    // return the lowest channel in a mask and remove it from the
+    // mask. Used to walk the channels of a function
+    static uint8_t next_channel(SRV_Channel::servo_mask_t &mask) {
+        const uint8_t chan = __builtin_ctz(mask);
+        mask &= mask - 1;
+        return chan;
+    }
+
     static bool emergency_stop;
 };
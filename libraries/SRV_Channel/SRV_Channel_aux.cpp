@@ -140,7 +140,10 @@ void SRV_Channel::aux_servo_function_setup(void)
     }
 }
 
-/// setup the output range types of all functions
+/*
+  setup the output range types of all functions, and rebuild the
+  function to channel index used for output by function
+ */
 void SRV_Channels::update_aux_servo_function(void)
 {
     if (!channels) {
@@ -224,11 +227,11 @@ void SRV_Channels::set_output_pwm(SRV_Channel::Aux_servo_function_t function, ui
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            channels[i].set_output_pwm(value);
-            channels[i].output_ch();
-        }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.set_output_pwm(value);
+        c.output_ch();
     }
 }
 
@@ -243,17 +246,17 @@ SRV_Channels::set_output_pwm_trimmed(SRV_Channel::Aux_servo_function_t function,
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            int16_t value2;
-            if (channels[i].get_reversed()) {
-                value2 = 1500 - value + channels[i].get_trim();
-            } else {
-                value2 = value - 1500 + channels[i].get_trim();
-            }
-            channels[i].set_output_pwm(constrain_int16(value2,channels[i].get_output_min(),channels[i].get_output_max()));
-            channels[i].output_ch();
-          }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        int16_t value2;
+        if (c.get_reversed()) {
+            value2 = 1500 - value + c.get_trim();
+        } else {
+            value2 = value - 1500 + c.get_trim();
+        }
+        c.set_output_pwm(constrain_int16(value2,c.get_output_min(),c.get_output_max()));
+        c.output_ch();
     }
 }
 
@@ -267,10 +270,10 @@ SRV_Channels::set_trim_to_servo_out_for(SRV_Channel::Aux_servo_function_t functi
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            channels[i].servo_trim.set_and_save_ifchanged(channels[i].output_pwm);
-        }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.servo_trim.set_and_save_ifchanged(c.output_pwm);
     }
 }
 
@@ -283,16 +286,16 @@ SRV_Channels::copy_radio_in_out(SRV_Channel::Aux_servo_function_t function, bool
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            RC_Channel *c = rc().channel(channels[i].ch_num);
-            if (c == nullptr) {
-                continue;
-            }
-            channels[i].set_output_pwm(c->get_radio_in());
-            if (do_input_output) {
-                channels[i].output_ch();
-            }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        SRV_Channel &srv = channels[next_channel(mask)];
+        RC_Channel *c = rc().channel(srv.ch_num);
+        if (c == nullptr) {
+            continue;
+        }
+        srv.set_output_pwm(c->get_radio_in());
+        if (do_input_output) {
+            srv.output_ch();
         }
     }
 }
@@ -324,11 +327,10 @@ SRV_Channels::set_failsafe_pwm(SRV_Channel::Aux_servo_function_t function, uint1
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        const SRV_Channel &c = channels[i];
-        if (c.function.get() == function) {
-            hal.rcout->set_failsafe_pwm(1U<<c.ch_num, pwm);
-        }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        const SRV_Channel &c = channels[next_channel(mask)];
+        hal.rcout->set_failsafe_pwm(1U<<c.ch_num, pwm);
     }
 }
 
@@ -341,12 +343,11 @@ SRV_Channels::set_failsafe_limit(SRV_Channel::Aux_servo_function_t function, SRV
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        const SRV_Channel &c = channels[i];
-        if (c.function.get() == function) {
-            uint16_t pwm = c.get_limit_pwm(limit);
-            hal.rcout->set_failsafe_pwm(1U<<c.ch_num, pwm);
-        }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        const SRV_Channel &c = channels[next_channel(mask)];
+        uint16_t pwm = c.get_limit_pwm(limit);
+        hal.rcout->set_failsafe_pwm(1U<<c.ch_num, pwm);
     }
 }
 
@@ -359,12 +360,11 @@ SRV_Channels::set_safety_limit(SRV_Channel::Aux_servo_function_t function, SRV_C
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        const SRV_Channel &c = channels[i];
-        if (c.function.get() == function) {
-            uint16_t pwm = c.get_limit_pwm(limit);
-            hal.rcout->set_safety_pwm(1U<<c.ch_num, pwm);
-        }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        const SRV_Channel &c = channels[next_channel(mask)];
+        uint16_t pwm = c.get_limit_pwm(limit);
+        hal.rcout->set_safety_pwm(1U<<c.ch_num, pwm);
     }
 }
 
@@ -377,18 +377,17 @@ SRV_Channels::set_output_limit(SRV_Channel::Aux_servo_function_t function, SRV_C
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function.get() == function) {
-            uint16_t pwm = c.get_limit_pwm(limit);
-            c.set_output_pwm(pwm);
-            if (c.function.get() == SRV_Channel::k_manual) {
-                RC_Channel *cin = rc().channel(c.ch_num);
-                if (cin != nullptr) {
-                    // in order for output_ch() to work for k_manual we
-                    // also have to override radio_in
-                    cin->set_radio_in(pwm);
-                }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        uint16_t pwm = c.get_limit_pwm(limit);
+        c.set_output_pwm(pwm);
+        if (function == SRV_Channel::k_manual) {
+            RC_Channel *cin = rc().channel(c.ch_num);
+            if (cin != nullptr) {
+                // in order for output_ch() to work for k_manual we
+                // also have to override radio_in
+                cin->set_radio_in(pwm);
             }
         }
     }
@@ -419,13 +418,12 @@ SRV_Channels::move_servo(SRV_Channel::Aux_servo_function_t function,
     }
     float v = float(value - angle_min) / float(angle_max - angle_min);
     v = constrain_float(v, 0.0f, 1.0f);
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function.get() == function) {
-            float v2 = c.get_reversed()? (1-v) : v;
-            uint16_t pwm = c.servo_min + v2 * (c.servo_max - c.servo_min);
-            c.set_output_pwm(pwm);
-        }
+    SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        float v2 = c.get_reversed()? (1-v) : v;
+        uint16_t pwm = c.servo_min + v2 * (c.servo_max - c.servo_min);
+        c.set_output_pwm(pwm);
     }
 }
 
@@ -454,6 +452,7 @@ bool SRV_Channels::set_aux_channel_default(SRV_Channel::Aux_servo_function_t fun
     channels[channel].function.set(function);
     channels[channel].aux_servo_function_setup();
     function_mask.set((uint8_t)function);
+    functions[SRV_Channel::k_none].channel_mask &= ~(1U<<channel);
     functions[function].channel_mask |= 1U<<channel;
     return true;
 }
@@ -467,13 +466,12 @@ bool SRV_Channels::find_channel(SRV_Channel::Aux_servo_function_t function, uint
     if (!function_assigned(function)) {
         return false;
     }
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            chan = channels[i].ch_num;
-            return true;
-        }
+    const SRV_Channel::servo_mask_t mask = functions[function].channel_mask;
+    if (mask == 0) {
+        return false;
     }
-    return false;
+    chan = channels[__builtin_ctz(mask)].ch_num;
+    return true;
 }
 
 /*
@@ -511,6 +509,15 @@ int16_t SRV_Channels::get_output_scaled(SRV_Channel::Aux_servo_function_t functi
   get mask of output channels for a function
  */
 uint16_t SRV_Channels::get_output_channel_mask(SRV_Channel::Aux_servo_function_t function)
+{
+    return function_channels(function);
+}
+
+/*
+  get mask of channels assigned to a function from the function index,
+  building the index if needed
+ */
+SRV_Channel::servo_mask_t SRV_Channels::function_channels(SRV_Channel::Aux_servo_function_t function)
 {
     if (!initialised) {
         update_aux_servo_function();
@@ -525,20 +532,20 @@ uint16_t SRV_Channels::get_output_channel_mask(SRV_Channel::Aux_servo_function_t
 // set the trim for a function channel to given pwm
 void SRV_Channels::set_trim_to_pwm_for(SRV_Channel::Aux_servo_function_t function, int16_t pwm)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].servo_trim.set(pwm);
-        }
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.servo_trim.set(pwm);
     }
 }
 
 // set the trim for a function channel to min output
 void SRV_Channels::set_trim_to_min_for(SRV_Channel::Aux_servo_function_t function)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].servo_trim.set(channels[i].get_reversed()?channels[i].servo_max:channels[i].servo_min);
-        }
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.servo_trim.set(c.get_reversed()?c.servo_max:c.servo_min);
     }
 }
 
@@ -552,6 +559,10 @@ void SRV_Channels::set_default_function(uint8_t chan, SRV_Channel::Aux_servo_fun
         channels[chan].function.set_default((uint8_t)function);
         if (old != channels[chan].function && channels[chan].function == function) {
             function_mask.set((uint8_t)function);
+            if ((uint8_t)old < SRV_Channel::k_nr_aux_servo_functions) {
+                functions[old].channel_mask &= ~(1U<<chan);
+            }
+            functions[function].channel_mask |= 1U<<chan;
         }
     }
 }
@@ -573,11 +584,10 @@ void SRV_Channels::adjust_trim(SRV_Channel::Aux_servo_function_t function, float
     if (is_zero(v)) {
         return;
     }
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        const uint8_t i = next_channel(mask);
         SRV_Channel &c = channels[i];
-        if (function != (SRV_Channel::Aux_servo_function_t)(c.function.get())) {
-            continue;
-        }
         float change = c.reversed?-v:v;
         uint16_t new_trim = c.servo_trim;
         float trim_scaled = float(c.servo_trim - c.servo_min) / (c.servo_max - c.servo_min);
@@ -609,21 +619,19 @@ bool SRV_Channels::get_output_pwm(SRV_Channel::Aux_servo_function_t function, ui
 // set output pwm to trim for the given function
 void SRV_Channels::set_output_to_trim(SRV_Channel::Aux_servo_function_t function)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].set_output_pwm(channels[i].servo_trim);
-        }
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.set_output_pwm(c.servo_trim);
     }
 }
 
 // set output pwm to for first matching channel
 void SRV_Channels::set_output_pwm_first(SRV_Channel::Aux_servo_function_t function, uint16_t pwm)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].set_output_pwm(pwm);
-            break;
-        }
+    const SRV_Channel::servo_mask_t mask = function_channels(function);
+    if (mask != 0) {
+        channels[__builtin_ctz(mask)].set_output_pwm(pwm);
     }
 }
 
@@ -651,65 +659,63 @@ void SRV_Channels::limit_slew_rate(SRV_Channel::Aux_servo_function_t function, f
         // nothing to do
         return;
     }
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function == function) {
-            c.calc_pwm(functions[function].output_scaled);
-            uint16_t last_pwm = hal.rcout->read_last_sent(c.ch_num);
-            if (last_pwm == c.output_pwm) {
-                continue;
-            }
-            uint16_t max_change = (c.get_output_max() - c.get_output_min()) * slew_rate * dt * 0.01f;
-            if (max_change == 0 || dt > 1) {
-                // always allow some change. If dt > 1 then assume we
-                // are just starting out, and only allow a small
-                // change for this loop
-                max_change = 1;
-            }
-            c.output_pwm = constrain_int16(c.output_pwm, last_pwm-max_change, last_pwm+max_change);
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.calc_pwm(functions[function].output_scaled);
+        uint16_t last_pwm = hal.rcout->read_last_sent(c.ch_num);
+        if (last_pwm == c.output_pwm) {
+            continue;
+        }
+        uint16_t max_change = (c.get_output_max() - c.get_output_min()) * slew_rate * dt * 0.01f;
+        if (max_change == 0 || dt > 1) {
+            // always allow some change. If dt > 1 then assume we
+            // are just starting out, and only allow a small
+            // change for this loop
+            max_change = 1;
         }
+        c.output_pwm = constrain_int16(c.output_pwm, last_pwm-max_change, last_pwm+max_change);
     }
 }
 
 // call set_angle() on matching channels
 void SRV_Channels::set_angle(SRV_Channel::Aux_servo_function_t function, uint16_t angle)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].set_angle(angle);
-        }
-    }    
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.set_angle(angle);
+    }
 }
 
 // call set_range() on matching channels
 void SRV_Channels::set_range(SRV_Channel::Aux_servo_function_t function, uint16_t range)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].set_range(range);
-        }
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.set_range(range);
     }
 }
 
 // set MIN parameter for a function
 void SRV_Channels::set_output_min_max(SRV_Channel::Aux_servo_function_t function, uint16_t min_pwm, uint16_t max_pwm)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].set_output_min(min_pwm);
-            channels[i].set_output_max(max_pwm);
-        }
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.set_output_min(min_pwm);
+        c.set_output_max(max_pwm);
     }
 }
 
 // constrain to output min/max for function
 void SRV_Channels::constrain_pwm(SRV_Channel::Aux_servo_function_t function)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function == function) {
-            c.output_pwm = constrain_int16(c.output_pwm, c.servo_min, c.servo_max);
-        }
+    SRV_Channel::servo_mask_t mask = function_channels(function);
+    while (mask) {
+        SRV_Channel &c = channels[next_channel(mask)];
+        c.output_pwm = constrain_int16(c.output_pwm, c.servo_min, c.servo_max);
     }
 }
 
@@ -730,13 +736,9 @@ void SRV_Channels::upgrade_parameters(void)
 // set RC output frequency on a function output
 void SRV_Channels::set_rc_frequency(SRV_Channel::Aux_servo_function_t function, uint16_t frequency_hz)
 {
-    uint16_t mask = 0;
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function == function) {
-            mask |= (1U<<c.ch_num);
-        }
-    }
+    // channel numbers are the channel indexes, so the function's
+    // channel mask is the output mask
+    const uint16_t mask = function_channels(function);
     if (mask != 0) {
         hal.rcout->set_freq(mask, frequency_hz);
     }
@@ -0,0 +1,85 @@
+//
+// Benchmark of a quadplane style output cycle through SRV_Channels.
+// Surfaces are set by scaled value, quad motors by pwm, and then the
+// outputs are calculated and pushed, as in Plane::set_servos()
+//
+
+#include <AP_HAL/AP_HAL.h>
+#include <SRV_Channel/SRV_Channel.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+void setup(void);
+void loop(void);
+
+static SRV_Channels srvs;
+
+static const SRV_Channel::Aux_servo_function_t layout[] = {
+    SRV_Channel::k_aileron,
+    SRV_Channel::k_elevator,
+    SRV_Channel::k_throttle,
+    SRV_Channel::k_rudder,
+    SRV_Channel::k_motor1,
+    SRV_Channel::k_motor2,
+    SRV_Channel::k_motor3,
+    SRV_Channel::k_motor4,
+    SRV_Channel::k_flap_auto,
+    SRV_Channel::k_aileron,
+    SRV_Channel::k_motor_tilt,
+    SRV_Channel::k_motor_tilt,
+};
+
+// one output cycle of a tiltrotor quadplane in transition
+static void output_cycle(uint16_t i)
+{
+    const int16_t v = int16_t(i % 9000) - 4500;
+
+    SRV_Channels::set_output_scaled(SRV_Channel::k_aileron, v);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_elevator, -v);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_rudder, v/2);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_throttle, 50);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_flap_auto, 0);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_motor_tilt, 500);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_aileron_with_input, v);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_elevon_left, 0);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_elevon_right, 0);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_vtail_left, 0);
+    SRV_Channels::set_output_scaled(SRV_Channel::k_vtail_right, 0);
+
+    for (uint8_t m = 0; m < 4; m++) {
+        SRV_Channels::set_output_pwm(SRV_Channels::get_motor_function(m), 1500 + v/20);
+    }
+
+    SRV_Channels::limit_slew_rate(SRV_Channel::k_throttle, 100, 0.0025f);
+    SRV_Channels::calc_pwm();
+    SRV_Channels::cork();
+    SRV_Channels::output_ch_all();
+    SRV_Channels::push();
+}
+
+void setup(void)
+{
+    hal.console->printf("SRV_Channels output benchmark\n");
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(layout); i++) {
+        SRV_Channels::set_default_function(i, layout[i]);
+    }
+    SRV_Channels::enable_aux_servos();
+}
+
+void loop(void)
+{
+    const uint16_t iterations = 20000;
+
+    const uint32_t start_us = AP_HAL::micros();
+    for (uint16_t i = 0; i < iterations; i++) {
+        output_cycle(i);
+    }
+    const uint32_t dt_us = AP_HAL::micros() - start_us;
+
+    hal.console->printf("%u output cycles: %.3f us per cycle\n",
+                        (unsigned)iterations, (double)(dt_us / float(iterations)));
+    hal.scheduler->delay(2000);
+}
+
+AP_HAL_MAIN();